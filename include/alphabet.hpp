@@ -0,0 +1,52 @@
+#ifndef MSV_FILTER_ALPHABET_H
+#define MSV_FILTER_ALPHABET_H
+#include <string>
+#include <vector>
+#include "hmmer_types.hpp"
+
+// Alphabet type tags (ESL_ALPHABET::type)
+const int eslNONSTANDARD = 0;   // Type tag (generic)
+const int eslRNA = 1;           // Ribonucleotides
+const int eslDNA = 2;           // Deoxyribonucleotides
+
+// Common layout of a digital alphabet (ESL_ALPHABET). Concrete alphabets fill
+// these tables in their constructors; profiles and kernels only see this base.
+struct DigitalAlphabet {
+  // 1. Core Dimensions
+  int K;  // Canonical size
+  int Kp; // Total size, including gap, degeneracies, nonresidue, missing
+  int type;
+
+  // 2. Data Structures
+  std::string sym;             // The symbol string
+  std::vector<int> inmap;      // Maps ASCII (0-127) -> Digital Index
+  std::vector<int> ndegen;     // How many residues does this char represent?
+  std::vector<uint8_t> degen;  // The degeneracy matrix (Flattened 2D: Kp rows * K cols)
+
+  void set_degen(int row, int col, uint8_t val) {
+    degen[(row * K) + col] = val;
+  }
+
+  uint8_t get_degen(int row, int col) const {
+    return degen[(row * K) + col];
+  }
+
+  // Fill all tables from a compile-time description (see alphabet_traits.hpp)
+  template<class Traits>
+  void load_tables() {
+    K = Traits::K;
+    Kp = Traits::Kp;
+    type = Traits::type;
+    sym.assign(Traits::sym, Traits::Kp);
+    inmap.assign(Traits::inmap.begin(), Traits::inmap.end());
+    ndegen.assign(Traits::ndegen.begin(), Traits::ndegen.end());
+    degen.assign(Traits::degen.begin(), Traits::degen.end());
+  }
+
+  // Index of the "any residue" symbol (X for amino, N for nucleic)
+  int any_index() const {
+    return Kp - 3;
+  }
+};
+
+#endif //MSV_FILTER_ALPHABET_H
@@ -0,0 +1,139 @@
+/*******************************************************************************
+ * File: include/alphabet_traits.hpp
+ * Description: Compile-time alphabet descriptions.
+ *
+ * The runtime alphabets (AminoAcidAlphabet, NucleotideAlphabet) keep their
+ * tables in heap vectors and expose K/Kp as plain ints, so a kernel that goes
+ * through profile.abc pays a pointer chase and cannot size anything
+ * statically. The traits below carry the same tables as constexpr arrays and
+ * K/Kp as constants. Kernels templated on a traits type get fixed-size score
+ * tables and constant residue bounds; the runtime alphabets are filled from
+ * these tables so the two cannot drift apart.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_ALPHABET_TRAITS_HPP
+#define MSV_FILTER_ALPHABET_TRAITS_HPP
+
+#include <array>
+#include <cstdint>
+#include "hmmer_types.hpp"
+#include "alphabet.hpp"
+
+namespace alphabet_detail {
+
+// ASCII -> digital code; unmapped symbols are digitalResidueIllegal
+template<int Kp>
+constexpr std::array<DigitalResidue, 128> make_inmap(const char (&sym)[Kp + 1], bool case_insensitive) {
+    std::array<DigitalResidue, 128> inmap{};
+    for (int c = 0; c < 128; c++) {
+        inmap[c] = digitalResidueIllegal;
+    }
+    for (int x = 0; x < Kp; x++) {
+        const int c = sym[x];
+        inmap[c] = static_cast<DigitalResidue>(x);
+        if (case_insensitive && c >= 'A' && c <= 'Z') {
+            inmap[c - 'A' + 'a'] = static_cast<DigitalResidue>(x);
+        }
+    }
+    return inmap;
+}
+
+// Index of a symbol in the symbol string (-1 if absent)
+template<int Kp>
+constexpr int symbol_index(const char (&sym)[Kp + 1], char c) {
+    for (int x = 0; x < Kp; x++) {
+        if (sym[x] == c) {
+            return x;
+        }
+    }
+    return -1;
+}
+
+}  // namespace alphabet_detail
+
+/*******************************************************************************
+ * AminoTraits
+ *
+ * Mirrors the custom amino alphabet: "ACDEFGHIKLMNPQRSTVWY-BJZOUX*~", K=20,
+ * Kp=29. Canonical residues map to themselves and X (Kp-3) to all 20; the
+ * other degenerate symbols are left empty, exactly as the runtime alphabet.
+ ******************************************************************************/
+
+struct AminoTraits {
+    static constexpr int K = 20;
+    static constexpr int Kp = 29;
+    static constexpr int type = eslNONSTANDARD;
+    static constexpr char sym[Kp + 1] = "ACDEFGHIKLMNPQRSTVWY-BJZOUX*~";
+
+    static constexpr std::array<DigitalResidue, 128> inmap = alphabet_detail::make_inmap<Kp>(sym, false);
+
+    static constexpr std::array<uint8_t, Kp * K> degen = []() {
+        std::array<uint8_t, Kp * K> d{};
+        for (int x = 0; x < K; x++) {
+            d[(x * K) + x] = 1;
+        }
+        for (int y = 0; y < K; y++) {
+            d[((Kp - 3) * K) + y] = 1;
+        }
+        return d;
+    }();
+
+    static constexpr std::array<int, Kp> ndegen = []() {
+        std::array<int, Kp> n{};
+        for (int x = 0; x < Kp; x++) {
+            for (int y = 0; y < K; y++) {
+                n[x] += degen[(x * K) + y];
+            }
+        }
+        return n;
+    }();
+};
+
+/*******************************************************************************
+ * NucleotideTraits
+ *
+ * Easel DNA order "ACGT-RYMKSWHBVDN*~", K=4, Kp=18, with IUPAC degeneracy.
+ * Input is case-insensitive and U is read as T.
+ ******************************************************************************/
+
+struct NucleotideTraits {
+    static constexpr int K = 4;
+    static constexpr int Kp = 18;
+    static constexpr int type = eslDNA;
+    static constexpr char sym[Kp + 1] = "ACGT-RYMKSWHBVDN*~";
+
+    static constexpr std::array<DigitalResidue, 128> inmap = []() {
+        std::array<DigitalResidue, 128> m = alphabet_detail::make_inmap<Kp>(sym, true);
+        m['U'] = m['u'] = 3;
+        return m;
+    }();
+
+    static constexpr std::array<uint8_t, Kp * K> degen = []() {
+        // Each IUPAC code followed by the bases it stands for
+        constexpr const char* codes[] = {"RAG", "YCT", "MAC", "KGT", "SCG", "WAT",
+                                         "HACT", "BCGT", "VACG", "DAGT", "NACGT"};
+        std::array<uint8_t, Kp * K> d{};
+        for (int x = 0; x < K; x++) {
+            d[(x * K) + x] = 1;
+        }
+        for (const char* code : codes) {
+            const int row = alphabet_detail::symbol_index<Kp>(sym, code[0]);
+            for (const char* b = code + 1; *b != '\0'; b++) {
+                d[(row * K) + alphabet_detail::symbol_index<Kp>(sym, *b)] = 1;
+            }
+        }
+        return d;
+    }();
+
+    static constexpr std::array<int, Kp> ndegen = []() {
+        std::array<int, Kp> n{};
+        for (int x = 0; x < Kp; x++) {
+            for (int y = 0; y < K; y++) {
+                n[x] += degen[(x * K) + y];
+            }
+        }
+        return n;
+    }();
+};
+
+#endif // MSV_FILTER_ALPHABET_TRAITS_HPP
@@ -0,0 +1,148 @@
+/*******************************************************************************
+ * File: include/banded_dp.hpp
+ * Description: Sparse DP storage for banded gapped scoring around MSV seeds.
+ *
+ * BandedDPMatrix stores only the cells inside a DPBand: row i keeps the
+ * M/I/D triples for k = kmin[i]..kmax[i] back to back in one flat array,
+ * plus the five special states for every row. It has the DPMatrix accessor
+ * names; writes must stay inside the band, and const reads outside it see
+ * -infinity, so a traceback can probe neighbours freely.
+ *
+ * seed_band() builds the band from MSV segments (msv_segments.hpp): for
+ * each seed diagonal d = i - k, every row the diagonal crosses gets
+ * columns [i - d - w, i - d + w]. A row holds one range, so rows crossed
+ * by several seeds keep the hull of theirs. One seed costs about
+ * (M + 2w)(2w + 1) cells instead of M x L, and so do seeds on nearby
+ * diagonals or on rows far apart. Seeds whose diagonals differ by D but
+ * that share rows widen each shared row to D + 2w + 1 columns, up to all
+ * of 1..M, so check cells() against M x L before relying on the band.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_BANDED_DP_HPP
+#define MSV_FILTER_BANDED_DP_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+#include "hmmer_types.hpp"
+#include "dp_band.hpp"
+#include "msv_segments.hpp"
+
+class BandedDPMatrix {
+public:
+    BandedDPMatrix() = default;
+
+    explicit BandedDPMatrix(const DPBand& band) {
+        reshape(band);
+    }
+
+    // Lay out storage for `band`, reusing allocated capacity; every cell
+    // and special starts at -infinity
+    void reshape(const DPBand& band) {
+        band_ = band;
+        const int L = band.sequence_length;
+        row_offset_.resize(static_cast<size_t>(L) + 2);
+        size_t n = 0;
+        for (int i = 0; i <= L; i++) {
+            row_offset_[i] = n;
+            n += band.kmax[i] >= band.kmin[i] ? static_cast<size_t>(band.kmax[i] - band.kmin[i] + 1) : 0;
+        }
+        row_offset_[L + 1] = n;
+        cells_.assign(n * p7G_NSCELLS, -eslINFINITY);
+        xmx_.assign((static_cast<size_t>(L) + 1) * p7G_NXCELLS, -eslINFINITY);
+    }
+
+    const DPBand& band() const {
+        return band_;
+    }
+
+    int model_length() const {
+        return band_.model_length;
+    }
+
+    int sequence_length() const {
+        return band_.sequence_length;
+    }
+
+    // Stored cells (M x L for a full band)
+    uint64_t cells() const {
+        return row_offset_.empty() ? 0 : static_cast<uint64_t>(row_offset_.back());
+    }
+
+    // Bytes held by the cell and special arrays
+    size_t bytes() const {
+        return (cells_.size() + xmx_.size()) * sizeof(float);
+    }
+
+    // --- Accessors (DPMatrix names) ---
+
+    float& match(int i, int k) {
+        return cell(i, k, p7G_M);
+    }
+
+    float match(int i, int k) const {
+        return read(i, k, p7G_M);
+    }
+
+    float& insert(int i, int k) {
+        return cell(i, k, p7G_I);
+    }
+
+    float insert(int i, int k) const {
+        return read(i, k, p7G_I);
+    }
+
+    float& delete_state(int i, int k) {
+        return cell(i, k, p7G_D);
+    }
+
+    float delete_state(int i, int k) const {
+        return read(i, k, p7G_D);
+    }
+
+    float& special(int i, int s) {
+        return xmx_[(static_cast<size_t>(i) * p7G_NXCELLS) + s];
+    }
+
+    float special(int i, int s) const {
+        return xmx_[(static_cast<size_t>(i) * p7G_NXCELLS) + s];
+    }
+
+private:
+    size_t index(int i, int k, int s) const {
+        return ((row_offset_[i] + static_cast<size_t>(k - band_.kmin[i])) * p7G_NSCELLS) + s;
+    }
+
+    float& cell(int i, int k, int s) {
+        assert(band_.contains(i, k));
+        return cells_[index(i, k, s)];
+    }
+
+    float read(int i, int k, int s) const {
+        return band_.contains(i, k) ? cells_[index(i, k, s)] : -eslINFINITY;
+    }
+
+    DPBand band_;
+    std::vector<size_t> row_offset_;  // Rows 0..L+1, in cells
+    std::vector<float> cells_;        // p7G_NSCELLS floats per cell
+    std::vector<float> xmx_;          // p7G_NXCELLS floats per row
+};
+
+// Band of +/- w columns around every seed's diagonal, over all the rows
+// that diagonal crosses in an M x L matrix
+inline DPBand seed_band(const std::vector<MSVSegment>& seeds, int model_length, int sequence_length, int w) {
+    DPBand band(model_length, sequence_length);
+    w = std::max(0, w);
+    for (const MSVSegment& seed : seeds) {
+        const int d = seed.diagonal();
+        const int first = std::max(1, d + 1 - w);
+        const int last = std::min(sequence_length, d + model_length + w);
+        for (int i = first; i <= last; i++) {
+            band.include(i, i - d - w, i - d + w);
+        }
+    }
+    return band;
+}
+
+#endif // MSV_FILTER_BANDED_DP_HPP
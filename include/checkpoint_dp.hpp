@@ -0,0 +1,167 @@
+/*******************************************************************************
+ * File: include/checkpoint_dp.hpp
+ * Description: Checkpointed DP matrix for traceback in O(M sqrt(L)) memory.
+ *
+ * Follows the idea of HMMER's checkpointed P7_GMX: rows are grouped into
+ * blocks of B rows, and only the first row of each block (i = 0, B, 2B, ...)
+ * is kept for the whole run. The other B - 1 rows of a block share one
+ * scratch buffer, which holds the block last written or recomputed. The
+ * special states are kept for every row: five floats per residue is small
+ * next to the M x L core. B is the power of two nearest sqrt(L), so core
+ * storage is about M (L/B + B) cells instead of M x L; a titin-length
+ * sequence (L = 35k) against a 400-node model needs ~2.5 MB, not 170 MB.
+ *
+ * A traceback walks rows downwards and recomputes each block once from its
+ * checkpoint (viterbi.hpp: viterbi_traceback() on a CheckpointedDPMatrix),
+ * about doubling the fill cost. Accessors have the DPMatrix names; const
+ * reads must hit a checkpoint row or a row of the resident block.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_CHECKPOINT_DP_HPP
+#define MSV_FILTER_CHECKPOINT_DP_HPP
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "hmmer_types.hpp"
+
+class CheckpointedDPMatrix {
+public:
+    // `block_rows` > 0 fixes B (rounded up to a power of two); 0 picks it
+    // from sqrt(L) on every reshape()
+    explicit CheckpointedDPMatrix(int block_rows = 0) : requested_block_rows_(block_rows) {}
+
+    CheckpointedDPMatrix(int model_length, int sequence_length, int block_rows = 0)
+        : requested_block_rows_(block_rows) {
+        reshape(model_length, sequence_length);
+    }
+
+    // Lay out storage for M x L, reusing allocated capacity; every cell and
+    // special starts at -infinity
+    void reshape(int model_length, int sequence_length) {
+        M_ = model_length;
+        L_ = sequence_length;
+        const int target = requested_block_rows_ > 0
+                               ? requested_block_rows_
+                               : static_cast<int>(std::lround(std::sqrt(static_cast<double>(L_ + 1))));
+        shift_ = 0;
+        while ((1 << shift_) < target) {
+            shift_++;
+        }
+        // Nearest, not next, power of two when choosing automatically
+        if (requested_block_rows_ <= 0 && shift_ > 0 && (3 << (shift_ - 1)) > 2 * target) {
+            shift_--;
+        }
+        mask_ = (1 << shift_) - 1;
+        row_width_ = (static_cast<size_t>(M_) + 1) * p7G_NSCELLS;
+        checkpoints_.assign(static_cast<size_t>((L_ >> shift_) + 1) * row_width_, -eslINFINITY);
+        block_.assign(static_cast<size_t>(mask_) * row_width_, -eslINFINITY);
+        xmx_.assign((static_cast<size_t>(L_) + 1) * p7G_NXCELLS, -eslINFINITY);
+        resident_block_ = 0;
+    }
+
+    int model_length() const {
+        return M_;
+    }
+
+    int sequence_length() const {
+        return L_;
+    }
+
+    // B: rows per block, a power of two
+    int block_rows() const {
+        return mask_ + 1;
+    }
+
+    int block_of(int i) const {
+        return i >> shift_;
+    }
+
+    bool is_checkpoint(int i) const {
+        return (i & mask_) == 0;
+    }
+
+    // Row i can be read: a checkpoint, or inside the block in the buffer
+    bool resident(int i) const {
+        return is_checkpoint(i) || block_of(i) == resident_block_;
+    }
+
+    // Declares the scratch buffer to hold block b; the writer fills it
+    void set_resident_block(int b) {
+        resident_block_ = b;
+    }
+
+    // Core cells stored (checkpoint rows plus the block buffer)
+    uint64_t cells() const {
+        return (checkpoints_.size() + block_.size()) / p7G_NSCELLS;
+    }
+
+    // Bytes held by the core and special arrays
+    size_t bytes() const {
+        return (checkpoints_.size() + block_.size() + xmx_.size()) * sizeof(float);
+    }
+
+    // --- Accessors (DPMatrix names) ---
+    // Writes to a non-checkpoint row land in the block buffer whatever its
+    // block; the filler keeps set_resident_block() in step.
+
+    float& match(int i, int k) {
+        return row(i)[(k * p7G_NSCELLS) + p7G_M];
+    }
+
+    float match(int i, int k) const {
+        return row(i)[(k * p7G_NSCELLS) + p7G_M];
+    }
+
+    float& insert(int i, int k) {
+        return row(i)[(k * p7G_NSCELLS) + p7G_I];
+    }
+
+    float insert(int i, int k) const {
+        return row(i)[(k * p7G_NSCELLS) + p7G_I];
+    }
+
+    float& delete_state(int i, int k) {
+        return row(i)[(k * p7G_NSCELLS) + p7G_D];
+    }
+
+    float delete_state(int i, int k) const {
+        return row(i)[(k * p7G_NSCELLS) + p7G_D];
+    }
+
+    float& special(int i, int s) {
+        return xmx_[(static_cast<size_t>(i) * p7G_NXCELLS) + s];
+    }
+
+    float special(int i, int s) const {
+        return xmx_[(static_cast<size_t>(i) * p7G_NXCELLS) + s];
+    }
+
+private:
+    float* row(int i) {
+        const int slot = i & mask_;
+        return slot == 0 ? &checkpoints_[static_cast<size_t>(i >> shift_) * row_width_]
+                         : &block_[static_cast<size_t>(slot - 1) * row_width_];
+    }
+
+    const float* row(int i) const {
+        assert(resident(i));
+        const int slot = i & mask_;
+        return slot == 0 ? &checkpoints_[static_cast<size_t>(i >> shift_) * row_width_]
+                         : &block_[static_cast<size_t>(slot - 1) * row_width_];
+    }
+
+    int requested_block_rows_ = 0;
+    int M_ = 0;
+    int L_ = 0;
+    int shift_ = 0;
+    int mask_ = 0;                  // B - 1
+    int resident_block_ = 0;
+    size_t row_width_ = 0;          // (M + 1) * p7G_NSCELLS floats
+    std::vector<float> checkpoints_;  // Rows 0, B, 2B, ...
+    std::vector<float> block_;        // Rows bB+1 .. bB+B-1 of the resident block b
+    std::vector<float> xmx_;          // p7G_NXCELLS floats for every row 0..L
+};
+
+#endif // MSV_FILTER_CHECKPOINT_DP_HPP
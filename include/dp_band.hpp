@@ -0,0 +1,65 @@
+/*******************************************************************************
+ * File: include/dp_band.hpp
+ * Description: Per-row column ranges that restrict a DP to a sparse region.
+ *
+ * A DPBand marks, for every row i = 0..L, the model columns [kmin, kmax]
+ * worth evaluating; rows with kmin > kmax are empty and only their special
+ * states are computed. Banded algorithms treat every cell outside the band
+ * as -infinity.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_DP_BAND_HPP
+#define MSV_FILTER_DP_BAND_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+struct DPBand {
+    int model_length = 0;
+    int sequence_length = 0;
+    std::vector<int> kmin;  // Indexed by row 0..L
+    std::vector<int> kmax;
+
+    DPBand() = default;
+
+    // All rows empty
+    DPBand(int model_length, int sequence_length)
+        : model_length(model_length), sequence_length(sequence_length),
+          kmin(static_cast<size_t>(sequence_length) + 1, model_length + 1),
+          kmax(static_cast<size_t>(sequence_length) + 1, 0) {}
+
+    // Every cell of an M x L matrix
+    static DPBand full(int model_length, int sequence_length) {
+        DPBand band(model_length, sequence_length);
+        for (int i = 1; i <= sequence_length; i++) {
+            band.kmin[i] = 1;
+            band.kmax[i] = model_length;
+        }
+        return band;
+    }
+
+    bool contains(int i, int k) const {
+        return i >= 0 && i <= sequence_length && k >= kmin[i] && k <= kmax[i];
+    }
+
+    // Grow row i to include columns [lo, hi], clipped to 1..M
+    void include(int i, int lo, int hi) {
+        if (i < 1 || i > sequence_length) {
+            return;
+        }
+        kmin[i] = std::min(kmin[i], std::max(1, lo));
+        kmax[i] = std::max(kmax[i], std::min(model_length, hi));
+    }
+
+    // Number of cells inside the band
+    uint64_t cells() const {
+        uint64_t n = 0;
+        for (int i = 0; i <= sequence_length; i++) {
+            n += kmax[i] >= kmin[i] ? static_cast<uint64_t>(kmax[i] - kmin[i] + 1) : 0;
+        }
+        return n;
+    }
+};
+
+#endif // MSV_FILTER_DP_BAND_HPP
@@ -75,11 +75,19 @@ public:
         return dp[i][(k * p7G_NSCELLS) + p7G_I];
     }
     
+    inline float insert(int i, int k) const {
+        return dp[i][(k * p7G_NSCELLS) + p7G_I];
+    }
+    
     // DMX(i,k) = dp[(i)][(k) * p7G_NSCELLS + p7G_D]
     inline float& delete_state(int i, int k) {
         return dp[i][(k * p7G_NSCELLS) + p7G_D];
     }
     
+    inline float delete_state(int i, int k) const {
+        return dp[i][(k * p7G_NSCELLS) + p7G_D];
+    }
+    
     // XMX(i,s) = xmx[(i) * p7G_NXCELLS + (s)]
     inline float& special(int i, int s) {
         return xmx[(i * p7G_NXCELLS) + s];
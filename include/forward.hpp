@@ -0,0 +1,48 @@
+/*******************************************************************************
+ * File: include/forward.hpp
+ * Description: Generic Forward, the final stage of the filter cascade.
+ *
+ * Replicates p7_GForward() from hmmer/src/generic_fwdback.c over HMMProfile
+ * and DPMatrix, summing over all paths with the table-driven p7_FLogsum()
+ * (logsum.hpp) instead of taking the max.
+ *
+ * Sparse mode evaluates only the cells inside a DPBand, typically the
+ * Viterbi path widened by a margin (viterbi.hpp: viterbi_traceback(),
+ * trace_band()). Paths leaving the band are dropped, so the banded score is
+ * a lower bound on the full Forward score; with a few cells of margin the
+ * two agree to well below a nat for sequences that reach this stage, at a
+ * small fraction of the M x L cells. With a BandedDPMatrix only those cells
+ * are stored as well.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_FORWARD_HPP
+#define MSV_FILTER_FORWARD_HPP
+
+#include "hmmer_types.hpp"
+#include "profile.hpp"
+#include "dp_matrix.hpp"
+#include "dp_band.hpp"
+#include "banded_dp.hpp"
+#include "length_config.hpp"
+
+// Forward score in nats (raw, not null-corrected); -inf if no path exists.
+// `dp_matrix` must be allocated for at least M x L.
+float compute_forward(const DigitalResidue* digital_sequence, int sequence_length, const HMMProfile& profile,
+                      const SpecialTransitions& specials, float tbmk, DPMatrix& dp_matrix);
+
+// Same, with specials and tbmk for length L taken from `config`
+float compute_forward(const DigitalResidue* digital_sequence, int sequence_length, const HMMProfile& profile,
+                      const LengthConfigCache& config, DPMatrix& dp_matrix);
+
+// Forward restricted to the cells of `band`; cells outside it are -inf and
+// are neither read nor written. The band must span the same M x L.
+float compute_forward_banded(const DigitalResidue* digital_sequence, int sequence_length,
+                             const HMMProfile& profile, const SpecialTransitions& specials, float tbmk,
+                             const DPBand& band, DPMatrix& dp_matrix);
+
+// Same, storing only the band's cells; `dp_matrix` is reshaped to `band`
+float compute_forward_banded(const DigitalResidue* digital_sequence, int sequence_length,
+                             const HMMProfile& profile, const SpecialTransitions& specials, float tbmk,
+                             const DPBand& band, BandedDPMatrix& dp_matrix);
+
+#endif // MSV_FILTER_FORWARD_HPP
@@ -0,0 +1,46 @@
+/*******************************************************************************
+ * File: include/hmm_file.hpp
+ * Description: Reading and writing profiles in HMMER3 ASCII save files.
+ *
+ * Only what the filter pipeline uses is read from each model: NAME, LENG,
+ * ALPH (amino only), the STATS LOCAL MSV/VITERBI/FORWARD lines (evparam[])
+ * and the node lines. Emission and transition fields are -ln(p), with "*"
+ * for probability zero. Match scores become log-odds against the standard
+ * amino background, msc(k, x) = ln(p / f_x); insert scores are 0 and
+ * transitions are ln(p), as p7_ProfileConfig() leaves them for local
+ * multihit search. Models are separated by "//" lines, so one file can hold
+ * a whole library.
+ *
+ * Errors are reported as false plus a message naming the line; nothing
+ * throws.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_HMM_FILE_HPP
+#define MSV_FILTER_HMM_FILE_HPP
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "aa_alphabet.hpp"
+#include "profile.hpp"
+
+// Standard amino background frequencies (p7_AminoFrequencies), in
+// alphabet order ACDEFGHIKLMNPQRSTVWY
+extern const float AMINO_BACKGROUND[20];
+
+// Append every model in `in` to `profiles`. Profiles point at `abc`, which
+// must outlive them. On error returns false with `error` set; profiles
+// read before the bad one are kept.
+bool read_hmm_file(std::istream& in, const AminoAcidAlphabet& abc, std::vector<HMMProfile>& profiles,
+                   std::string& error);
+
+// Same, from a file path
+bool read_hmm_file(const std::string& path, const AminoAcidAlphabet& abc, std::vector<HMMProfile>& profiles,
+                   std::string& error);
+
+// Write `profile` as one HMMER3/f model (read_hmm_file() reads it back to
+// the same scores, up to the 5 decimals of the format)
+void write_hmm(std::ostream& out, const HMMProfile& profile);
+
+#endif // MSV_FILTER_HMM_FILE_HPP
@@ -45,6 +45,16 @@ constexpr int p7_NEVPARAM = 6;
 constexpr int p7_NCUTOFFS = 6;
 constexpr int p7_MAXABET = 20;
 
+// E-value parameter indices for profile evparam[] (from p7_evparams_e)
+enum p7_evparams_e {
+    p7_MMU = 0,      // MSV Gumbel location (bits)
+    p7_MLAMBDA = 1,  // MSV Gumbel scale
+    p7_VMU = 2,      // Viterbi Gumbel location (bits)
+    p7_VLAMBDA = 3,  // Viterbi Gumbel scale
+    p7_FTAU = 4,     // Forward exponential tail location (bits)
+    p7_FLAMBDA = 5   // Forward exponential tail scale
+};
+
 // Transition indices (0-6)
 constexpr int p7P_MM = 0;  // Match->Match
 constexpr int p7P_MI = 1;  // Match->Insert
@@ -58,6 +68,21 @@ constexpr int p7P_DD = 6;  // Delete->Delete
 constexpr int p7P_MSC = 0;  // Match Score
 constexpr int p7P_ISC = 1;  // Insert Score
 
+// Special state indices for profile special transitions xsc[s][t]
+enum p7p_xstates_e {
+    p7P_E = 0,  // End
+    p7P_N = 1,  // N-terminal
+    p7P_J = 2,  // Join
+    p7P_C = 3,  // C-terminal
+    p7P_B = 4   // Begin
+};
+
+// Special transition indices for profile xsc[s][t]
+enum p7p_xtransitions_e {
+    p7P_LOOP = 0,  // Stay in the special state
+    p7P_MOVE = 1   // Leave the special state
+};
+
 // Special state indices for generic DP matrix
 enum p7g_xcells_e {
     p7G_E = 0,  // End
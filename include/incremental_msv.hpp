@@ -0,0 +1,85 @@
+/*******************************************************************************
+ * File: include/incremental_msv.hpp
+ * Description: Incremental MSV rescoring after profile edits.
+ *
+ * The ungapped MSV recurrence dp[i][k] = max(0, dp[i-1][k-1] + score(i,k))
+ * never mixes diagonals: each diagonal d = k - i is an independent scan, and
+ * the sequence score is the max over diagonal maxima. Changing the match
+ * scores of column k can only change the diagonals that pass through column
+ * k, i.e. d in [k-L, k-1].
+ *
+ * IncrementalMSV keeps the per-diagonal maxima of every sequence it has
+ * scored. After a few columns are edited, rescore() recomputes only the
+ * diagonals crossing those columns and re-derives each sequence score from
+ * the cached maxima. For short sequences against long models (peptides,
+ * fragments), a handful of edited columns touches a small fraction of the
+ * M + L - 1 diagonals of each sequence.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_INCREMENTAL_MSV_HPP
+#define MSV_FILTER_INCREMENTAL_MSV_HPP
+
+#include <cstdint>
+#include <vector>
+#include "hmmer_types.hpp"
+#include "profile.hpp"
+
+// Work done by one rescore() compared with a full rescan
+struct RescoreStats {
+    uint64_t sequences = 0;         // Cached sequences
+    uint64_t diagonals_total = 0;   // Sum of M + L - 1 over sequences
+    uint64_t diagonals_rescored = 0;
+    uint64_t cells_total = 0;       // Sum of M * L over sequences
+    uint64_t cells_rescored = 0;
+
+    double cell_fraction() const {
+        return cells_total > 0 ? static_cast<double>(cells_rescored) / static_cast<double>(cells_total) : 0.0;
+    }
+};
+
+class IncrementalMSV {
+public:
+    // The engine reads (and, through set_match_score, edits) `profile`; the
+    // profile's model length must not change while sequences are cached.
+    explicit IncrementalMSV(HMMProfile& profile);
+
+    // Score a sentinel-framed sequence in full and cache its diagonals.
+    // Returns the id used by score().
+    int add_sequence(const DigitalResidue* digital_sequence, int sequence_length);
+
+    int num_sequences() const {
+        return static_cast<int>(entries_.size());
+    }
+
+    // Current MSV score of a cached sequence
+    float score(int id) const {
+        return entries_[id].score;
+    }
+
+    // Edit one match score and mark its column for rescoring
+    void set_match_score(int k, int residue, float value);
+
+    // Mark a column the caller edited directly in the profile
+    void mark_column_edited(int k);
+
+    // Recompute diagonals crossing the edited columns, then clear the marks
+    RescoreStats rescore();
+
+private:
+    struct Entry {
+        std::vector<DigitalResidue> digital_sequence;  // Sentinel-framed copy
+        int sequence_length;
+        std::vector<float> diagonal_max;              // Indexed by d + L - 1
+        float score;
+    };
+
+    // Max over the cells of diagonal d = k - i of one sequence
+    float scan_diagonal(const Entry& entry, int d) const;
+
+    HMMProfile& profile_;
+    std::vector<Entry> entries_;
+    std::vector<bool> edited_;  // Indexed by column k (1..M)
+    bool any_edited_ = false;
+};
+
+#endif // MSV_FILTER_INCREMENTAL_MSV_HPP
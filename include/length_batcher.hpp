@@ -0,0 +1,121 @@
+/*******************************************************************************
+ * File: include/length_batcher.hpp
+ * Description: Length-bucketed batching of digital sequences.
+ *
+ * Kernels that score several sequences side by side (one sequence per SIMD
+ * lane, or one sequence per thread in a chunk) run for as many rows as the
+ * longest member. Short members leave their lanes idle for the remainder.
+ * The batcher groups sequences of similar length into buckets before
+ * dispatch so that each batch is close to rectangular, and reports how many
+ * lane slots were actually filled with residues.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_LENGTH_BATCHER_HPP
+#define MSV_FILTER_LENGTH_BATCHER_HPP
+
+#include <cstdint>
+#include <vector>
+#include "hmmer_types.hpp"
+
+/*******************************************************************************
+ * Batch and Statistics Types
+ ******************************************************************************/
+
+// One dispatch unit: up to `lanes` sequences scored together
+struct SequenceBatch {
+    int bucket;                // Bucket index the members were drawn from
+    int max_length;            // Longest member; the batch runs this many rows
+    std::vector<int> members;  // Indices into the caller's sequence set
+};
+
+// Lane occupancy for one bucket (or for the whole run)
+struct LaneOccupancy {
+    int64_t batches = 0;         // Number of batches dispatched
+    int64_t sequences = 0;       // Number of sequences in those batches
+    int64_t residue_slots = 0;   // Sum of member lengths (useful work)
+    int64_t lane_slots = 0;      // Sum over batches of lanes * max_length
+
+    // Fraction of lane slots that held a residue (1.0 = no idle lanes)
+    double occupancy() const {
+        return lane_slots > 0 ? static_cast<double>(residue_slots) / static_cast<double>(lane_slots) : 1.0;
+    }
+
+    double idle_fraction() const {
+        return 1.0 - occupancy();
+    }
+
+    void add(const LaneOccupancy& other) {
+        batches += other.batches;
+        sequences += other.sequences;
+        residue_slots += other.residue_slots;
+        lane_slots += other.lane_slots;
+    }
+};
+
+// Occupancy report: totals plus a per-bucket breakdown
+struct BatchReport {
+    LaneOccupancy total;
+    std::vector<LaneOccupancy> per_bucket;  // Indexed by SequenceBatch::bucket
+};
+
+/*******************************************************************************
+ * LengthBatcher
+ *
+ * Buckets are described by ascending inclusive upper bounds on sequence
+ * length. A sequence of length L lands in the first bucket whose bound is
+ * >= L; anything longer than the last bound goes to a final overflow bucket,
+ * so there are always bucket_bounds.size() + 1 buckets.
+ *
+ * Within a bucket, members are ordered longest-first before being cut into
+ * batches of `lanes` sequences. The order of batches follows bucket order.
+ ******************************************************************************/
+
+class LengthBatcher {
+public:
+    LengthBatcher(int lanes, std::vector<int> bucket_bounds);
+
+    // Buckets of fixed width: (0,width], (width,2*width], ... up to max_length
+    static std::vector<int> uniform_bounds(int width, int max_length);
+
+    // Buckets whose width grows by `ratio` each step, starting at first_width.
+    // Suits length distributions with a long tail (UniProt, read sets).
+    static std::vector<int> geometric_bounds(int first_width, double ratio, int max_length);
+
+    int lanes() const {
+        return lanes_;
+    }
+
+    int num_buckets() const {
+        return static_cast<int>(bucket_bounds_.size()) + 1;
+    }
+
+    const std::vector<int>& bucket_bounds() const {
+        return bucket_bounds_;
+    }
+
+    // Bucket index for a sequence of the given length
+    int bucket_of(int length) const;
+
+    // Group sequences by length bucket and cut each bucket into batches
+    std::vector<SequenceBatch> make_batches(const std::vector<int>& lengths) const;
+
+    // Same, for 1-indexed digital sequences with sentinels at 0 and L+1
+    std::vector<SequenceBatch> make_batches(const std::vector<std::vector<DigitalResidue>>& sequences) const;
+
+    // Batches in input order, no bucketing; the baseline for comparison
+    std::vector<SequenceBatch> naive_batches(const std::vector<int>& lengths) const;
+
+    // Lane occupancy of a batch plan over the given lengths
+    BatchReport measure(const std::vector<SequenceBatch>& batches, const std::vector<int>& lengths) const;
+
+    // Length of a sentinel-framed digital sequence
+    static int sequence_length_of(const std::vector<DigitalResidue>& digital_sequence) {
+        return digital_sequence.size() >= 2 ? static_cast<int>(digital_sequence.size()) - 2 : 0;
+    }
+
+private:
+    int lanes_;
+    std::vector<int> bucket_bounds_;
+};
+
+#endif // MSV_FILTER_LENGTH_BATCHER_HPP
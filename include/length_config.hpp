@@ -0,0 +1,103 @@
+/*******************************************************************************
+ * File: include/length_config.hpp
+ * Description: Target-length configuration of special-state transitions.
+ *
+ * HMMER's p7_ReconfigLength() rewrites the N/C/J loop and move scores of a
+ * profile for every target sequence length L, and p7_GMSV() recomputes its
+ * own tloop/tmove/tbmk/tej/tec constants from L, M and expected_hit_count on
+ * every call. Both are a handful of logf() calls per sequence, which adds up
+ * over a large database, and mutating the profile is not an option when
+ * several threads score against it.
+ *
+ * LengthConfigCache precomputes the length-dependent logs once per profile
+ * for all L up to a cap and hands out per-length values by copy. The cache is
+ * immutable after construction, so it can be shared across threads freely.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_LENGTH_CONFIG_HPP
+#define MSV_FILTER_LENGTH_CONFIG_HPP
+
+#include <vector>
+#include "hmmer_types.hpp"
+#include "profile.hpp"
+
+/*******************************************************************************
+ * Per-Length Values
+ ******************************************************************************/
+
+// Special transitions for one target length; same layout as HMMProfile::xsc
+struct SpecialTransitions {
+    float xsc[p7P_NXSTATES][p7P_NXTRANS];
+    int sequence_length;
+
+    float operator()(int state, int transition) const {
+        return xsc[state][transition];
+    }
+
+    // Copy into a profile-shaped xsc array (e.g. a thread-private profile copy)
+    void copy_to(float (&dst)[p7P_NXSTATES][p7P_NXTRANS]) const {
+        for (int s = 0; s < p7P_NXSTATES; s++) {
+            for (int t = 0; t < p7P_NXTRANS; t++) {
+                dst[s][t] = xsc[s][t];
+            }
+        }
+    }
+};
+
+// Length-dependent constants used by p7_GMSV
+struct MSVLengthParams {
+    float tloop;  // log(L / (L+3))          N, C, J loop
+    float tmove;  // log(3 / (L+3))          N, C, J move
+    float tbmk;   // log(2 / (M * (M+1)))    uniform local entry B->Mk
+    float tej;    // log((nu - 1) / nu)      E->J
+    float tec;    // log(1 / nu)             E->C
+};
+
+/*******************************************************************************
+ * LengthConfigCache
+ ******************************************************************************/
+
+class LengthConfigCache {
+public:
+    // Default cap covers typical protein lengths in 16 KB per profile;
+    // longer targets fall back to direct computation (four logf calls,
+    // noise next to their O(ML) DP) and give identical values.
+    static constexpr int DEFAULT_MAX_CACHED_LENGTH = 1024;
+
+    LengthConfigCache(const HMMProfile& profile, float expected_hit_count,
+                      int max_cached_length = DEFAULT_MAX_CACHED_LENGTH);
+
+    // Profile special transitions configured for target length L (a
+    // negative L is treated as 0)
+    SpecialTransitions for_length(int sequence_length) const;
+
+    // p7_GMSV constants for target length L (a negative L is treated as 0)
+    MSVLengthParams msv_params(int sequence_length) const;
+
+    int max_cached_length() const {
+        return static_cast<int>(loop_move_.size()) - 1;
+    }
+
+    // In-place p7_ReconfigLength() for a profile the caller owns exclusively
+    static void reconfigure(HMMProfile& profile, int sequence_length);
+
+private:
+    // log(ploop), log(pmove) for N/C/J under the profile's nj
+    struct LoopMove {
+        float loop;
+        float move;
+    };
+
+    static LoopMove profile_loop_move(int sequence_length, float nj);
+    static LoopMove msv_loop_move(int sequence_length);
+
+    SpecialTransitions base_;          // L-independent entries copied from the profile
+    float tbmk_;
+    float tej_;
+    float tec_;
+    float nj_;
+    std::vector<LoopMove> loop_move_;  // Indexed by L, profile nj
+    std::vector<LoopMove> msv_loop_;   // Indexed by L, p7_GMSV's 3/(L+3)
+};
+
+#endif // MSV_FILTER_LENGTH_CONFIG_HPP
@@ -0,0 +1,36 @@
+/*******************************************************************************
+ * File: include/logsum.hpp
+ * Description: Table-driven log-sum-exp, after p7_FLogsum() in
+ * hmmer/src/logsum.c.
+ *
+ * Forward sums path probabilities in log space: log(e^a + e^b) =
+ * max(a,b) + log(1 + e^-(|a-b|)). The correction term depends only on the
+ * difference and vanishes beyond ~15.7 nats, so it is tabulated at 1/1000
+ * nat resolution once per process instead of calling exp() and log() for
+ * every DP cell. Absolute error is below 1e-3 nats per operation.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_LOGSUM_HPP
+#define MSV_FILTER_LOGSUM_HPP
+
+#include "hmmer_types.hpp"
+
+constexpr int p7_LOGSUM_SCALE = 1000;  // Table entries per nat
+constexpr int p7_LOGSUM_TBL = 16000;   // Covers differences up to 16 nats
+
+// Correction table log(1 + e^(-i / p7_LOGSUM_SCALE)); built on first use
+// (thread-safe) and immutable afterwards
+const float* p7_flogsum_table();
+
+// log(e^a + e^b) by table lookup
+inline float p7_FLogsum(float a, float b) {
+    static const float* const table = p7_flogsum_table();
+    const float max = a > b ? a : b;
+    const float min = a > b ? b : a;
+    if (min == -eslINFINITY || max - min >= 15.7f) {
+        return max;
+    }
+    return max + table[static_cast<int>((max - min) * p7_LOGSUM_SCALE)];
+}
+
+#endif // MSV_FILTER_LOGSUM_HPP
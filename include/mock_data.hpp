@@ -10,6 +10,7 @@
 #include <vector>
 #include <string>
 #include <cmath>
+#include <random>
 #include "hmmer_types.hpp"
 #include "aa_alphabet.hpp"
 #include "profile.hpp"
@@ -107,6 +108,70 @@ public:
         return profile;
     }
     
+    // --- Mock Gapped Profile ---
+    // The pattern profile plus what the gapped stages (Viterbi, Forward) read:
+    // node transitions in the usual HMMER proportions, zero insert scores
+    // (insert emissions equal the background) and multihit E->J/E->C.
+    static HMMProfile create_gapped_pattern_profile(int model_length, const AminoAcidAlphabet& abc) {
+        HMMProfile profile = create_pattern_profile(model_length, abc);
+        profile.name = "gapped_pattern_model";
+        profile.nj = 1.0f;
+        profile.xsc[p7P_E][p7P_LOOP] = -eslCONST_LOG2;
+        profile.xsc[p7P_E][p7P_MOVE] = -eslCONST_LOG2;
+
+        for (int k = 0; k < model_length; k++) {
+            profile.trans(k, p7P_MM) = std::log(0.90f);
+            profile.trans(k, p7P_MI) = std::log(0.05f);
+            profile.trans(k, p7P_MD) = std::log(0.05f);
+            profile.trans(k, p7P_IM) = std::log(0.60f);
+            profile.trans(k, p7P_II) = std::log(0.40f);
+            profile.trans(k, p7P_DM) = std::log(0.70f);
+            profile.trans(k, p7P_DD) = std::log(0.30f);
+        }
+        for (int k = 1; k < model_length; k++) {
+            for (int x = 0; x < abc.K; x++) {
+                profile.insert_score(k, x) = 0.0f;
+            }
+        }
+        return profile;
+    }
+
+    // --- Mock Sequence Database ---
+    // Creates num_sequences random sequences with lengths in [min_length, max_length].
+    // A fraction `planted_fraction` of them carry a copy of the pattern profile's
+    // preferred residues ((k-1) % K for k = 1..planted_length) at a random offset,
+    // so filters have something to find. Deterministic for a given seed.
+    static std::vector<std::vector<DigitalResidue>> create_mock_database(
+        int num_sequences, int min_length, int max_length, const AminoAcidAlphabet& abc,
+        double planted_fraction = 0.0, int planted_length = 0, unsigned seed = 42)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> length_dist(min_length, max_length);
+        std::uniform_int_distribution<int> residue_dist(0, abc.K - 1);
+        std::uniform_real_distribution<double> coin(0.0, 1.0);
+
+        std::vector<std::vector<DigitalResidue>> database(num_sequences);
+        for (int n = 0; n < num_sequences; n++) {
+            int sequence_length = length_dist(rng);
+            std::vector<DigitalResidue>& digital_sequence = database[n];
+            digital_sequence.resize(sequence_length + 2);
+            digital_sequence[0] = digitalResidueSentinel;
+            digital_sequence[sequence_length + 1] = digitalResidueSentinel;
+            for (int i = 1; i <= sequence_length; i++) {
+                digital_sequence[i] = static_cast<DigitalResidue>(residue_dist(rng));
+            }
+
+            if (planted_length > 0 && planted_length <= sequence_length && coin(rng) < planted_fraction) {
+                std::uniform_int_distribution<int> offset_dist(1, sequence_length - planted_length + 1);
+                int offset = offset_dist(rng);
+                for (int k = 1; k <= planted_length; k++) {
+                    digital_sequence[offset + k - 1] = static_cast<DigitalResidue>((k - 1) % abc.K);
+                }
+            }
+        }
+        return database;
+    }
+    
     // --- Create DP Matrix ---
     static DPMatrix create_dp_matrix(int model_length, int sequence_length) {
         return DPMatrix(model_length, sequence_length);
@@ -0,0 +1,40 @@
+/*******************************************************************************
+ * File: include/msv_generic.hpp
+ * Description: Multi-hit MSV with special states, as scored by the pipeline.
+ *
+ * The MSV kernels (msv_kernel.hpp) return the best ungapped segment alone.
+ * HMMER's p7_GMSV() wraps the same match-only core in the N/B/E/J/C states
+ * so several segments add up and the score is a proper log-odds sequence
+ * score that the MSV Gumbel (evparam[p7_MMU]) applies to:
+ *   M(i,k) = msc(k, x_i) + max(M(i-1,k-1), B(i-1) + tbmk)
+ *   E(i) = max_k M(i,k);  J, C, N, B from the p7_GMSV constants for L
+ * and the result is C(L) + tmove.
+ *
+ * Only one row of M is kept, in caller-owned scratch. Residue codes >= Kp
+ * cannot be emitted, which breaks every segment through them.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_MSV_GENERIC_HPP
+#define MSV_FILTER_MSV_GENERIC_HPP
+
+#include <vector>
+#include "hmmer_types.hpp"
+#include "profile.hpp"
+#include "length_config.hpp"
+
+// Multi-hit MSV score in nats (raw, not null-corrected); `params` must be
+// the p7_GMSV constants for this sequence length
+float compute_msv_generic(const DigitalResidue* digital_sequence, int sequence_length, const HMMProfile& profile,
+                          const MSVLengthParams& params, std::vector<float>& row_buffer);
+
+// Same, with the constants for length L taken from `config`
+float compute_msv_generic(const DigitalResidue* digital_sequence, int sequence_length, const HMMProfile& profile,
+                          const LengthConfigCache& config, std::vector<float>& row_buffer);
+
+// Sequence score of a single ungapped segment of `segment_nats` (an MSV
+// kernel score) under the same specials: N->B, B->Mk, E->C, C->T, with the
+// N/C loops approximated by L * tloop (about -3 nats), as HMMER's SSV
+// filter does. A lower bound on the multi-hit score for the same segment.
+float ssv_sequence_score(float segment_nats, int sequence_length, const MSVLengthParams& params);
+
+#endif // MSV_FILTER_MSV_GENERIC_HPP
@@ -0,0 +1,161 @@
+/*******************************************************************************
+ * File: include/msv_kernel.hpp
+ * Description: MSV kernel family, specialized at compile time on the
+ * alphabet and on the score type / saturation policy.
+ *
+ * The kernels here take an alphabet traits type (alphabet_traits.hpp) instead
+ * of reading K through profile.abc. Score tables are residue-major with a
+ * statically known number of rows, the "residue is not canonical" test is a
+ * compare against a constant, and the per-residue row lookup is a single
+ * multiply-add into one contiguous block.
+ *
+ * The same loop serves float (reference), int16 and uint8 scores through the
+ * policies in score_policy.hpp, so precision can be traded for speed per
+ * workload without maintaining separate hand-copied kernels.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_MSV_KERNEL_HPP
+#define MSV_FILTER_MSV_KERNEL_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+#include "hmmer_types.hpp"
+#include "profile.hpp"
+#include "alphabet_traits.hpp"
+#include "score_policy.hpp"
+
+/*******************************************************************************
+ * MatchScoreTable<K, Policy>
+ *
+ * Match scores copied out of HMMProfile::rsc into one contiguous block and
+ * converted to the policy's stored type (score_policy.hpp):
+ * row(x)[k] = quantize(profile.match_score(k, x)) for x = 0..K-1, k = 0..M.
+ * Column k=0 is never read. Built once per profile and shared read-only
+ * between threads.
+ ******************************************************************************/
+
+template<int K, class Policy = FloatPolicy>
+struct MatchScoreTable {
+    using stored_type = typename Policy::stored_type;
+    static constexpr int NUM_ROWS = K;
+
+    int model_length;
+    QuantizationParams quant;
+    std::vector<stored_type> scores;  // K rows of (model_length + 1)
+
+    explicit MatchScoreTable(const HMMProfile& profile, float scale = Policy::default_scale())
+        : model_length(profile.model_length), scores(static_cast<size_t>(K) * (profile.model_length + 1))
+    {
+        assert(profile.abc == nullptr || profile.abc->K == K);
+        quant.scale = scale;
+        quant.bias = bias_for(profile, scale);
+        for (int x = 0; x < K; x++) {
+            stored_type* dst = row(x);
+            for (int k = 1; k <= model_length; k++) {
+                dst[k] = Policy::quantize(profile.match_score(k, x), quant);
+            }
+        }
+    }
+
+    stored_type* row(int x) {
+        return scores.data() + (static_cast<size_t>(x) * (model_length + 1));
+    }
+
+    const stored_type* row(int x) const {
+        return scores.data() + (static_cast<size_t>(x) * (model_length + 1));
+    }
+
+    // Convert a DP cell value of this table back to nats
+    float to_nats(typename Policy::cell_type v) const {
+        return Policy::to_nats(v, quant);
+    }
+
+private:
+    // Largest finite match score, quantized; only biased policies use it
+    static int bias_for(const HMMProfile& profile, float scale) {
+        if constexpr (std::is_same_v<Policy, BiasedSaturating<stored_type>>) {
+            float max_score = 0.0f;
+            for (int x = 0; x < K; x++) {
+                for (int k = 1; k <= profile.model_length; k++) {
+                    const float sc = profile.match_score(k, x);
+                    if (std::isfinite(sc)) {
+                        max_score = std::max(max_score, sc);
+                    }
+                }
+            }
+            return Policy::bias_for(max_score, scale);
+        } else {
+            (void)profile;
+            (void)scale;
+            return 0;
+        }
+    }
+};
+
+/*******************************************************************************
+ * msv_kernel<Traits, Policy>
+ *
+ * Ungapped MSV over a sentinel-framed digital sequence; same recurrence and
+ * result as compute_msv:
+ *   dp[i][k] = max(0, dp[i-1][k-1] + score(i,k)),   score = max over i,k
+ * A non-canonical residue (code >= K) resets the row to 0.
+ *
+ * Returns the score in nats, or +inf if an integer policy saturated (the
+ * sequence then passes unconditionally, as in p7_MSVFilter's eslERANGE).
+ * Only two DP rows are kept, in `row_buffer` (caller-owned scratch, resized
+ * as needed), so memory is O(M) instead of a full DPMatrix.
+ ******************************************************************************/
+
+template<class Traits, class Policy = FloatPolicy>
+float msv_kernel(const DigitalResidue* digital_sequence, int sequence_length,
+                 const MatchScoreTable<Traits::K, Policy>& table,
+                 std::vector<typename Policy::cell_type>& row_buffer)
+{
+    using cell_type = typename Policy::cell_type;
+    const int M = table.model_length;
+    const int L = sequence_length;
+    if (L <= 0 || M <= 0) {
+        return 0.0f;
+    }
+
+    const QuantizationParams q = table.quant;
+    row_buffer.assign(2 * static_cast<size_t>(M + 1), cell_type(0));
+    cell_type* prev = row_buffer.data();
+    cell_type* cur = prev + (M + 1);
+    cell_type max_cell = 0;
+
+    for (int i = 1; i <= L; i++) {
+        const DigitalResidue residue = digital_sequence[i];
+        if (residue >= Traits::K) {
+            std::fill(cur + 1, cur + M + 1, cell_type(0));
+        } else {
+            const typename Policy::stored_type* s = table.row(residue);
+            cell_type row_max = 0;
+            for (int k = 1; k <= M; k++) {
+                const cell_type v = Policy::step(prev[k - 1], s[k], q);
+                cur[k] = v;
+                row_max = std::max(row_max, v);
+            }
+            if (Policy::overflows(row_max, q)) {
+                return eslINFINITY;
+            }
+            max_cell = std::max(max_cell, row_max);
+        }
+        std::swap(prev, cur);
+    }
+    return table.to_nats(max_cell);
+}
+
+// Score tables for the two alphabets in the tree, per policy
+template<class Policy = FloatPolicy>
+using AminoScoreTableT = MatchScoreTable<AminoTraits::K, Policy>;
+template<class Policy = FloatPolicy>
+using NucleotideScoreTableT = MatchScoreTable<NucleotideTraits::K, Policy>;
+
+using AminoScoreTable = AminoScoreTableT<>;
+using NucleotideScoreTable = NucleotideScoreTableT<>;
+
+#endif // MSV_FILTER_MSV_KERNEL_HPP
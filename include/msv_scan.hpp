@@ -0,0 +1,232 @@
+/*******************************************************************************
+ * File: include/msv_scan.hpp
+ * Description: Intra-sequence parallel MSV as a blocked max-plus scan.
+ *
+ * One huge comparison (a long model against a chromosome-scale translated
+ * sequence) is a single chain of row updates and runs on one core. Each
+ * row update is max-plus linear, though: along a diagonal
+ *   v' = max(0, v + s)
+ * and composing such steps keeps the form v' = max(c, v + d). So the rows
+ * are cut into blocks that are scored in parallel against a symbolic entry
+ * row. Cell (i, k) of a block is kept as the pair (c, d), meaning
+ *   value = max(c, x_j + d)
+ * where x_j is the unknown entry value of the diagonal at column j of the
+ * row above the block. Per block this leaves
+ *   - the exit row as (c, d) pairs,
+ *   - the max of c over the block,
+ *   - for every entry diagonal j, the max of d along it,
+ * and a serial pass over the blocks then fixes the boundaries with O(M)
+ * work per block: block max = max(c_max, max_j x_j + d_max[j]), and the
+ * exit row becomes the next block's entry row.
+ *
+ * Diagonals that start inside a block have d = -inf, so after its first M
+ * rows a block does exactly the sequential kernel's work; the symbolic
+ * overhead is an M x M triangle per block.
+ *
+ * Integer policies compose in the policy's unsaturated wide_type
+ * (score_policy.hpp). Clipping only ever happens above the overflow
+ * threshold, so the result, +inf on overflow included, equals msv_kernel()
+ * exactly. Float results agree up to summation order (a few ulps).
+ *
+ * Phase 1 runs on MSVScanConfig::pool when one is given. Without a pool
+ * every call starts and joins its own threads, which only pays off for
+ * sequences long enough to dwarf thread start-up; callers scanning many
+ * sequences should keep a ThreadPool (thread_pool.hpp) and pass it.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_MSV_SCAN_HPP
+#define MSV_FILTER_MSV_SCAN_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "hmmer_types.hpp"
+#include "msv_kernel.hpp"
+#include "thread_pool.hpp"
+
+struct MSVScanConfig {
+    int num_threads = 0;         // 0 = std::thread::hardware_concurrency(), or the pool's size
+    int num_blocks = 0;          // 0 = 4 per thread
+    int min_block_rows = 4096;   // Below this many rows per block, fewer blocks
+    ThreadPool* pool = nullptr;  // Run blocks on these workers instead of new threads
+};
+
+// Symbolic summary of rows first_row..last_row, all wide-typed
+template<typename Wide>
+struct MSVBlockSummary {
+    int first_row = 0;
+    int last_row = 0;
+    Wide const_max = 0;
+    std::vector<Wide> exit_const;   // c of the last row, k = 0..M
+    std::vector<Wide> exit_offset;  // d of the last row, k = 0..M
+    std::vector<Wide> diagonal_max; // Max d along entry diagonal j = 0..M
+
+    int rows() const {
+        return last_row - first_row + 1;
+    }
+};
+
+// -inf of the wide type; int64 keeps far enough from the bottom that adding
+// scores to it cannot wrap
+template<typename Wide>
+constexpr Wide scan_negative_infinity() {
+    if constexpr (std::is_floating_point_v<Wide>) {
+        return -std::numeric_limits<Wide>::infinity();
+    } else {
+        return std::numeric_limits<Wide>::min() / 4;
+    }
+}
+
+/*******************************************************************************
+ * msv_scan_block<Traits, Policy>
+ *
+ * Scores rows first_row..last_row against a symbolic entry row (phase 1).
+ * Blocks are independent and can run on any thread.
+ ******************************************************************************/
+
+template<class Traits, class Policy = FloatPolicy>
+void msv_scan_block(const DigitalResidue* digital_sequence, int first_row, int last_row,
+                    const MatchScoreTable<Traits::K, Policy>& table,
+                    MSVBlockSummary<typename Policy::wide_type>& summary)
+{
+    using Wide = typename Policy::wide_type;
+    constexpr Wide NEG = scan_negative_infinity<Wide>();
+    const int M = table.model_length;
+    const QuantizationParams q = table.quant;
+
+    summary.first_row = first_row;
+    summary.last_row = last_row;
+    summary.const_max = 0;
+    // Entry row: x_j = max(0, x_j + 0) for j >= 1; column 0 is the known 0
+    summary.exit_const.assign(static_cast<size_t>(M) + 1, Wide(0));
+    summary.exit_offset.assign(static_cast<size_t>(M) + 1, Wide(0));
+    summary.exit_offset[0] = NEG;
+    summary.diagonal_max.assign(static_cast<size_t>(M) + 1, NEG);
+    Wide* c = summary.exit_const.data();
+    Wide* d = summary.exit_offset.data();
+    Wide* dmax = summary.diagonal_max.data();
+    Wide cmax = 0;
+
+    for (int i = first_row; i <= last_row; i++) {
+        const DigitalResidue residue = digital_sequence[i];
+        if (residue >= Traits::K) {
+            std::fill(c + 1, c + M + 1, Wide(0));
+            std::fill(d + 1, d + M + 1, NEG);
+            continue;
+        }
+
+        // k descending: c[k-1], d[k-1] still hold row i-1. Cell (i, k) lies
+        // on entry diagonal j = k - r; for k <= r it started inside the block
+        // and d is -inf, so only c is needed there
+        const typename Policy::stored_type* s = table.row(residue);
+        const int r = i - first_row + 1;
+        int k = M;
+        for (; k > r; k--) {
+            const Wide inc = Policy::increment(s[k], q);
+            const Wide cv = std::max(Wide(0), c[k - 1] + inc);
+            const Wide dv = std::max(NEG, d[k - 1] + inc);
+            c[k] = cv;
+            d[k] = dv;
+            cmax = std::max(cmax, cv);
+            dmax[k - r] = std::max(dmax[k - r], dv);
+        }
+        for (; k >= 1; k--) {
+            const Wide cv = std::max(Wide(0), c[k - 1] + Policy::increment(s[k], q));
+            c[k] = cv;
+            d[k] = NEG;
+            cmax = std::max(cmax, cv);
+        }
+    }
+    summary.const_max = cmax;
+}
+
+/*******************************************************************************
+ * msv_scan<Traits, Policy>
+ *
+ * Same score as msv_kernel() over digital_sequence[1..L]: blocks in
+ * parallel (phase 1), then the serial boundary fix-up (phase 2). `blocks`
+ * is caller-owned scratch, one summary per block.
+ ******************************************************************************/
+
+template<class Traits, class Policy = FloatPolicy>
+float msv_scan(const DigitalResidue* digital_sequence, int sequence_length,
+               const MatchScoreTable<Traits::K, Policy>& table, const MSVScanConfig& config,
+               std::vector<MSVBlockSummary<typename Policy::wide_type>>& blocks)
+{
+    using Wide = typename Policy::wide_type;
+    using cell_type = typename Policy::cell_type;
+    constexpr Wide NEG = scan_negative_infinity<Wide>();
+    const int M = table.model_length;
+    const int L = sequence_length;
+    if (L <= 0 || M <= 0) {
+        return 0.0f;
+    }
+
+    // --- A. Block layout ---
+    int threads = config.num_threads > 0 ? config.num_threads
+                  : config.pool != nullptr ? config.pool->size()
+                                           : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, threads);
+    int num_blocks = config.num_blocks > 0 ? config.num_blocks : 4 * threads;
+    num_blocks = std::max(1, std::min(num_blocks, L / std::max(1, config.min_block_rows)));
+    blocks.resize(num_blocks);
+
+    // --- B. Phase 1: symbolic blocks; workers pull the next block index ---
+    auto score_block = [&](int b) {
+        const int first = 1 + static_cast<int>(static_cast<int64_t>(L) * b / num_blocks);
+        const int last = static_cast<int>(static_cast<int64_t>(L) * (b + 1) / num_blocks);
+        msv_scan_block<Traits, Policy>(digital_sequence, first, last, table, blocks[b]);
+    };
+    std::atomic<int> next_block(0);
+    auto worker = [&]() {
+        for (int b = next_block++; b < num_blocks; b = next_block++) {
+            score_block(b);
+        }
+    };
+    threads = std::min(threads, num_blocks);
+    if (threads == 1) {
+        worker();
+    } else if (config.pool != nullptr) {
+        config.pool->parallel_for(num_blocks, [&](int b, int) { score_block(b); });
+    } else {
+        std::vector<std::thread> pool;
+        for (int t = 0; t < threads; t++) {
+            pool.emplace_back(worker);
+        }
+        for (std::thread& thread : pool) {
+            thread.join();
+        }
+    }
+
+    // --- C. Phase 2: resolve each block against the row above it ---
+    std::vector<Wide> entry(static_cast<size_t>(M) + 1, Wide(0));  // Row 0
+    std::vector<Wide> exit(static_cast<size_t>(M) + 1, Wide(0));
+    Wide best = 0;
+    for (const MSVBlockSummary<Wide>& block : blocks) {
+        best = std::max(best, block.const_max);
+        for (int j = 1; j < M; j++) {
+            best = std::max(best, entry[j] + block.diagonal_max[j]);
+        }
+        const int n = block.rows();
+        for (int k = 1; k <= M; k++) {
+            const Wide carried = k - n >= 1 ? entry[k - n] + block.exit_offset[k] : NEG;
+            exit[k] = std::max(block.exit_const[k], carried);
+        }
+        std::swap(entry, exit);
+    }
+
+    // The unsaturated max reaches the overflow threshold exactly when the
+    // saturating kernel would have stopped there
+    const Wide top = static_cast<Wide>(std::numeric_limits<cell_type>::max());
+    const cell_type max_cell = static_cast<cell_type>(std::min(best, top));
+    if (Policy::overflows(max_cell, table.quant)) {
+        return eslINFINITY;
+    }
+    return table.to_nats(max_cell);
+}
+
+#endif // MSV_FILTER_MSV_SCAN_HPP
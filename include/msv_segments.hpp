@@ -0,0 +1,182 @@
+/*******************************************************************************
+ * File: include/msv_segments.hpp
+ * Description: MSV kernel that also reports where the best ungapped
+ * segments are, not just the best score.
+ *
+ * Every DP cell carries the run it belongs to: the maximal stretch of
+ * positive values along its diagonal since the last reset to 0. The run
+ * remembers its start row and the row where its value peaked, and is
+ * offered to a bounded min-heap of the top N segments when it ends (its
+ * value drops to 0, it reaches k = M or i = L, or a non-canonical residue
+ * resets the row). Each run contributes one segment: from its start to its
+ * peak, which is exactly the highest-scoring segment ending at that peak.
+ *
+ * Seeded downstream stages (banded Viterbi/Forward) can then work in a
+ * window around these diagonals instead of over the full M x L matrix.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_MSV_SEGMENTS_HPP
+#define MSV_FILTER_MSV_SEGMENTS_HPP
+
+#include <algorithm>
+#include <vector>
+#include "hmmer_types.hpp"
+#include "msv_kernel.hpp"
+
+/*******************************************************************************
+ * Segments and the Top-N Heap
+ ******************************************************************************/
+
+// One ungapped segment: residues i_start..i_end aligned to k_start..k_end
+struct MSVSegment {
+    int i_start;
+    int i_end;
+    int k_start;
+    int k_end;
+    float score;  // Nats
+
+    int diagonal() const {
+        return i_start - k_start;
+    }
+
+    int length() const {
+        return i_end - i_start + 1;
+    }
+};
+
+// Higher score first; ties broken by position so the order is deterministic
+inline bool segment_better(const MSVSegment& a, const MSVSegment& b) {
+    if (a.score != b.score) {
+        return a.score > b.score;
+    }
+    if (a.i_end != b.i_end) {
+        return a.i_end < b.i_end;
+    }
+    return a.k_end < b.k_end;
+}
+
+// Keeps the best `capacity` segments offered to it
+class SegmentHeap {
+public:
+    explicit SegmentHeap(int capacity) : capacity_(std::max(0, capacity)) {
+        heap_.reserve(capacity_);
+    }
+
+    void offer(const MSVSegment& segment) {
+        if (static_cast<int>(heap_.size()) < capacity_) {
+            heap_.push_back(segment);
+            std::push_heap(heap_.begin(), heap_.end(), segment_better);
+        } else if (capacity_ > 0 && segment_better(segment, heap_.front())) {
+            std::pop_heap(heap_.begin(), heap_.end(), segment_better);
+            heap_.back() = segment;
+            std::push_heap(heap_.begin(), heap_.end(), segment_better);
+        }
+    }
+
+    // Best first
+    std::vector<MSVSegment> sorted() const {
+        std::vector<MSVSegment> out = heap_;
+        std::sort(out.begin(), out.end(), segment_better);
+        return out;
+    }
+
+private:
+    int capacity_;
+    std::vector<MSVSegment> heap_;  // Min-heap under segment_better: worst kept segment on top
+};
+
+/*******************************************************************************
+ * msv_kernel_segments<Traits, Policy>
+ *
+ * Same recurrence, score and saturation behaviour as msv_kernel(); in
+ * addition `segments` receives up to `top_n` segments, best first. On
+ * saturation (+inf) the segments found so far are returned.
+ ******************************************************************************/
+
+// Per-cell run state; caller-owned scratch for msv_kernel_segments()
+template<typename Cell>
+struct SegmentRun {
+    Cell value;     // DP value
+    Cell best;      // Peak value of the run so far
+    int start;      // Row where the run started
+    int best_end;   // Row of the peak
+    int diagonal;   // i - k, constant along the run
+};
+
+template<class Traits, class Policy = FloatPolicy>
+float msv_kernel_segments(const DigitalResidue* digital_sequence, int sequence_length,
+                          const MatchScoreTable<Traits::K, Policy>& table,
+                          std::vector<SegmentRun<typename Policy::cell_type>>& run_buffer,
+                          int top_n, std::vector<MSVSegment>& segments)
+{
+    using cell_type = typename Policy::cell_type;
+    using Run = SegmentRun<cell_type>;
+    const int M = table.model_length;
+    const int L = sequence_length;
+    segments.clear();
+    if (L <= 0 || M <= 0) {
+        return 0.0f;
+    }
+
+    const QuantizationParams q = table.quant;
+    const Run empty = {cell_type(0), cell_type(0), 0, 0, 0};
+    run_buffer.assign(static_cast<size_t>(M) + 1, empty);
+    Run* run = run_buffer.data();
+    SegmentHeap heap(top_n);
+    cell_type max_cell = 0;
+
+    auto emit = [&](const Run& r) {
+        if (r.best > cell_type(0)) {
+            heap.offer({r.start, r.best_end, r.start - r.diagonal, r.best_end - r.diagonal, table.to_nats(r.best)});
+        }
+    };
+
+    for (int i = 1; i <= L; i++) {
+        const DigitalResidue residue = digital_sequence[i];
+        if (residue >= Traits::K) {
+            for (int k = 1; k <= M; k++) {
+                emit(run[k]);
+                run[k] = empty;
+            }
+            continue;
+        }
+
+        // k descending: run[k-1] still holds row i-1
+        const typename Policy::stored_type* s = table.row(residue);
+        cell_type row_max = 0;
+        emit(run[M]);  // Cannot extend past k = M
+        for (int k = M; k >= 1; k--) {
+            const Run& prev = run[k - 1];
+            const cell_type v = Policy::step(prev.value, s[k], q);
+            Run next = empty;
+            if (v == cell_type(0)) {
+                emit(prev);
+            } else if (prev.value == cell_type(0)) {
+                next = {v, v, i, i, i - k};
+            } else {
+                next = prev;
+                next.value = v;
+                if (v > prev.best) {
+                    next.best = v;
+                    next.best_end = i;
+                }
+            }
+            run[k] = next;
+            row_max = std::max(row_max, v);
+        }
+        run[0] = empty;
+        if (Policy::overflows(row_max, q)) {
+            segments = heap.sorted();
+            return eslINFINITY;
+        }
+        max_cell = std::max(max_cell, row_max);
+    }
+
+    for (int k = 1; k <= M; k++) {
+        emit(run[k]);
+    }
+    segments = heap.sorted();
+    return table.to_nats(max_cell);
+}
+
+#endif // MSV_FILTER_MSV_SEGMENTS_HPP
@@ -0,0 +1,109 @@
+/*******************************************************************************
+ * File: include/msv_stream.hpp
+ * Description: Resumable MSV state for sequences that arrive in chunks.
+ *
+ * Streaming sources (basecaller output, translated reads, sockets) deliver
+ * residues a few at a time. MSVStream keeps everything the recurrence of
+ * msv_kernel needs between chunks: the current DP row, the number of
+ * residues consumed, the running maximum and the saturation flag. Each
+ * feed() continues exactly where the previous one stopped, so the score of
+ * the prefix seen so far is available at any point and a finished stream
+ * has the same score as msv_kernel over the whole sequence.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_MSV_STREAM_HPP
+#define MSV_FILTER_MSV_STREAM_HPP
+
+#include <algorithm>
+#include <vector>
+#include "hmmer_types.hpp"
+#include "msv_kernel.hpp"
+
+/*******************************************************************************
+ * MSVStream<Traits, Policy>
+ *
+ * The table must outlive the stream. A single row is enough: updating k from
+ * M down to 1 reads row[k-1] before it is overwritten. Streams are cheap
+ * (one row of M+1 cells); use one per concurrent read.
+ ******************************************************************************/
+
+template<class Traits, class Policy = FloatPolicy>
+class MSVStream {
+public:
+    using cell_type = typename Policy::cell_type;
+    using table_type = MatchScoreTable<Traits::K, Policy>;
+
+    explicit MSVStream(const table_type& table)
+        : table_(table), row_(static_cast<size_t>(table.model_length) + 1, cell_type(0)) {}
+
+    // Consume n residues (no sentinels needed; a sentinel or any code >= K
+    // in the chunk resets the row like any non-canonical residue)
+    void feed(const DigitalResidue* residues, int n) {
+        const int M = table_.model_length;
+        if (n <= 0) {
+            return;
+        }
+        position_ += n;
+        if (overflowed_ || M <= 0) {
+            return;  // Score is already final (+inf) or trivially 0
+        }
+
+        const QuantizationParams q = table_.quant;
+        cell_type* row = row_.data();
+        for (int j = 0; j < n; j++) {
+            const DigitalResidue residue = residues[j];
+            if (residue >= Traits::K) {
+                std::fill(row + 1, row + M + 1, cell_type(0));
+                continue;
+            }
+            const typename Policy::stored_type* s = table_.row(residue);
+            cell_type row_max = 0;
+            for (int k = M; k >= 1; k--) {
+                const cell_type v = Policy::step(row[k - 1], s[k], q);
+                row[k] = v;
+                row_max = std::max(row_max, v);
+            }
+            if (Policy::overflows(row_max, q)) {
+                overflowed_ = true;
+                return;
+            }
+            max_cell_ = std::max(max_cell_, row_max);
+        }
+    }
+
+    // Score of the residues fed so far, in nats (+inf after saturation)
+    float score() const {
+        return overflowed_ ? eslINFINITY : table_.to_nats(max_cell_);
+    }
+
+    // Residues consumed since construction or the last reset()
+    long position() const {
+        return position_;
+    }
+
+    bool overflowed() const {
+        return overflowed_;
+    }
+
+    // Start a new sequence against the same table
+    void reset() {
+        std::fill(row_.begin(), row_.end(), cell_type(0));
+        max_cell_ = 0;
+        position_ = 0;
+        overflowed_ = false;
+    }
+
+private:
+    const table_type& table_;
+    std::vector<cell_type> row_;  // dp[i][0..M] for the last residue i
+    cell_type max_cell_ = 0;
+    long position_ = 0;
+    bool overflowed_ = false;
+};
+
+template<class Policy = FloatPolicy>
+using AminoMSVStream = MSVStream<AminoTraits, Policy>;
+template<class Policy = FloatPolicy>
+using NucleotideMSVStream = MSVStream<NucleotideTraits, Policy>;
+
+#endif // MSV_FILTER_MSV_STREAM_HPP
@@ -0,0 +1,138 @@
+/*******************************************************************************
+ * File: include/multi_search.hpp
+ * Description: Many profiles against one resident sequence database in a
+ * single pass over memory.
+ *
+ * Running a profile library one profile at a time streams the whole
+ * database once per profile. MultiProfileSearch instead tiles profiles x
+ * sequence blocks:
+ *
+ *   for each block of the database (one pool task, ~chunk_residues)
+ *     for each profile tile (profiles whose score tables fit in tile_bytes)
+ *       for each sequence in the block
+ *         for each profile in the tile: Pipeline::run()
+ *
+ * so every database block is read from memory once, the tile's score
+ * tables stay in L2 while the block's sequences go past, and each
+ * sequence is scored by the whole tile while it sits in L1. By default a
+ * tile gets half of L2 and the block shares the rest.
+ *
+ * A profile's share of the tile is every score table its pipeline reads:
+ * the uint8 SSV and float seed tables, the striped Viterbi profile, and
+ * the profile's own emission and transition scores (MSV, banded Viterbi,
+ * Forward). SSV alone is K x (M+1) bytes, but survivors pull in the rest,
+ * over ten times more, and counting only SSV would pack tiles that thrash L2
+ * as soon as a block holds a few hits. DP scratch is per worker and shared
+ * by all profiles, so it is not counted.
+ *
+ * The score tables of every profile (a PipelineProfile) are built once in
+ * the constructor and shared read-only by all workers. Each pool worker
+ * owns only DP scratch, its RunStats, and a lightweight Pipeline per
+ * profile binding the two, so memory grows with profiles + workers, and
+ * searches allocate no score tables and take no locks on the hot path.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_MULTI_SEARCH_HPP
+#define MSV_FILTER_MULTI_SEARCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "pipeline.hpp"
+#include "profile.hpp"
+#include "run_stats.hpp"
+#include "sequence_db.hpp"
+#include "thread_pool.hpp"
+
+struct MultiSearchConfig {
+    PipelineConfig pipeline;
+    int num_threads = 0;               // Pool workers; 0 = hardware concurrency
+    int64_t chunk_residues = 1 << 18;  // Residues per database block (one pool task)
+    size_t tile_bytes = 0;             // Profile tile budget; 0 = half of L2
+};
+
+struct SearchHit {
+    int sequence;        // Database index
+    float bits;          // Forward score
+    double pvalue;
+    double evalue;
+};
+
+struct SearchResult {
+    std::vector<SearchHit> hits;  // Sorted by P-value
+    int sequences = 0;            // Database sequences scored
+    double milliseconds = 0.0;    // Wall time of the database pass
+    int batch_profiles = 1;       // Profiles scored in the same pass
+};
+
+// L2 data cache size of this machine (1 MiB if the system does not say)
+size_t l2_cache_bytes();
+
+// Score tables one profile's pipeline reads, the unit tiles are sized in
+size_t profile_tile_bytes(const PipelineProfile& tables);
+
+// Split `profiles` (indices into a library whose profiles take
+// `profile_bytes` each), in order, into consecutive tiles of at most
+// `tile_bytes` each. Tiles hold positions in `profiles`, so duplicates keep
+// separate slots; a profile larger than the budget gets a tile of its own.
+std::vector<std::vector<int>> make_profile_tiles(const std::vector<size_t>& profile_bytes,
+                                                 const std::vector<int>& profiles, size_t tile_bytes);
+
+class MultiProfileSearch {
+public:
+    // `db` and `profiles` must outlive the search
+    MultiProfileSearch(const SequenceDatabase& db, const std::vector<HMMProfile>& profiles,
+                       const MultiSearchConfig& config);
+
+    MultiProfileSearch(const MultiProfileSearch&) = delete;
+    MultiProfileSearch& operator=(const MultiProfileSearch&) = delete;
+
+    // One pass over the database for all of `profiles` (indices into the
+    // library; duplicates are scored again). One result per entry, in
+    // order. Safe to call from several threads at once. Throws
+    // std::out_of_range for an index outside the library.
+    std::vector<SearchResult> search(const std::vector<int>& profiles);
+
+    // Every profile in the library
+    std::vector<SearchResult> search_all();
+
+    // Merge the workers' per-stage statistics into `run`. Not synchronized
+    // with search(); call it between searches.
+    void collect_stats(RunStats& run) const;
+
+    size_t tile_bytes() const {
+        return tile_bytes_;
+    }
+
+    // profile_tile_bytes() of each library profile
+    const std::vector<size_t>& profile_bytes() const {
+        return profile_bytes_;
+    }
+
+    int num_threads() const {
+        return pool_.size();
+    }
+
+    const std::vector<SequenceRange>& blocks() const {
+        return blocks_;
+    }
+
+private:
+    struct WorkerState {
+        RunStats stats;
+        PipelineScratch scratch;                           // Shared by the worker's pipelines
+        std::vector<std::unique_ptr<Pipeline>> pipelines;  // One per library profile, over tables_
+    };
+
+    const SequenceDatabase& db_;
+    const std::vector<HMMProfile>& profiles_;
+    std::vector<std::unique_ptr<PipelineProfile>> tables_;  // One per library profile
+    std::vector<size_t> profile_bytes_;
+    size_t tile_bytes_;
+    std::vector<SequenceRange> blocks_;
+    std::vector<std::unique_ptr<WorkerState>> workers_;
+    ThreadPool pool_;
+};
+
+#endif // MSV_FILTER_MULTI_SEARCH_HPP
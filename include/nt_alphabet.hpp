@@ -0,0 +1,79 @@
+/*******************************************************************************
+ * File: include/nt_alphabet.hpp
+ * Description: Nucleotide (DNA/RNA) digital alphabet and 2-bit packed
+ * sequence storage.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_NT_ALPHABET_HPP
+#define MSV_FILTER_NT_ALPHABET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "alphabet.hpp"
+
+/*******************************************************************************
+ * NucleotideAlphabet (eslDNA / eslRNA)
+ *
+ * K = 4 canonical bases, Kp = 18 symbols as in Easel:
+ *   DNA: "ACGT-RYMKSWHBVDN*~"
+ *   RNA: "ACGU-RYMKSWHBVDN*~"
+ * IUPAC degeneracy codes map to their base sets (R = A|G, ..., N = any).
+ * Input is case-insensitive, and U/T are accepted interchangeably.
+ ******************************************************************************/
+
+struct NucleotideAlphabet : DigitalAlphabet {
+    explicit NucleotideAlphabet(bool rna = false);
+};
+
+/*******************************************************************************
+ * PackedNucleotideSequence
+ *
+ * 2-bit packed storage for nucleotide sequences made only of canonical
+ * bases (digital codes 0..3). 32 residues per 64-bit word, residue i
+ * (1-indexed) at word (i-1)/32, bits 2*((i-1)%32). A sequence containing a
+ * degenerate code (N, R, ...), a gap or an illegal symbol cannot be packed
+ * and stays in byte-per-residue DigitalResidue form.
+ ******************************************************************************/
+
+class PackedNucleotideSequence {
+public:
+    static constexpr int RESIDUES_PER_WORD = 32;
+
+    PackedNucleotideSequence() : length_(0) {}
+
+    // True if every residue 1..L is a canonical base
+    static bool packable(const DigitalResidue* digital_sequence, int sequence_length);
+
+    // Pack residues 1..L of a sentinel-framed digital sequence. Returns false
+    // (and leaves the object empty) if the sequence is not packable.
+    bool pack(const DigitalResidue* digital_sequence, int sequence_length);
+
+    // Residue i, 1-indexed
+    DigitalResidue at(int i) const {
+        const int idx = i - 1;
+        return static_cast<DigitalResidue>((words_[idx / RESIDUES_PER_WORD] >> (2 * (idx % RESIDUES_PER_WORD))) & 3u);
+    }
+
+    // Expand back into a sentinel-framed digital sequence
+    std::vector<DigitalResidue> unpack() const;
+
+    int length() const {
+        return length_;
+    }
+
+    const std::vector<uint64_t>& words() const {
+        return words_;
+    }
+
+    // Storage footprint in bytes (vs. length()+2 unpacked)
+    size_t bytes() const {
+        return words_.size() * sizeof(uint64_t);
+    }
+
+private:
+    std::vector<uint64_t> words_;
+    int length_;
+};
+
+#endif // MSV_FILTER_NT_ALPHABET_HPP
@@ -0,0 +1,29 @@
+/*******************************************************************************
+ * File: include/nt_msv.hpp
+ * Description: MSV kernel specialized for 2-bit packed nucleotide sequences.
+ *
+ * With K = 4 the kernel needs only four match-score rows, small enough to
+ * stay resident next to the DP rows, and the residue stream is decoded
+ * straight out of the packed 64-bit words without unpacking the sequence.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_NT_MSV_HPP
+#define MSV_FILTER_NT_MSV_HPP
+
+#include <vector>
+#include "hmmer_types.hpp"
+#include "profile.hpp"
+#include "nt_alphabet.hpp"
+#include "msv_kernel.hpp"
+
+// Four residue-major match-score rows (see MatchScoreTable in msv_kernel.hpp).
+// Built once per profile and shared read-only between threads.
+using NucleotideScoreRows = NucleotideScoreTable;
+
+// Ungapped MSV score of a packed sequence; same recurrence and result as
+// compute_msv on the unpacked sequence. `row_buffer` is scratch space the
+// caller can reuse across calls (resized as needed).
+float compute_msv_packed(const PackedNucleotideSequence& sequence, const NucleotideScoreRows& scores,
+                         std::vector<float>& row_buffer);
+
+#endif // MSV_FILTER_NT_MSV_HPP
@@ -0,0 +1,151 @@
+/*******************************************************************************
+ * File: include/packed_stream.hpp
+ * Description: Many short sequences packed into one sentinel-separated
+ * stream, scored by a single kernel run.
+ *
+ * Fragment-heavy databases (peptides, reads of 30-80 aa) spend most of their
+ * time per call rather than per cell: row allocation and clearing, table
+ * setup and the kernel's entry and exit, for a few dozen rows each.
+ * PackedSequenceStream lays the sequences back to back with one
+ * digitalResidueSentinel between neighbours:
+ *   [S] x1..xL1 [S] y1..yL2 [S] ... [S]
+ * so every member is still a valid sentinel-framed digital sequence (the
+ * sentinels are shared), and msv_kernel_packed() walks the whole stream in
+ * one long loop. A sentinel closes the current sequence's score and resets
+ * the row; other non-canonical codes reset the row as usual.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_PACKED_STREAM_HPP
+#define MSV_FILTER_PACKED_STREAM_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "hmmer_types.hpp"
+#include "msv_kernel.hpp"
+
+class PackedSequenceStream {
+public:
+    PackedSequenceStream() {
+        clear();
+    }
+
+    // Drop all members, keeping the allocation
+    void clear() {
+        residues_.assign(1, digitalResidueSentinel);
+        starts_.clear();
+    }
+
+    void reserve(size_t sequences, size_t residues) {
+        starts_.reserve(sequences);
+        residues_.reserve(residues + sequences + 1);
+    }
+
+    // Append residues digital_sequence[1..L]; returns the member's index
+    int add(const DigitalResidue* digital_sequence, int sequence_length) {
+        starts_.push_back(residues_.size() - 1);
+        residues_.insert(residues_.end(), digital_sequence + 1, digital_sequence + 1 + std::max(0, sequence_length));
+        residues_.push_back(digitalResidueSentinel);
+        return static_cast<int>(starts_.size()) - 1;
+    }
+
+    int size() const {
+        return static_cast<int>(starts_.size());
+    }
+
+    int length(int s) const {
+        const size_t end = static_cast<size_t>(s) + 1 < starts_.size() ? starts_[s + 1] : residues_.size() - 1;
+        return static_cast<int>(end - starts_[s] - 1);
+    }
+
+    // Member s as a framed digital sequence: [S] residues 1..length(s) [S]
+    const DigitalResidue* sequence(int s) const {
+        return residues_.data() + starts_[s];
+    }
+
+    // The whole stream; positions 0 and stream_length() + 1 are sentinels
+    const DigitalResidue* data() const {
+        return residues_.data();
+    }
+
+    // Residues plus inner sentinels between the two outer ones
+    int64_t stream_length() const {
+        return static_cast<int64_t>(residues_.size()) - 2;
+    }
+
+private:
+    std::vector<DigitalResidue> residues_;
+    std::vector<size_t> starts_;  // Offset of the sentinel before each member
+};
+
+/*******************************************************************************
+ * msv_kernel_packed<Traits, Policy>
+ *
+ * scores[s] = msv_kernel() of member s, for every member, in one pass. An
+ * integer policy that saturates inside a member gives that member +inf and
+ * skips to the next one, as msv_kernel() returns early.
+ ******************************************************************************/
+
+// cur[k] = step(prev[k-1], s[k]) for k = 1..M
+template<class Policy>
+inline void row_step(const typename Policy::cell_type* __restrict prev, typename Policy::cell_type* __restrict cur,
+                     const typename Policy::stored_type* __restrict s, int M, const QuantizationParams& q) {
+    for (int k = 1; k <= M; k++) {
+        cur[k] = Policy::step(prev[k - 1], s[k], q);
+    }
+}
+
+template<class Traits, class Policy = FloatPolicy>
+void msv_kernel_packed(const PackedSequenceStream& stream, const MatchScoreTable<Traits::K, Policy>& table,
+                       std::vector<typename Policy::cell_type>& row_buffer, std::vector<float>& scores)
+{
+    using cell_type = typename Policy::cell_type;
+    const int M = table.model_length;
+    const int n = stream.size();
+    scores.assign(n, 0.0f);
+    if (M <= 0 || n == 0) {
+        return;
+    }
+
+    const QuantizationParams q = table.quant;
+    row_buffer.assign(2 * (static_cast<size_t>(M) + 1), cell_type(0));
+    cell_type* prev = row_buffer.data();
+    cell_type* cur = prev + (M + 1);
+    const DigitalResidue* dsq = stream.data();
+    const int64_t end = stream.stream_length() + 1;  // Final sentinel
+    cell_type max_cell = 0;
+    int s = 0;
+
+    for (int64_t i = 1; i <= end; i++) {
+        const DigitalResidue residue = dsq[i];
+        if (residue >= Traits::K) {
+            std::fill(prev + 1, prev + M + 1, cell_type(0));
+            if (residue == digitalResidueSentinel) {
+                scores[s++] = table.to_nats(max_cell);
+                max_cell = 0;
+            }
+            continue;
+        }
+
+        // Two rows and separate step and max loops: with no aliasing between
+        // prev and cur both loops vectorize across k, at full width for the
+        // whole stream rather than for a few dozen rows per call
+        row_step<Policy>(prev, cur, table.row(residue), M, q);
+        const cell_type row_max = *std::max_element(cur + 1, cur + M + 1);
+        std::swap(prev, cur);
+        if (Policy::overflows(row_max, q)) {
+            // Rest of this member cannot change its score
+            scores[s] = eslINFINITY;
+            const int64_t next = s + 1 < n ? stream.sequence(s + 1) - dsq : end;
+            std::fill(prev + 1, prev + M + 1, cell_type(0));
+            max_cell = 0;
+            s++;
+            i = next;
+            continue;
+        }
+        max_cell = std::max(max_cell, row_max);
+    }
+}
+
+#endif // MSV_FILTER_PACKED_STREAM_HPP
@@ -0,0 +1,168 @@
+/*******************************************************************************
+ * File: include/perf_counters.hpp
+ * Description: Optional hardware performance counters around MSV kernels.
+ *
+ * On Linux, PerfCounterGroup opens perf_event_open() counters for the
+ * calling thread: cycles, instructions, L1D read misses, LLC misses and
+ * branch misses. KernelPerfRegistry aggregates samples per kernel and per
+ * power-of-two M/L bucket and prints IPC, misses per kilo-instruction and
+ * cycles per DP cell. This shows whether a kernel is compute-bound (high
+ * IPC, few misses) or bandwidth-bound (LLC misses dominating).
+ *
+ * Counters are best-effort: where the syscall is missing or forbidden
+ * (non-Linux, containers, perf_event_paranoid), the affected events are
+ * marked unavailable and only wall time is recorded.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_PERF_COUNTERS_HPP
+#define MSV_FILTER_PERF_COUNTERS_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <tuple>
+
+/*******************************************************************************
+ * Events and Samples
+ ******************************************************************************/
+
+enum PerfEvent {
+    PERF_CYCLES = 0,
+    PERF_INSTRUCTIONS = 1,
+    PERF_L1D_MISSES = 2,
+    PERF_LLC_MISSES = 3,
+    PERF_BRANCH_MISSES = 4
+};
+constexpr int PERF_NUM_EVENTS = 5;
+
+// Counter deltas for one measured region
+struct PerfSample {
+    std::array<uint64_t, PERF_NUM_EVENTS> counts{};
+    std::array<bool, PERF_NUM_EVENTS> valid{};
+    double seconds = 0.0;
+};
+
+/*******************************************************************************
+ * PerfCounterGroup
+ *
+ * Counters for the calling thread only; create one per worker thread.
+ * Multiplexed counters are scaled by time_enabled / time_running.
+ ******************************************************************************/
+
+class PerfCounterGroup {
+public:
+    PerfCounterGroup();
+    ~PerfCounterGroup();
+
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+    // True if at least one hardware event could be opened
+    bool available() const;
+
+    bool event_available(int event) const {
+        return fds_[event] >= 0;
+    }
+
+    static const char* event_name(int event);
+
+    void start();
+    PerfSample stop();
+
+private:
+    struct Reading {
+        uint64_t value;
+        uint64_t enabled;
+        uint64_t running;
+    };
+
+    bool read_event(int event, Reading& out) const;
+
+    std::array<int, PERF_NUM_EVENTS> fds_;
+    std::array<Reading, PERF_NUM_EVENTS> begin_{};
+    std::chrono::steady_clock::time_point begin_time_;
+};
+
+/*******************************************************************************
+ * KernelPerfRegistry
+ *
+ * Thread-safe accumulation of samples keyed by (kernel, M bucket, L bucket).
+ * Buckets are powers of two: a model of length 100 lands in "M<=128".
+ ******************************************************************************/
+
+class KernelPerfRegistry {
+public:
+    void record(const std::string& kernel, int model_length, int sequence_length, const PerfSample& sample);
+
+    // Tabular report, one line per (kernel, M bucket, L bucket)
+    void report(std::ostream& out) const;
+
+    bool empty() const;
+
+    // Calls recorded for `kernel`, summed over all buckets
+    uint64_t calls(const std::string& kernel) const;
+
+    // Smallest power of two >= n (1 for n <= 1)
+    static int bucket_of(int n);
+
+private:
+    struct Totals {
+        uint64_t calls = 0;
+        uint64_t cells = 0;
+        double seconds = 0.0;
+        std::array<uint64_t, PERF_NUM_EVENTS> counts{};
+        std::array<bool, PERF_NUM_EVENTS> valid{};
+    };
+
+    using Key = std::tuple<std::string, int, int>;
+
+    mutable std::mutex mutex_;
+    std::map<Key, Totals> totals_;
+};
+
+/*******************************************************************************
+ * ScopedPerfRegion
+ *
+ * Measures the enclosing scope and records it on destruction. A null
+ * registry (or null counters) makes the region a no-op, so call sites need
+ * no #ifdefs.
+ ******************************************************************************/
+
+class ScopedPerfRegion {
+public:
+    ScopedPerfRegion(KernelPerfRegistry* registry, PerfCounterGroup& counters, const char* kernel,
+                     int model_length, int sequence_length)
+        : ScopedPerfRegion(registry, &counters, kernel, model_length, sequence_length) {}
+
+    ScopedPerfRegion(KernelPerfRegistry* registry, PerfCounterGroup* counters, const char* kernel,
+                     int model_length, int sequence_length)
+        : registry_(counters != nullptr ? registry : nullptr), counters_(counters), kernel_(kernel),
+          model_length_(model_length), sequence_length_(sequence_length)
+    {
+        if (registry_ != nullptr) {
+            counters_->start();
+        }
+    }
+
+    ~ScopedPerfRegion() {
+        if (registry_ != nullptr) {
+            registry_->record(kernel_, model_length_, sequence_length_, counters_->stop());
+        }
+    }
+
+    ScopedPerfRegion(const ScopedPerfRegion&) = delete;
+    ScopedPerfRegion& operator=(const ScopedPerfRegion&) = delete;
+
+private:
+    KernelPerfRegistry* registry_;
+    PerfCounterGroup* counters_;
+    const char* kernel_;
+    int model_length_;
+    int sequence_length_;
+};
+
+#endif // MSV_FILTER_PERF_COUNTERS_HPP
@@ -0,0 +1,235 @@
+/*******************************************************************************
+ * File: include/pipeline.hpp
+ * Description: The accelerated filter pipeline: SSV -> MSV -> bias ->
+ * Viterbi -> Forward, each stage gated by a P-value threshold.
+ *
+ * Modeled on p7_Pipeline() in hmmer/src/p7_pipeline.c. Every stage turns
+ * its raw score into bits against the null model and into a P-value from
+ * the profile's evparam[] (pvalue.hpp); a sequence moves on only while
+ * P <= the stage's threshold:
+ *
+ *   ssv      uint8 MSV kernel, single best segment      P <= F1 (MSV Gumbel), if do_ssv
+ *   msv      multi-hit MSV with specials                P <= F1 (MSV Gumbel)
+ *   bias     MSV re-tested against the composition      P <= F1 (MSV Gumbel)
+ *            filter null (bias_filter.hpp)
+ *   viterbi  striped 16-bit Viterbi filter              P <= F2 (Viterbi Gumbel)
+ *   forward  Forward inside the Viterbi band            P <= F3 (Forward exp. tail)
+ *
+ * The Viterbi path that sets the Forward band comes from a banded Viterbi
+ * over +/- seed_width columns around the best MSV diagonals
+ * (msv_segments.hpp, banded_dp.hpp), not from the full M x L matrix. All
+ * seed_segments diagonals are kept, so a weaker second domain stays in the
+ * band. If the banded score still falls below the striped filter's, the
+ * seeds missed the path and the Viterbi is redone in full over a
+ * checkpointed matrix (checkpoint_dp.hpp). The same full Viterbi replaces
+ * the banded one when the seed band covers more than
+ * max_seed_band_fraction of M x L (seeds on distant diagonals that share
+ * rows). A sequence with no MSV seed
+ * skips the Viterbi and runs a full Forward; its M x L matrix is freed
+ * again after sequences over max_retained_dp_bytes.
+ *
+ * With the bias filter on, the filter null score replaces the iid null
+ * score for the Viterbi and Forward stages too, as in HMMER.
+ *
+ * Optionally the sequence is first copied and SEG-masked (seg_mask.hpp), so
+ * low-complexity regions score as X in every stage; the "seg" stage in
+ * RunStats then counts masked sequences as passed and residues as cells.
+ *
+ * SSV is off by default. A prefilter only pays while it costs much less
+ * than the MSV it guards, but the portable uint8 kernel (msv_kernel.hpp)
+ * is scalar, so its narrow cells buy nothing: depending on the build it
+ * runs at half to about the speed of the float MSV, and on null sequences,
+ * which all reach MSV anyway, it nearly doubles the pipeline's cost.
+ *
+ * Integer stages that saturate report +inf and pass. Per-stage counters,
+ * residues, cells and time go into a RunStats stage of the same name.
+ * With a KernelPerfRegistry attached (perf_counters.hpp), every kernel call
+ * is also measured with hardware counters under its own kernel name.
+ *
+ * What a Pipeline derives from its profile (length parameters, score
+ * tables, the striped Viterbi profile, bias filter) is a PipelineProfile,
+ * read-only once built; its DP buffers are a PipelineScratch. Searches
+ * over many threads build one PipelineProfile per profile and one
+ * PipelineScratch per thread, and bind them with lightweight Pipelines, so
+ * memory grows with profiles + threads rather than profiles x threads.
+ *
+ * A Pipeline is not thread-safe; use one per thread, each with its own
+ * RunStats (and scratch), and merge the stages at the end.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_PIPELINE_HPP
+#define MSV_FILTER_PIPELINE_HPP
+
+#include <array>
+#include <memory>
+#include <vector>
+#include "hmmer_types.hpp"
+#include "profile.hpp"
+#include "dp_matrix.hpp"
+#include "length_config.hpp"
+#include "bias_filter.hpp"
+#include "banded_dp.hpp"
+#include "checkpoint_dp.hpp"
+#include "msv_kernel.hpp"
+#include "msv_segments.hpp"
+#include "perf_counters.hpp"
+#include "seg_mask.hpp"
+#include "viterbi_filter.hpp"
+#include "run_stats.hpp"
+
+/*******************************************************************************
+ * Configuration
+ ******************************************************************************/
+
+struct PipelineConfig {
+    double F1 = 0.02;   // MSV (and SSV, bias) P-value threshold
+    double F2 = 1e-3;   // Viterbi P-value threshold
+    double F3 = 1e-5;   // Forward P-value threshold
+    bool do_ssv = false;        // Run the uint8 SSV prefilter before MSV (see below)
+    bool do_biasfilter = true;  // Re-test MSV survivors against the composition null
+    float expected_hit_count = 2.0f;
+    int band_margin = 8;        // Forward in the Viterbi band +/- margin; < 0 runs full Forward
+    int seed_segments = 4;      // MSV diagonals seeding the banded Viterbi
+    int seed_width = 16;        // Columns either side of each seed diagonal
+    double max_seed_band_fraction = 0.5;  // Wider seed band (share of M x L): full Viterbi instead
+    size_t max_retained_dp_bytes = size_t(64) << 20;  // Full Forward matrix kept between sequences
+    bool do_seg_mask = false;   // Mask low-complexity regions to X before SSV
+    SegMaskConfig seg;
+
+    // Used when the profile is uncalibrated (an evparam lambda <= 0):
+    // typical STATS LOCAL values of a hmmbuild-calibrated model
+    std::array<float, p7_NEVPARAM> fallback_evparam = {-9.5f, eslCONST_LOG2, -10.0f, eslCONST_LOG2,
+                                                       -4.5f, eslCONST_LOG2};
+};
+
+/*******************************************************************************
+ * Per-Sequence Result
+ ******************************************************************************/
+
+enum PipelineStage {
+    STAGE_SSV = 0,
+    STAGE_MSV,
+    STAGE_BIAS,
+    STAGE_VITERBI,
+    STAGE_FORWARD,
+    NUM_PIPELINE_STAGES
+};
+
+struct PipelineResult {
+    bool passed = false;         // Survived every enabled stage
+    int rejected_at = -1;        // PipelineStage that rejected the sequence, -1 if passed
+    float null_score = 0.0f;     // iid null score (nats)
+    float filter_score = 0.0f;   // Null score the later stages used (nats)
+    float msv_bits = -eslINFINITY;
+    float viterbi_bits = -eslINFINITY;
+    float forward_bits = -eslINFINITY;
+    double pvalue = 1.0;         // P-value at the last stage reached
+    int masked_residues = 0;     // Residues remapped to X by SEG masking
+    bool full_viterbi = false;   // Seeded band scored below the filter; Viterbi redone in full
+};
+
+/*******************************************************************************
+ * PipelineProfile
+ *
+ * Everything the stages derive from one profile and configuration. Built
+ * once and never modified, so any number of Pipelines on any threads can
+ * share it; `profile` must outlive it.
+ ******************************************************************************/
+
+struct PipelineProfile {
+    const HMMProfile& profile;
+    PipelineConfig config;
+    std::array<float, p7_NEVPARAM> evparam;  // The profile's, or config.fallback_evparam if uncalibrated
+
+    LengthConfigCache length_config;
+    AminoScoreTableT<Uint8Policy> ssv_table;
+    AminoScoreTable seed_table;
+    ViterbiWordProfile viterbi_profile;
+    BiasFilter bias_filter;
+    SegMasker seg_masker;
+
+    // Amino profiles only (the SSV stage is the K=20 uint8 kernel)
+    PipelineProfile(const HMMProfile& profile, const PipelineConfig& config);
+
+    PipelineProfile(const PipelineProfile&) = delete;
+    PipelineProfile& operator=(const PipelineProfile&) = delete;
+};
+
+/*******************************************************************************
+ * PipelineScratch
+ *
+ * DP buffers for one thread. They are resized per call, so one scratch
+ * serves pipelines of any model length, one at a time.
+ ******************************************************************************/
+
+struct PipelineScratch {
+    std::vector<DigitalResidue> seg_sequence;
+    std::vector<float> seg_entropy;
+    std::vector<uint8_t> ssv_buffer;
+    std::vector<float> msv_buffer;
+    std::vector<WordVector> viterbi_buffer;
+    std::vector<SegmentRun<float>> seed_runs;
+    std::vector<MSVSegment> seeds;
+    BandedDPMatrix banded_matrix;
+    CheckpointedDPMatrix checkpoint_matrix;  // Viterbi when the seeds miss
+    DPMatrix dp_matrix{0, 0};                // Full Forward only (band_margin < 0 or no seed)
+};
+
+/*******************************************************************************
+ * Pipeline
+ ******************************************************************************/
+
+class Pipeline {
+public:
+    static constexpr const char* STAGE_NAMES[NUM_PIPELINE_STAGES] = {"ssv", "msv", "bias", "viterbi", "forward"};
+
+    // Self-contained: builds its own tables and scratch. Stages are
+    // registered in `stats` in pipeline order; disabled ones are skipped.
+    Pipeline(const HMMProfile& profile, const PipelineConfig& config, RunStats& stats);
+
+    // Over shared tables and a thread's scratch, both of which must outlive
+    // the pipeline
+    Pipeline(const PipelineProfile& tables, PipelineScratch& scratch, RunStats& stats);
+
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    // Run one sentinel-framed digital sequence through the stages
+    PipelineResult run(const DigitalResidue* digital_sequence, int sequence_length);
+
+    const PipelineConfig& config() const {
+        return tables_.config;
+    }
+
+    const PipelineProfile& tables() const {
+        return tables_;
+    }
+
+    // E-value parameters in use (the profile's, or the fallback)
+    float evparam(int index) const {
+        return tables_.evparam[index];
+    }
+
+    const BiasFilter& bias_filter() const {
+        return tables_.bias_filter;
+    }
+
+    // Measure each kernel call into `registry` (null detaches). Counters are
+    // opened for the calling thread, so attach from the thread that runs.
+    void set_perf_registry(KernelPerfRegistry* registry);
+
+private:
+    Pipeline(std::unique_ptr<PipelineProfile> tables, std::unique_ptr<PipelineScratch> scratch, RunStats& stats);
+
+    std::unique_ptr<PipelineProfile> owned_tables_;    // Self-contained pipelines only
+    std::unique_ptr<PipelineScratch> owned_scratch_;
+    const PipelineProfile& tables_;
+    PipelineScratch& scratch_;
+    RunStats& stats_;
+    StageStats* stage_[NUM_PIPELINE_STAGES] = {};
+    StageStats* seg_stage_ = nullptr;
+    KernelPerfRegistry* perf_registry_ = nullptr;
+    std::unique_ptr<PerfCounterGroup> perf_counters_;
+};
+
+#endif // MSV_FILTER_PIPELINE_HPP
@@ -51,13 +51,13 @@ public:
     float compo[p7_MAXABET];     // Per-model composition
     
     // --- Alphabet Reference ---
-    const AminoAcidAlphabet* abc;
+    const DigitalAlphabet* abc;
     
     // --- Metadata (simplified for mocking) ---
     std::string name;
     
     // --- Constructor ---
-    HMMProfile(int model_length, const AminoAcidAlphabet* alphabet)
+    HMMProfile(int model_length, const DigitalAlphabet* alphabet)
         : allocM(model_length), abc(alphabet)
     {
         // Initialize scalars
@@ -123,6 +123,10 @@ public:
     inline float& insert_score(int k, int residue_idx) {
         return rsc[residue_idx][(k * p7P_NR) + p7P_ISC];
     }
+    
+    inline float insert_score(int k, int residue_idx) const {
+        return rsc[residue_idx][(k * p7P_NR) + p7P_ISC];
+    }
 };
 
 #endif // MSV_FILTER_PROFILE_HPP
@@ -0,0 +1,51 @@
+/*******************************************************************************
+ * File: include/pvalue.hpp
+ * Description: Null-model scores and score distribution tails for the
+ * filter pipeline.
+ *
+ * HMMER converts every raw (nats) stage score to a bit score against the
+ * null model and then to a P-value: MSV and Viterbi scores follow a Gumbel
+ * with the profile's evparam[p7_MMU/p7_MLAMBDA] and [p7_VMU/p7_VLAMBDA],
+ * Forward scores an exponential tail with evparam[p7_FTAU/p7_FLAMBDA].
+ * These replicate esl_gumbel_surv(), esl_exp_surv() and p7_bg_NullOne().
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_PVALUE_HPP
+#define MSV_FILTER_PVALUE_HPP
+
+#include <cmath>
+#include "hmmer_types.hpp"
+
+// P(S > x) for a Gumbel with location mu and scale lambda (esl_gumbel_surv)
+inline double gumbel_survival(double x, double mu, double lambda) {
+    const double y = lambda * (x - mu);
+    const double ey = -std::exp(-y);
+    // 1 - e^ey ~ -ey when e^-y is tiny
+    if (std::fabs(ey) < 5e-9) {
+        return -ey;
+    }
+    return 1.0 - std::exp(ey);
+}
+
+// P(S > x) for an exponential tail starting at mu (esl_exp_surv)
+inline double exponential_survival(double x, double mu, double lambda) {
+    if (x < mu) {
+        return 1.0;
+    }
+    return std::exp(-lambda * (x - mu));
+}
+
+// Null model log-likelihood of a length-L sequence in nats, scores being
+// log-odds against the background (p7_bg_NullOne with p1 = L/(L+1))
+inline float null_one_score(int sequence_length) {
+    const float L = static_cast<float>(sequence_length);
+    const float p1 = L / (L + 1.0f);
+    return L * std::log(p1) + std::log(1.0f - p1);
+}
+
+// Raw score minus null score, in bits
+inline float bit_score(float raw_nats, float null_nats) {
+    return (raw_nats - null_nats) / eslCONST_LOG2;
+}
+
+#endif // MSV_FILTER_PVALUE_HPP
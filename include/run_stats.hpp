@@ -0,0 +1,131 @@
+/*******************************************************************************
+ * File: include/run_stats.hpp
+ * Description: Machine-readable statistics for a search run.
+ *
+ * RunStats collects what a scheduler needs for capacity planning: sequences
+ * and residues processed, DP cells and GCUPS per filter stage, how many
+ * sequences passed each stage's threshold, wall and CPU time, and peak RSS.
+ * write_json() emits one self-contained JSON object.
+ *
+ * RunStats is not synchronized. Multi-threaded callers keep one StageStats
+ * per worker and merge() them into the run at the end.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_RUN_STATS_HPP
+#define MSV_FILTER_RUN_STATS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*******************************************************************************
+ * StageStats: one filter stage (SSV, MSV, Viterbi, ...)
+ ******************************************************************************/
+
+struct StageStats {
+    std::string name;
+    double threshold = 0.0;          // Pass threshold (score or P-value)
+    std::string threshold_kind;      // "score", "pvalue" or "" if none
+    uint64_t sequences_in = 0;       // Sequences that reached this stage
+    uint64_t sequences_passed = 0;   // Sequences that passed its threshold
+    uint64_t residues = 0;           // Residues scored by this stage
+    uint64_t cells = 0;              // DP cells computed (M * L per sequence, the band's, or L for bias)
+    double seconds = 0.0;            // Time spent in the stage
+
+    double pass_rate() const {
+        return sequences_in > 0 ? static_cast<double>(sequences_passed) / static_cast<double>(sequences_in) : 0.0;
+    }
+
+    // Giga cell updates per second
+    double gcups() const {
+        return seconds > 0.0 ? static_cast<double>(cells) / seconds / 1e9 : 0.0;
+    }
+
+    // Account one sequence of length L against a model of length M
+    void add(int model_length, int sequence_length, bool passed, double elapsed) {
+        add_cells(static_cast<uint64_t>(model_length) * static_cast<uint64_t>(sequence_length), sequence_length,
+                  passed, elapsed);
+    }
+
+    // Account one sequence of length L that took `computed` DP cells (a
+    // banded stage covers fewer than M * L)
+    void add_cells(uint64_t computed, int sequence_length, bool passed, double elapsed) {
+        sequences_in++;
+        sequences_passed += passed ? 1 : 0;
+        residues += static_cast<uint64_t>(sequence_length);
+        cells += computed;
+        seconds += elapsed;
+    }
+
+    void merge(const StageStats& other) {
+        sequences_in += other.sequences_in;
+        sequences_passed += other.sequences_passed;
+        residues += other.residues;
+        cells += other.cells;
+        seconds += other.seconds;
+    }
+};
+
+/*******************************************************************************
+ * RunStats: a whole run
+ ******************************************************************************/
+
+class RunStats {
+public:
+    // Starts the wall and CPU clocks
+    RunStats();
+
+    // Stage by name, created on first use; stages keep first-use order and
+    // references stay valid as more stages are added
+    StageStats& stage(const std::string& name);
+
+    const std::deque<StageStats>& stages() const {
+        return stages_;
+    }
+
+    // Input accounting (sequences read, before any filtering)
+    void add_input(uint64_t sequences, uint64_t residues) {
+        sequences_ += sequences;
+        residues_ += residues;
+    }
+
+    // Top-level string field; setting a key again replaces its value
+    void set_label(const std::string& key, const std::string& value);
+
+    // Stops the clocks and samples peak RSS; called again it re-samples
+    void finish();
+
+    double wall_seconds() const {
+        return wall_seconds_;
+    }
+
+    double cpu_seconds() const {
+        return cpu_seconds_;
+    }
+
+    uint64_t peak_rss_bytes() const {
+        return peak_rss_bytes_;
+    }
+
+    void write_json(std::ostream& out) const;
+
+    // Process CPU time (user + system) and peak resident set size
+    static double process_cpu_seconds();
+    static uint64_t process_peak_rss_bytes();
+
+private:
+    std::chrono::steady_clock::time_point wall_start_;
+    double cpu_start_;
+    double wall_seconds_ = 0.0;
+    double cpu_seconds_ = 0.0;
+    uint64_t peak_rss_bytes_ = 0;
+    uint64_t sequences_ = 0;
+    uint64_t residues_ = 0;
+    std::vector<std::pair<std::string, std::string>> labels_;
+    std::deque<StageStats> stages_;
+};
+
+#endif // MSV_FILTER_RUN_STATS_HPP
@@ -0,0 +1,182 @@
+/*******************************************************************************
+ * File: include/score_policy.hpp
+ * Description: Score-type and saturation policies for the MSV kernel family.
+ *
+ * One kernel template (msv_kernel.hpp) is instantiated with a policy that
+ * fixes the score type stored in the table, the DP cell type, how profile
+ * scores are quantized, and how cells saturate:
+ *
+ *   Unsaturated<float>         float reference, scores in nats
+ *   SignedSaturating<int16_t>  ViterbiFilter-style words, 1/500 bit units
+ *   BiasedSaturating<uint8_t>  MSV-style biased bytes, 1/3 bit units
+ *
+ * The integer policies follow HMMER's optimized profiles: a result that
+ * reaches the top of the cell range is reported as an overflow (score +inf,
+ * i.e. the sequence passes the filter), never as a wrapped value.
+ *
+ * Each policy also exposes the step without saturation, in a wide_type that
+ * cannot clip: step(prev, s) == max(0, prev + increment(s)) until the first
+ * overflow. The blocked scan (msv_scan.hpp) composes steps in that form.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_SCORE_POLICY_HPP
+#define MSV_FILTER_SCORE_POLICY_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include "hmmer_types.hpp"
+
+// Scaling shared by a quantized score table and the kernel that reads it
+struct QuantizationParams {
+    float scale = 1.0f;  // Units per nat
+    int bias = 0;        // Byte bias (BiasedSaturating only)
+};
+
+/*******************************************************************************
+ * Unsaturated<Score>: floating-point reference
+ ******************************************************************************/
+
+template<typename Score>
+struct Unsaturated {
+    using stored_type = Score;
+    using cell_type = Score;
+    static constexpr const char* name = "float";
+
+    static float default_scale() {
+        return 1.0f;
+    }
+
+    static stored_type quantize(float score, const QuantizationParams& q) {
+        return static_cast<stored_type>(score * q.scale);
+    }
+
+    // max(0, prev + s)
+    static cell_type step(cell_type prev, stored_type s, const QuantizationParams&) {
+        return std::max(static_cast<cell_type>(0), prev + s);
+    }
+
+    using wide_type = Score;
+
+    static wide_type increment(stored_type s, const QuantizationParams&) {
+        return s;
+    }
+
+    static bool overflows(cell_type, const QuantizationParams&) {
+        return false;
+    }
+
+    static float to_nats(cell_type v, const QuantizationParams& q) {
+        return static_cast<float>(v) / q.scale;
+    }
+};
+
+/*******************************************************************************
+ * SignedSaturating<Score>: signed integer cells, saturating add, floor at 0
+ ******************************************************************************/
+
+template<typename Score>
+struct SignedSaturating {
+    using stored_type = Score;
+    using cell_type = Score;
+    static constexpr const char* name = "int16";
+
+    static constexpr int LO = std::numeric_limits<Score>::min();
+    static constexpr int HI = std::numeric_limits<Score>::max();
+
+    // p7_oprofile scale_w: 1/500 bit
+    static float default_scale() {
+        return 500.0f / eslCONST_LOG2;
+    }
+
+    static stored_type quantize(float score, const QuantizationParams& q) {
+        if (std::isinf(score)) {
+            return static_cast<stored_type>(score > 0 ? HI : LO);
+        }
+        const long v = std::lround(score * q.scale);
+        return static_cast<stored_type>(std::clamp<long>(v, LO, HI));
+    }
+
+    static cell_type step(cell_type prev, stored_type s, const QuantizationParams&) {
+        const int v = static_cast<int>(prev) + static_cast<int>(s);
+        return static_cast<cell_type>(std::clamp(v, 0, HI));
+    }
+
+    using wide_type = int64_t;
+
+    static wide_type increment(stored_type s, const QuantizationParams&) {
+        return s;
+    }
+
+    static bool overflows(cell_type v, const QuantizationParams&) {
+        return static_cast<int>(v) >= HI;
+    }
+
+    static float to_nats(cell_type v, const QuantizationParams& q) {
+        return static_cast<float>(v) / q.scale;
+    }
+};
+
+/*******************************************************************************
+ * BiasedSaturating<Score>: unsigned cells with a bias, as in p7_MSVFilter
+ *
+ * The table stores costs c = bias - round(scale * s), where bias is the
+ * largest quantized match score so that every cost is >= 0. A DP step is
+ * sat_sub(sat_add(prev, bias), c), which equals max(0, prev + s) as long as
+ * prev + bias stays below the top of the range. Cells at or above
+ * HI - bias may have been clipped, so they are reported as an overflow.
+ ******************************************************************************/
+
+template<typename Score>
+struct BiasedSaturating {
+    using stored_type = Score;
+    using cell_type = Score;
+    static constexpr const char* name = "uint8";
+
+    static constexpr int HI = std::numeric_limits<Score>::max();
+
+    // p7_oprofile scale_b: 1/3 bit
+    static float default_scale() {
+        return 3.0f / eslCONST_LOG2;
+    }
+
+    // Bias for a table whose largest (finite) match score is max_score
+    static int bias_for(float max_score, float scale) {
+        return std::clamp<int>(static_cast<int>(std::lround(max_score * scale)), 0, HI);
+    }
+
+    static stored_type quantize(float score, const QuantizationParams& q) {
+        if (std::isinf(score)) {
+            return static_cast<stored_type>(score > 0 ? 0 : HI);
+        }
+        const long cost = static_cast<long>(q.bias) - std::lround(score * q.scale);
+        return static_cast<stored_type>(std::clamp<long>(cost, 0, HI));
+    }
+
+    static cell_type step(cell_type prev, stored_type cost, const QuantizationParams& q) {
+        const int biased = std::min(HI, static_cast<int>(prev) + q.bias);
+        return static_cast<cell_type>(std::max(0, biased - static_cast<int>(cost)));
+    }
+
+    using wide_type = int64_t;
+
+    static wide_type increment(stored_type cost, const QuantizationParams& q) {
+        return static_cast<wide_type>(q.bias) - cost;
+    }
+
+    static bool overflows(cell_type v, const QuantizationParams& q) {
+        return static_cast<int>(v) >= HI - q.bias;
+    }
+
+    static float to_nats(cell_type v, const QuantizationParams& q) {
+        return static_cast<float>(v) / q.scale;
+    }
+};
+
+// The three instantiations the tree uses
+using FloatPolicy = Unsaturated<float>;
+using Int16Policy = SignedSaturating<int16_t>;
+using Uint8Policy = BiasedSaturating<uint8_t>;
+
+#endif // MSV_FILTER_SCORE_POLICY_HPP
@@ -0,0 +1,161 @@
+/*******************************************************************************
+ * File: include/search_daemon.hpp
+ * Description: Long-running search service over a resident database.
+ *
+ * Modeled on hmmpgmd: the daemon loads a SequenceDatabase (sequence_db.hpp)
+ * and a profile library (hmm_file.hpp) once and keeps a MultiProfileSearch
+ * (multi_search.hpp) over them, which builds every profile's score tables
+ * once and shares them across its pool workers. Queries then run without
+ * touching disk or allocating score tables.
+ *
+ * Queries arrive on a Unix domain socket as one line each; the reply is
+ * zero or more data lines followed by a single status line:
+ *
+ *   SEARCH <profile>   HIT <rank> <sequence> <bits> <pvalue> <evalue> ...
+ *                      OK <hits> <sequences> <milliseconds> <batch>
+ *   LIST               PROFILE <name> <M> ...
+ *                      OK <profiles>
+ *   PING               OK
+ *   SHUTDOWN           OK, then the daemon stops accepting and serve() returns
+ *
+ * Failures reply "ERR <message>". A request line longer than
+ * MAX_REQUEST_LINE bytes is answered with ERR and the connection closed,
+ * so a client that never sends a newline cannot grow the daemon's buffer.
+ * Hits are the sequences that pass every
+ * pipeline stage, sorted by P-value; the E-value is P times the number of
+ * database sequences (HMMER's Z).
+ *
+ * Under load, memory bandwidth rather than arithmetic limits a database
+ * pass, so SEARCH requests are coalesced: the first query of a batch waits
+ * coalesce_window_ms for others (and for the previous batch to finish),
+ * then one pass over the database scores each chunk against every profile
+ * in the batch while the chunk is still in cache (the profile x block
+ * tiling of MultiProfileSearch). The status line's <batch> field says how
+ * many distinct profiles shared the pass.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_SEARCH_DAEMON_HPP
+#define MSV_FILTER_SEARCH_DAEMON_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "multi_search.hpp"
+#include "profile.hpp"
+#include "sequence_db.hpp"
+
+struct SearchDaemonConfig {
+    MultiSearchConfig search;        // Pipeline, pool and tiling parameters
+    int coalesce_window_ms = 5;      // How long a SEARCH waits for others; 0 = no coalescing
+};
+
+class SearchDaemon {
+public:
+    static constexpr size_t MAX_REQUEST_LINE = 4096;  // Bytes, newline excluded
+
+    // `db` and `profiles` must outlive the daemon
+    SearchDaemon(const SequenceDatabase& db, const std::vector<HMMProfile>& profiles,
+                 const SearchDaemonConfig& config);
+    ~SearchDaemon();
+
+    SearchDaemon(const SearchDaemon&) = delete;
+    SearchDaemon& operator=(const SearchDaemon&) = delete;
+
+    // Index of the profile called `name`, -1 if there is none
+    int find_profile(const std::string& name) const;
+
+    // Run profile `profile` against the whole database. Safe to call from
+    // several threads at once; their chunks share the pool.
+    SearchResult search(int profile);
+
+    // Run several profiles in one database pass (MultiProfileSearch::search)
+    std::vector<SearchResult> search(const std::vector<int>& profiles) {
+        return engine_.search(profiles);
+    }
+
+    // search(profile), batched with the other queries that arrive within
+    // the coalescing window. What SEARCH requests use. If the batch's pass
+    // throws, every query in the batch rethrows its exception and later
+    // batches run as usual.
+    SearchResult search_coalesced(int profile);
+
+    // Bind and listen on a Unix socket at `socket_path` (an existing socket
+    // file there is replaced)
+    bool listen(const std::string& socket_path, std::string& error);
+
+    // Accept connections until SHUTDOWN or stop(); one thread per open
+    // connection, joined as soon as it closes (checked on every accept and
+    // poll tick), and all joined and the socket removed before returning.
+    // A failed accept (e.g. out of descriptors) waits a poll interval
+    // before retrying rather than spinning on the still-readable listener.
+    void serve();
+
+    // Ask serve() to return; callable from any thread
+    void stop() {
+        stopping_ = true;
+    }
+
+    // Handler threads not yet joined: open connections, plus closed ones
+    // until serve() next reaps them
+    size_t open_connections();
+
+    // One reply for one request line (the socket protocol without a socket)
+    std::string handle_request(const std::string& line);
+
+    const SequenceDatabase& database() const {
+        return db_;
+    }
+
+    const std::vector<HMMProfile>& profiles() const {
+        return profiles_;
+    }
+
+private:
+    // One client connection's handler thread
+    struct Connection {
+        std::thread thread;
+        std::atomic<bool> done{false};  // Set by the thread as it exits
+    };
+
+    // A SEARCH waiting for its batch
+    struct PendingQuery {
+        int profile;
+        SearchResult result;
+        std::exception_ptr error;  // Set instead of result if the batch failed
+        bool done = false;
+    };
+
+    void serve_connection(int fd, Connection& connection);
+
+    // Join and drop the handlers whose clients have gone
+    void reap_connections();
+
+    const SequenceDatabase& db_;
+    const std::vector<HMMProfile>& profiles_;
+    SearchDaemonConfig config_;
+    MultiProfileSearch engine_;
+
+    int listen_fd_ = -1;
+    std::string socket_path_;
+    std::atomic<bool> stopping_{false};
+    std::mutex connections_mutex_;
+    std::vector<std::unique_ptr<Connection>> connections_;
+
+    std::mutex batch_mutex_;
+    std::condition_variable batch_cv_;
+    std::vector<PendingQuery*> pending_;  // Queries for the batch being collected
+    bool collecting_ = false;             // A leader is waiting out the window
+    bool running_ = false;                // A batch is on the pool
+};
+
+// Client side: send one request line to the daemon at `socket_path` and
+// collect the reply lines up to and including the OK/ERR status line
+bool daemon_request(const std::string& socket_path, const std::string& request, std::vector<std::string>& reply,
+                    std::string& error);
+
+#endif // MSV_FILTER_SEARCH_DAEMON_HPP
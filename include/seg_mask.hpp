@@ -0,0 +1,77 @@
+/*******************************************************************************
+ * File: include/seg_mask.hpp
+ * Description: SEG-style low-complexity masking of digital sequences.
+ *
+ * Follows the two-threshold scheme of Wootton & Federhen's SEG: the Shannon
+ * entropy (bits) of every length-W window is computed; a window at or
+ * below the trigger entropy seeds a region, which extends over the adjacent
+ * windows at or below the extension entropy. Every residue covered by a
+ * seeded region is remapped in place to the alphabet's "any residue" code
+ * (X for amino, any_index() = Kp-3), which the MSV kernels treat as a row
+ * reset and the generic stages cannot emit. SEG's final optimal-subsequence
+ * trimming is not done; masks are the whole extended regions.
+ *
+ * Window entropies come from a sliding histogram: one residue enters and
+ * one leaves per step, and S = sum_x c_x log2 c_x is updated from a table of
+ * c log2 c in 16.16 fixed point, so the running sum never drifts. The
+ * sequence is cut into SEG_LANES contiguous chunks whose histograms slide
+ * side by side (one lane each) to keep several independent updates in
+ * flight. Non-canonical codes share one extra histogram bin.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_SEG_MASK_HPP
+#define MSV_FILTER_SEG_MASK_HPP
+
+#include <cstdint>
+#include <vector>
+#include "hmmer_types.hpp"
+#include "alphabet.hpp"
+
+constexpr int SEG_LANES = 8;       // Window chunks slid side by side
+constexpr int SEG_MIN_CHUNK = 64;  // Fewer windows per lane take the scalar path
+
+// SEG's protein defaults: window 12, trigger 2.2 bits, extension 2.5 bits
+struct SegMaskConfig {
+    int window = 12;
+    float trigger_bits = 2.2f;
+    float extension_bits = 2.5f;
+};
+
+class SegMasker {
+public:
+    // Window is clamped to 2..255 so counts fit a byte
+    explicit SegMasker(const DigitalAlphabet& abc, const SegMaskConfig& config = SegMaskConfig());
+
+    // Mask low-complexity regions of digital_sequence[1..L] in place;
+    // returns the number of residues remapped. `entropy_buffer` is
+    // caller-owned scratch.
+    int mask(DigitalResidue* digital_sequence, int sequence_length, std::vector<float>& entropy_buffer) const;
+
+    // Entropy in bits of the windows starting at 1..L-W+1, written to
+    // entropy[0..L-W]; empty if L < W
+    void window_entropy(const DigitalResidue* digital_sequence, int sequence_length,
+                        std::vector<float>& entropy) const;
+
+    // Entropy of the single window starting at `start`, from scratch
+    double window_entropy_at(const DigitalResidue* digital_sequence, int start) const;
+
+    const SegMaskConfig& config() const {
+        return config_;
+    }
+
+    DigitalResidue mask_code() const {
+        return mask_code_;
+    }
+
+private:
+    int bin(DigitalResidue x) const {
+        return x < K_ ? x : K_;
+    }
+
+    SegMaskConfig config_;
+    int K_;
+    DigitalResidue mask_code_;
+    std::vector<int32_t> clogc_;  // round(c log2 c * 65536), c = 0..window
+};
+
+#endif // MSV_FILTER_SEG_MASK_HPP
@@ -0,0 +1,90 @@
+/*******************************************************************************
+ * File: include/sequence_db.hpp
+ * Description: In-memory digital sequence database loaded from FASTA.
+ *
+ * The database is digitized once at load time and kept as a single
+ * PackedSequenceStream (packed_stream.hpp): residues of all sequences back
+ * to back with shared sentinels, so any member is a framed digital sequence
+ * that the kernels and the Pipeline read in place, and a range of members
+ * is one contiguous stretch of memory.
+ *
+ * FASTA residues are mapped through the alphabet's inmap after upper-casing;
+ * characters the alphabet does not know become its "any" code (X), as
+ * esl_abc_Digitize() would reject them. Whitespace and digits are skipped.
+ *
+ * chunks() cuts the database into runs of consecutive sequences with about
+ * the same number of residues each, the unit a worker scores at a time.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_SEQUENCE_DB_HPP
+#define MSV_FILTER_SEQUENCE_DB_HPP
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+#include "alphabet.hpp"
+#include "hmmer_types.hpp"
+#include "packed_stream.hpp"
+
+// Members first..last-1 of a database
+struct SequenceRange {
+    int first;
+    int last;
+};
+
+class SequenceDatabase {
+public:
+    explicit SequenceDatabase(const DigitalAlphabet& abc) : abc_(abc) {}
+
+    // Append every record of a FASTA stream; false with `error` set on a
+    // malformed file (residues before the first header)
+    bool load_fasta(std::istream& in, std::string& error);
+
+    // Same, from a file path
+    bool load_fasta(const std::string& path, std::string& error);
+
+    // Append one digitized sequence (digital_sequence[1..L])
+    int add(const std::string& name, const DigitalResidue* digital_sequence, int sequence_length);
+
+    int size() const {
+        return stream_.size();
+    }
+
+    const std::string& name(int s) const {
+        return names_[s];
+    }
+
+    int length(int s) const {
+        return stream_.length(s);
+    }
+
+    // Member s as a framed digital sequence
+    const DigitalResidue* sequence(int s) const {
+        return stream_.sequence(s);
+    }
+
+    const PackedSequenceStream& stream() const {
+        return stream_;
+    }
+
+    int64_t residues() const {
+        return residues_;
+    }
+
+    const DigitalAlphabet& alphabet() const {
+        return abc_;
+    }
+
+    // Consecutive ranges of about target_residues residues each (a single
+    // longer sequence makes its own range)
+    std::vector<SequenceRange> chunks(int64_t target_residues) const;
+
+private:
+    const DigitalAlphabet& abc_;
+    PackedSequenceStream stream_;
+    std::vector<std::string> names_;
+    int64_t residues_ = 0;
+};
+
+#endif // MSV_FILTER_SEQUENCE_DB_HPP
@@ -0,0 +1,62 @@
+/*******************************************************************************
+ * File: include/thread_pool.hpp
+ * Description: Fixed pool of pre-started worker threads.
+ *
+ * Long-running services should not pay thread creation on every query. The
+ * pool starts its workers once; parallel_for() hands them the indices
+ * 0..n-1 of one job and blocks until all are done. Several callers may run
+ * jobs at the same time: jobs queue up and workers take tasks from the
+ * oldest one first.
+ *
+ * Tasks get the index of the worker running them, so callers can keep
+ * per-worker scratch (a Pipeline, DP buffers) without locking.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_THREAD_POOL_HPP
+#define MSV_FILTER_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    using Task = std::function<void(int task, int worker)>;
+
+    // 0 = std::thread::hardware_concurrency()
+    explicit ThreadPool(int num_threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const {
+        return static_cast<int>(workers_.size());
+    }
+
+    // Run task(i, worker) for i = 0..n-1 on the pool; returns when all ran
+    void parallel_for(int n, const Task& task);
+
+private:
+    struct Job {
+        const Task* task;
+        int n;
+        int next = 0;       // Next index to hand out
+        int remaining = 0;  // Indices not yet finished
+        std::condition_variable done;
+    };
+
+    void worker_loop(int worker);
+
+    std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::deque<std::shared_ptr<Job>> jobs_;  // Jobs with indices left to hand out
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+#endif // MSV_FILTER_THREAD_POOL_HPP
@@ -0,0 +1,237 @@
+/*******************************************************************************
+ * File: include/translated_search.hpp
+ * Description: Six-frame translated MSV search of DNA against protein
+ * profiles.
+ *
+ * Genomic and metagenomic DNA is searched with protein profiles by scoring
+ * its six reading frames. Nothing is materialized: each frame is cut into
+ * overlapping windows (WindowedScanner::layout), and for each window the
+ * codons are translated straight into a small DigitalResidue buffer that is
+ * immediately scored by the amino MSV segment kernel while it is still in
+ * cache.
+ *
+ * Translation uses a 65-entry codon table indexed by a 6-bit codon number
+ * (2 bits per canonical base) plus one slot for codons containing a
+ * degenerate base, gap or illegal byte, which translate to X. Stop codons
+ * translate to '*'. Both are non-canonical amino codes, so they reset the
+ * MSV row exactly like a degenerate residue in a protein sequence.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_TRANSLATED_SEARCH_HPP
+#define MSV_FILTER_TRANSLATED_SEARCH_HPP
+
+#include <algorithm>
+#include <array>
+#include <vector>
+#include "hmmer_types.hpp"
+#include "alphabet_traits.hpp"
+#include "msv_kernel.hpp"
+#include "msv_segments.hpp"
+#include "windowed_scan.hpp"
+
+/*******************************************************************************
+ * CodonTable
+ *
+ * Built from an NCBI translation table string: 64 amino acid letters for
+ * codons in TCAG order (TTT, TTC, TTA, TTG, TCT, ...). The default is the
+ * standard code (transl_table=1). Lookups are by digital nucleotide codes
+ * (A=0, C=1, G=2, T=3).
+ ******************************************************************************/
+
+class CodonTable {
+public:
+    static constexpr int NUM_CODONS = 64;
+    static constexpr int DEGENERATE_CODON = 64;  // Codon with a non-ACGT base
+
+    static const char* const STANDARD;
+
+    explicit CodonTable(const char* ncbi_amino_acids = STANDARD);
+
+    // 6-bit codon number of three digital bases, or DEGENERATE_CODON
+    static int codon_index(DigitalResidue b1, DigitalResidue b2, DigitalResidue b3) {
+        // Any code >= 4 has a bit above bit 1 set, so one OR tests all three
+        const bool degenerate = (b1 | b2 | b3) >= 4;
+        const int index = ((b1 & 3) << 4) | ((b2 & 3) << 2) | (b3 & 3);
+        return degenerate ? DEGENERATE_CODON : index;
+    }
+
+    // Codon number of the reverse complement of b1 b2 b3, read 5'->3' on the
+    // minus strand: complement(b3) complement(b2) complement(b1)
+    static int reverse_codon_index(DigitalResidue b1, DigitalResidue b2, DigitalResidue b3) {
+        const bool degenerate = (b1 | b2 | b3) >= 4;
+        const int index = ((3 - (b3 & 3)) << 4) | ((3 - (b2 & 3)) << 2) | (3 - (b1 & 3));
+        return degenerate ? DEGENERATE_CODON : index;
+    }
+
+    // Digital amino acid code (AminoTraits) of a codon number
+    DigitalResidue operator[](int codon) const {
+        return amino_[codon];
+    }
+
+    DigitalResidue translate(DigitalResidue b1, DigitalResidue b2, DigitalResidue b3) const {
+        return amino_[codon_index(b1, b2, b3)];
+    }
+
+private:
+    std::array<DigitalResidue, NUM_CODONS + 1> amino_;
+};
+
+/*******************************************************************************
+ * Reading Frames
+ *
+ * Frames are numbered +1, +2, +3 (forward, starting at nucleotide 1, 2, 3)
+ * and -1, -2, -3 (reverse complement, starting at nucleotide L, L-1, L-2).
+ * Frame index 0..5 maps to +1, +2, +3, -1, -2, -3.
+ ******************************************************************************/
+
+constexpr int NUM_READING_FRAMES = 6;
+
+inline int frame_number(int frame_index) {
+    return frame_index < 3 ? frame_index + 1 : -(frame_index - 2);
+}
+
+// Codons in frame `frame_index` of a sequence of L nucleotides
+inline int frame_length(int sequence_length, int frame_index) {
+    return std::max(0, (sequence_length - (frame_index % 3)) / 3);
+}
+
+// Nucleotide span (1-indexed, inclusive, forward strand) of codons
+// first..last (1-indexed) of a frame
+inline void frame_to_nucleotide(int sequence_length, int frame_index, int first, int last, int& start, int& end) {
+    const int offset = frame_index % 3;
+    if (frame_index < 3) {
+        start = offset + (3 * (first - 1)) + 1;
+        end = offset + (3 * last);
+    } else {
+        start = sequence_length - offset - (3 * last) + 1;
+        end = sequence_length - offset - (3 * (first - 1));
+    }
+}
+
+// Translate codons first..last (1-indexed) of a frame of a sentinel-framed
+// digital DNA sequence into out[1..n], with sentinels at out[0] and out[n+1].
+// `out` must hold last - first + 3 residues. Returns n.
+int translate_frame(const DigitalResidue* dna, int sequence_length, int frame_index, int first, int last,
+                    const CodonTable& codons, DigitalResidue* out);
+
+/*******************************************************************************
+ * TranslatedScanner
+ *
+ * Scores all six frames of a DNA sequence with msv_kernel_segments<AminoTraits>.
+ * Windows are sized in codons and overlap by M + margin codons, so (as in
+ * WindowedScanner) every segment is scored whole in some window. Hits are
+ * the segments themselves, deduplicated per frame like WindowedScanner's
+ * and mapped to forward-strand nucleotides, so a hit spans at most M codons
+ * whatever the window length.
+ ******************************************************************************/
+
+struct TranslatedScanConfig {
+    int window_codons = 4096;       // Codons translated and scored per chunk
+    int overlap_margin = 64;        // Overlap beyond M between windows
+    float report_threshold = 0.0f;  // Segments scoring above this (nats) are hits
+    int segments_per_window = 8;    // Best segments each window offers as hits
+};
+
+struct TranslatedHit {
+    int frame;    // +1..+3 or -1..-3
+    int start;    // Forward-strand nucleotide span, 1-indexed, inclusive
+    int end;
+    int k_start;  // Model columns aligned to the segment's codons
+    int k_end;
+    float score;  // Segment score (nats)
+};
+
+struct TranslatedScanResult {
+    float best_score = 0.0f;
+    int best_frame = 0;                                   // 0 if nothing scored
+    std::array<float, NUM_READING_FRAMES> frame_scores{};  // By frame index
+    std::vector<TranslatedHit> hits;                      // One per segment; frame order, then start
+};
+
+class TranslatedScanner {
+public:
+    explicit TranslatedScanner(const TranslatedScanConfig& config = TranslatedScanConfig(),
+                               const CodonTable& codons = CodonTable())
+        : config_(config), codons_(codons) {}
+
+    const CodonTable& codons() const {
+        return codons_;
+    }
+
+    // `dna` is sentinel-framed in NucleotideAlphabet codes; `table` is the
+    // protein profile's amino score table for the chosen policy
+    template<class Policy = FloatPolicy>
+    TranslatedScanResult scan(const DigitalResidue* dna, int sequence_length,
+                              const MatchScoreTable<AminoTraits::K, Policy>& table) const
+    {
+        TranslatedScanResult result;
+        const int overlap = std::max(0, table.model_length) + std::max(0, config_.overlap_margin);
+
+        std::vector<DigitalResidue> protein;
+        std::vector<SegmentRun<typename Policy::cell_type>> run_buffer;
+        std::vector<MSVSegment> segments;
+        std::vector<TranslatedHit> candidates;
+        for (int f = 0; f < NUM_READING_FRAMES; f++) {
+            const std::vector<ScanWindow> windows =
+                WindowedScanner::layout(frame_length(sequence_length, f), config_.window_codons, overlap);
+
+            // Segments in frame codon coordinates, converted when the frame is done
+            candidates.clear();
+            for (const ScanWindow& w : windows) {
+                // Translate this window only, then score it while it is hot
+                protein.resize(static_cast<size_t>(w.length()) + 2);
+                const int n = translate_frame(dna, sequence_length, f, w.start, w.end, codons_, protein.data());
+                const float score = msv_kernel_segments<AminoTraits, Policy>(
+                    protein.data(), n, table, run_buffer, config_.segments_per_window, segments);
+
+                result.frame_scores[f] = std::max(result.frame_scores[f], score);
+                const int shift = w.start - 1;
+                for (const MSVSegment& segment : segments) {
+                    if (segment.score > config_.report_threshold) {
+                        candidates.push_back({frame_number(f), segment.i_start + shift, segment.i_end + shift,
+                                              segment.k_start, segment.k_end, segment.score});
+                    }
+                }
+            }
+
+            // Best first, dropping any that shares a diagonal and codons with
+            // one already kept (found again in the overlap of two windows)
+            const size_t first_hit = result.hits.size();
+            std::stable_sort(candidates.begin(), candidates.end(),
+                             [](const TranslatedHit& a, const TranslatedHit& b) { return a.score > b.score; });
+            for (const TranslatedHit& hit : candidates) {
+                bool duplicate = false;
+                for (size_t h = first_hit; h < result.hits.size(); h++) {
+                    const TranslatedHit& kept = result.hits[h];
+                    duplicate = duplicate || (hit.start - hit.k_start == kept.start - kept.k_start &&
+                                              hit.start <= kept.end && kept.start <= hit.end);
+                }
+                if (!duplicate) {
+                    result.hits.push_back(hit);
+                }
+            }
+            for (size_t h = first_hit; h < result.hits.size(); h++) {
+                TranslatedHit& hit = result.hits[h];
+                int start = 0;
+                int end = 0;
+                frame_to_nucleotide(sequence_length, f, hit.start, hit.end, start, end);
+                hit.start = start;
+                hit.end = end;
+            }
+            std::sort(result.hits.begin() + static_cast<long>(first_hit), result.hits.end(),
+                      [](const TranslatedHit& a, const TranslatedHit& b) { return a.start < b.start; });
+
+            if (!windows.empty() && (result.best_frame == 0 || result.frame_scores[f] > result.best_score)) {
+                result.best_score = result.frame_scores[f];
+                result.best_frame = frame_number(f);
+            }
+        }
+        return result;
+    }
+
+private:
+    TranslatedScanConfig config_;
+    CodonTable codons_;
+};
+
+#endif // MSV_FILTER_TRANSLATED_SEARCH_HPP
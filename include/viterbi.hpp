@@ -0,0 +1,89 @@
+/*******************************************************************************
+ * File: include/viterbi.hpp
+ * Description: Generic (scalar) Viterbi, the gapped stage after MSV.
+ *
+ * Replicates p7_GViterbi() from hmmer/src/generic_viterbi.c over HMMProfile
+ * and DPMatrix: match, insert and delete states with the profile's tsc
+ * transitions and insert_score() emissions, plus the N/B/E/J/C special
+ * states. Special transitions for the target length come from
+ * LengthConfigCache; local entry B->Mk uses its uniform tbmk.
+ *
+ * The full (L+1) x (M+1) matrix is filled so a traceback can follow. This is
+ * the reference the striped filter (viterbi_filter.hpp) is tested against.
+ * viterbi_traceback() recovers the best path from a filled matrix, and
+ * trace_band() turns it into the sparse region Forward evaluates.
+ *
+ * compute_viterbi_banded() runs the same recurrence over only the cells of
+ * a DPBand, typically seed_band() around the best MSV diagonals, stored
+ * sparsely in a BandedDPMatrix (banded_dp.hpp).
+ *
+ * For long sequences, compute_viterbi_checkpointed() keeps only every B-th
+ * row (B ~ sqrt(L), checkpoint_dp.hpp) and the traceback recomputes the
+ * rows between checkpoints block by block, so a full-matrix traceback needs
+ * O(M sqrt(L)) memory for about twice the fill time.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_VITERBI_HPP
+#define MSV_FILTER_VITERBI_HPP
+
+#include <vector>
+#include "hmmer_types.hpp"
+#include "profile.hpp"
+#include "dp_matrix.hpp"
+#include "dp_band.hpp"
+#include "banded_dp.hpp"
+#include "checkpoint_dp.hpp"
+#include "length_config.hpp"
+
+// Viterbi score in nats (raw, not null-corrected); -inf if no path exists.
+// `dp_matrix` must be allocated for at least M x L. Residue codes >= Kp
+// (sentinels, illegal bytes) cannot be emitted by the model.
+float compute_viterbi(const DigitalResidue* digital_sequence, int sequence_length, const HMMProfile& profile,
+                      const SpecialTransitions& specials, float tbmk, DPMatrix& dp_matrix);
+
+// Same, with specials and tbmk for length L taken from `config`
+float compute_viterbi(const DigitalResidue* digital_sequence, int sequence_length, const HMMProfile& profile,
+                      const LengthConfigCache& config, DPMatrix& dp_matrix);
+
+// Viterbi restricted to the cells of `band`; `dp_matrix` is reshaped to
+// it. Paths leaving the band are dropped, so the score is a lower bound.
+float compute_viterbi_banded(const DigitalResidue* digital_sequence, int sequence_length,
+                             const HMMProfile& profile, const SpecialTransitions& specials, float tbmk,
+                             const DPBand& band, BandedDPMatrix& dp_matrix);
+
+// Full Viterbi keeping checkpoint rows only; `dp_matrix` is reshaped to
+// M x L. Same score as compute_viterbi().
+float compute_viterbi_checkpointed(const DigitalResidue* digital_sequence, int sequence_length,
+                                  const HMMProfile& profile, const SpecialTransitions& specials, float tbmk,
+                                  CheckpointedDPMatrix& dp_matrix);
+
+// One core-model cell on a Viterbi path
+struct TraceCell {
+    int i;      // Row (residue) 1..L
+    int k;      // Node 1..M
+    int state;  // p7G_M, p7G_I or p7G_D
+};
+
+// Core cells of the best path through a matrix filled by compute_viterbi()
+// with the same arguments, in path order (all domains). Empty if the
+// sequence has no path.
+std::vector<TraceCell> viterbi_traceback(int sequence_length, const HMMProfile& profile,
+                                         const SpecialTransitions& specials, float tbmk,
+                                         const DPMatrix& dp_matrix);
+
+// Same, after compute_viterbi_banded()
+std::vector<TraceCell> viterbi_traceback(int sequence_length, const HMMProfile& profile,
+                                         const SpecialTransitions& specials, float tbmk,
+                                         const BandedDPMatrix& dp_matrix);
+
+// Same, after compute_viterbi_checkpointed() on the same sequence; rows
+// between checkpoints are recomputed from `digital_sequence`, so the
+// matrix's block buffer is overwritten
+std::vector<TraceCell> viterbi_traceback(const DigitalResidue* digital_sequence, int sequence_length,
+                                         const HMMProfile& profile, const SpecialTransitions& specials, float tbmk,
+                                         CheckpointedDPMatrix& dp_matrix);
+
+// Band of +/- margin rows and columns around every traced cell
+DPBand trace_band(const std::vector<TraceCell>& trace, int model_length, int sequence_length, int margin);
+
+#endif // MSV_FILTER_VITERBI_HPP
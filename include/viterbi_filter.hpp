@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * File: include/viterbi_filter.hpp
+ * Description: Striped 16-bit Viterbi filter, after p7_ViterbiFilter()
+ * (hmmer/src/impl_sse/vitfilter.c).
+ *
+ * Scores are signed words in 1/500 bit units offset by a base, so that
+ * real path scores stay well inside the int16 range. The model is laid out
+ * in Farrar's striped order: with Q = ceil(M / 8) vectors of 8 lanes, node
+ * k lives in vector q = (k-1) % Q, lane z = (k-1) / Q. Within one row all
+ * match and insert cells are computed vector by vector with no
+ * dependencies between lanes. Delete chains cross lanes, so they are
+ * resolved afterwards by the lazy-F loop, which in practice exits after one
+ * or two passes.
+ *
+ * A "vector" here is a std::array of 8 int16 lanes; the lane loops are
+ * written so the compiler can map them onto 128-bit SIMD registers. The
+ * -32768 value is treated as a sticky -infinity. A path score that
+ * saturates at +32767 is reported as +inf, as eslERANGE is in HMMER: the
+ * sequence passes the filter.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_VITERBI_FILTER_HPP
+#define MSV_FILTER_VITERBI_FILTER_HPP
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "hmmer_types.hpp"
+#include "profile.hpp"
+#include "length_config.hpp"
+
+constexpr int VITERBI_LANES = 8;
+using WordVector = std::array<int16_t, VITERBI_LANES>;
+
+/*******************************************************************************
+ * ViterbiWordProfile
+ *
+ * Striped, word-quantized copy of a profile. Built once per profile and
+ * shared read-only between threads; special transitions are quantized per
+ * call because they depend on the target length.
+ ******************************************************************************/
+
+struct ViterbiWordProfile {
+    static constexpr int16_t NEG_INF = -32768;
+    static constexpr int16_t POS_MAX = 32767;
+    static constexpr int BASE = 12000;  // p7_oprofile base_w
+
+    // Per-node transition vectors, in the order the row loop reads them
+    enum Transition {
+        T_BM = 0,  // B->Mk (local entry)
+        T_MM = 1,  // M(k-1)->Mk
+        T_IM = 2,  // I(k-1)->Mk
+        T_DM = 3,  // D(k-1)->Mk
+        T_MD = 4,  // Mk->D(k+1)
+        T_MI = 5,  // Mk->Ik
+        T_II = 6,  // Ik->Ik
+        T_DD = 7,  // Dk->D(k+1)
+        NUM_TRANSITIONS = 8
+    };
+
+    int model_length;
+    int Q;        // Vectors per row
+    int Kp;       // Residue rows; row Kp is all -inf (sentinels, illegal bytes)
+    float scale;  // Word units per nat
+
+    std::vector<WordVector> match;   // [x * Q + q]
+    std::vector<WordVector> insert;  // [x * Q + q]
+    std::vector<WordVector> trans;   // [q * NUM_TRANSITIONS + t]
+
+    ViterbiWordProfile(const HMMProfile& profile, float tbmk, float scale = default_scale());
+
+    // p7_oprofile scale_w: 1/500 bit
+    static float default_scale() {
+        return 500.0f / eslCONST_LOG2;
+    }
+
+    // Round to word units; -inf (and anything below the range) maps to NEG_INF
+    int16_t wordify(float score) const;
+
+    // Striped position of node k (1..M)
+    int vector_of(int k) const {
+        return (k - 1) % Q;
+    }
+
+    int lane_of(int k) const {
+        return (k - 1) / Q;
+    }
+};
+
+// Viterbi score in nats; -inf if no path, +inf if the words saturated.
+// `row_buffer` is caller-owned scratch (3Q vectors), resized as needed.
+float viterbi_filter(const DigitalResidue* digital_sequence, int sequence_length, const ViterbiWordProfile& om,
+                     const SpecialTransitions& specials, std::vector<WordVector>& row_buffer);
+
+#endif // MSV_FILTER_VITERBI_FILTER_HPP
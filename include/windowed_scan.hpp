@@ -0,0 +1,190 @@
+/*******************************************************************************
+ * File: include/windowed_scan.hpp
+ * Description: Windowed scanning of very long digital sequences.
+ *
+ * A megabase contig against a profile runs on one thread. The windowed
+ * scanner cuts the sequence into overlapping windows, scores each window
+ * independently (in parallel) with the two-row segment kernel
+ * (msv_segments.hpp), and merges the per-window results, in the spirit of
+ * nhmmer's windowed scan. Each worker needs O(M) scratch, whatever the
+ * window length.
+ *
+ * Windows overlap by at least M + margin residues. An MSV segment never spans
+ * more than M residues, so every segment lies entirely inside at least one
+ * window and no hit is lost at a window boundary. Hits are the segments
+ * themselves, in full-sequence coordinates. A segment that falls in an
+ * overlap is found by both neighbours (one of them may see only a clipped
+ * part of it); of hits sharing a diagonal and overlapping rows, only the
+ * best is kept, so each is reported once.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_WINDOWED_SCAN_HPP
+#define MSV_FILTER_WINDOWED_SCAN_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "hmmer_types.hpp"
+#include "msv_kernel.hpp"
+#include "msv_segments.hpp"
+
+/*******************************************************************************
+ * Configuration and Result Types
+ ******************************************************************************/
+
+struct WindowedScanConfig {
+    int window_length = 100000;    // Residues per window, overlap included
+    int overlap_margin = 64;       // Overlap beyond M between neighbouring windows
+    int num_threads = 0;           // 0 = std::thread::hardware_concurrency()
+    float report_threshold = 0.0f; // Segments scoring above this (nats) are hits
+    int segments_per_window = 8;   // Best segments each window offers as hits
+};
+
+// A window in 1-indexed, inclusive coordinates of the full sequence
+struct ScanWindow {
+    int start;
+    int end;
+
+    int length() const {
+        return end - start + 1;
+    }
+};
+
+// A reported ungapped segment in full-sequence coordinates
+struct WindowHit {
+    int start;    // First residue, 1-indexed, inclusive
+    int end;      // Last residue, 1-indexed, inclusive
+    int k_start;  // Model columns aligned to start..end
+    int k_end;
+    float score;  // Segment score (nats)
+};
+
+struct WindowedScanResult {
+    float best_score = 0.0f;              // Max over all windows (== whole-sequence MSV score)
+    std::vector<float> window_scores;     // Indexed like the window layout
+    std::vector<ScanWindow> windows;
+    std::vector<WindowHit> hits;          // One per segment, sorted by start
+};
+
+/*******************************************************************************
+ * WindowedScanner
+ *
+ * Scores windows with msv_kernel_segments() against any MatchScoreTable, so
+ * every policy and alphabet of msv_kernel() works. A window is scored in
+ * place through a pointer offset: the kernel reads residues 1..length only,
+ * so no re-framed copy is needed.
+ ******************************************************************************/
+
+class WindowedScanner {
+public:
+    explicit WindowedScanner(const WindowedScanConfig& config = WindowedScanConfig())
+        : config_(config) {}
+
+    const WindowedScanConfig& config() const {
+        return config_;
+    }
+
+    // Overlap needed between neighbouring windows for a model of length M
+    int overlap_for(int model_length) const {
+        return std::max(0, model_length) + std::max(0, config_.overlap_margin);
+    }
+
+    // Split 1..L into windows of window_length overlapping by `overlap`.
+    // A window length too short to make progress is widened to 2 * overlap.
+    static std::vector<ScanWindow> layout(int sequence_length, int window_length, int overlap) {
+        std::vector<ScanWindow> windows;
+        if (sequence_length <= 0) {
+            return windows;
+        }
+        if (window_length <= overlap) {
+            window_length = std::max(1, 2 * overlap);
+        }
+
+        int start = 1;
+        while (true) {
+            int end = std::min(sequence_length, start + window_length - 1);
+            windows.push_back({start, end});
+            if (end == sequence_length) {
+                break;
+            }
+            start = end - overlap + 1;
+        }
+        return windows;
+    }
+
+    template<class Traits, class Policy = FloatPolicy>
+    WindowedScanResult scan(const DigitalResidue* digital_sequence, int sequence_length,
+                            const MatchScoreTable<Traits::K, Policy>& table) const
+    {
+        using cell_type = typename Policy::cell_type;
+        WindowedScanResult result;
+        result.windows = layout(sequence_length, config_.window_length, overlap_for(table.model_length));
+        result.window_scores.assign(result.windows.size(), 0.0f);
+        if (result.windows.empty()) {
+            return result;
+        }
+        std::vector<std::vector<MSVSegment>> window_segments(result.windows.size());
+
+        // --- A. Score windows; workers pull the next window index ---
+        std::atomic<size_t> next_window(0);
+        auto worker = [&]() {
+            std::vector<SegmentRun<cell_type>> run_buffer;
+            for (size_t w = next_window++; w < result.windows.size(); w = next_window++) {
+                const ScanWindow& window = result.windows[w];
+                result.window_scores[w] = msv_kernel_segments<Traits, Policy>(
+                    digital_sequence + window.start - 1, window.length(), table, run_buffer,
+                    config_.segments_per_window, window_segments[w]);
+            }
+        };
+
+        int threads = config_.num_threads > 0 ? config_.num_threads
+                                              : static_cast<int>(std::thread::hardware_concurrency());
+        threads = std::max(1, std::min(threads, static_cast<int>(result.windows.size())));
+        if (threads == 1) {
+            worker();
+        } else {
+            std::vector<std::thread> pool;
+            for (int t = 0; t < threads; t++) {
+                pool.emplace_back(worker);
+            }
+            for (std::thread& thread : pool) {
+                thread.join();
+            }
+        }
+
+        // --- B. Merge: best score, then segments best first, dropping any
+        // that shares a diagonal and rows with one already kept ---
+        std::vector<WindowHit> candidates;
+        for (size_t w = 0; w < result.windows.size(); w++) {
+            result.best_score = std::max(result.best_score, result.window_scores[w]);
+            const int shift = result.windows[w].start - 1;
+            for (const MSVSegment& segment : window_segments[w]) {
+                if (segment.score > config_.report_threshold) {
+                    candidates.push_back({segment.i_start + shift, segment.i_end + shift, segment.k_start,
+                                          segment.k_end, segment.score});
+                }
+            }
+        }
+        std::stable_sort(candidates.begin(), candidates.end(),
+                         [](const WindowHit& a, const WindowHit& b) { return a.score > b.score; });
+        for (const WindowHit& hit : candidates) {
+            bool duplicate = false;
+            for (const WindowHit& kept : result.hits) {
+                duplicate = duplicate || (hit.start - hit.k_start == kept.start - kept.k_start &&
+                                          hit.start <= kept.end && kept.start <= hit.end);
+            }
+            if (!duplicate) {
+                result.hits.push_back(hit);
+            }
+        }
+        std::sort(result.hits.begin(), result.hits.end(),
+                  [](const WindowHit& a, const WindowHit& b) { return a.start < b.start; });
+        return result;
+    }
+
+private:
+    WindowedScanConfig config_;
+};
+
+#endif // MSV_FILTER_WINDOWED_SCAN_HPP
@@ -0,0 +1,131 @@
+#include "bias_filter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include "pvalue.hpp"
+
+BiasFilter::BiasFilter(const HMMProfile& profile) {
+    // p7_bg_SetFilter transitions; the 1.0 exits leave the length model to
+    // the p7_bg_NullOne term added at the end
+    const float L0 = 400.0f;
+    const float L1 = std::max(1.0f, static_cast<float>(profile.model_length) / 8.0f);
+    t00_ = L0 / (L0 + 1.0f);
+    t01_ = 1.0f / (L0 + 1.0f);
+    t10_ = 1.0f / (L1 + 1.0f);
+    t11_ = L1 / (L1 + 1.0f);
+
+    const int K = profile.abc->K;
+    std::vector<double> compo(K, 0.0);
+    double total = 0.0;
+    for (int x = 0; x < K; x++) {
+        compo[x] = profile.compo[x];
+        total += compo[x];
+    }
+    if (total <= 0.0) {
+        for (int x = 0; x < K; x++) {
+            for (int k = 1; k <= profile.model_length; k++) {
+                compo[x] += std::exp(static_cast<double>(profile.match_score(k, x))) / K;
+            }
+            total += compo[x];
+        }
+    }
+    std::fill(odds_, odds_ + 256, 1.0f);
+    for (int x = 0; x < K; x++) {
+        odds_[x] = total > 0.0 ? static_cast<float>(compo[x] / total * K) : 1.0f;
+    }
+}
+
+float BiasFilter::score_scalar(const DigitalResidue* digital_sequence, int sequence_length) const {
+    const int L = sequence_length;
+    if (L <= 0) {
+        return null_one_score(L);
+    }
+
+    // esl_hmm_Forward in scaled probability space, pi = (0.999, 0.001)
+    float f0 = 0.999f;
+    float f1 = 0.001f * odds_[digital_sequence[1]];
+    double log_scale = 0.0;
+    for (int i = 2; i <= L; i++) {
+        const float n0 = (f0 * t00_) + (f1 * t10_);
+        const float n1 = ((f0 * t01_) + (f1 * t11_)) * odds_[digital_sequence[i]];
+        const float sum = n0 + n1;
+        f0 = n0 / sum;
+        f1 = n1 / sum;
+        log_scale += std::log(static_cast<double>(sum));
+    }
+    return static_cast<float>(log_scale + std::log(static_cast<double>(f0 + f1))) + null_one_score(L);
+}
+
+float BiasFilter::score(const DigitalResidue* digital_sequence, int sequence_length) const {
+    const int L = sequence_length;
+    const int steps = L - 1;  // Residues 2..L; residue 1 is in the initial vector
+    const int chunk = steps / BIAS_LANES;
+    if (chunk < BIAS_MIN_CHUNK) {
+        return score_scalar(digital_sequence, sequence_length);
+    }
+
+    // --- A. Per-lane transfer matrices [a b] over residues 2 + c*chunk ... ---
+    // Column a starts as state 0, column b as state 1; entries renormalized
+    // to sum 1 after every step, scales multiplied up and logged in blocks
+    float a0[BIAS_LANES], a1[BIAS_LANES], b0[BIAS_LANES], b1[BIAS_LANES];
+    float scale[BIAS_LANES];
+    double lane_log[BIAS_LANES];
+    const DigitalResidue* base[BIAS_LANES];
+    for (int c = 0; c < BIAS_LANES; c++) {
+        a0[c] = b1[c] = 1.0f;
+        a1[c] = b0[c] = 0.0f;
+        scale[c] = 1.0f;
+        lane_log[c] = 0.0;
+        base[c] = digital_sequence + 2 + (static_cast<size_t>(c) * chunk);
+    }
+
+    for (int j = 0; j < chunk; j++) {
+        float o[BIAS_LANES];
+        for (int c = 0; c < BIAS_LANES; c++) {
+            o[c] = odds_[base[c][j]];
+        }
+        for (int c = 0; c < BIAS_LANES; c++) {
+            const float na0 = (a0[c] * t00_) + (a1[c] * t10_);
+            const float na1 = ((a0[c] * t01_) + (a1[c] * t11_)) * o[c];
+            const float nb0 = (b0[c] * t00_) + (b1[c] * t10_);
+            const float nb1 = ((b0[c] * t01_) + (b1[c] * t11_)) * o[c];
+            const float sum = na0 + na1 + nb0 + nb1;
+            const float inv = 1.0f / sum;
+            a0[c] = na0 * inv;
+            a1[c] = na1 * inv;
+            b0[c] = nb0 * inv;
+            b1[c] = nb1 * inv;
+            scale[c] *= sum;
+        }
+        if ((j + 1) % BIAS_LOG_BLOCK == 0) {
+            for (int c = 0; c < BIAS_LANES; c++) {
+                lane_log[c] += std::log(scale[c]);
+                scale[c] = 1.0f;
+            }
+        }
+    }
+
+    // --- B. Chain the chunks onto the initial vector ---
+    float f0 = 0.999f;
+    float f1 = 0.001f * odds_[digital_sequence[1]];
+    double log_total = 0.0;
+    for (int c = 0; c < BIAS_LANES; c++) {
+        const float v0 = (a0[c] * f0) + (b0[c] * f1);
+        const float v1 = (a1[c] * f0) + (b1[c] * f1);
+        const float sum = v0 + v1;
+        f0 = v0 / sum;
+        f1 = v1 / sum;
+        log_total += lane_log[c] + std::log(static_cast<double>(scale[c])) + std::log(static_cast<double>(sum));
+    }
+
+    // --- C. Leftover residues past the last full chunk ---
+    for (int i = 2 + (BIAS_LANES * chunk); i <= L; i++) {
+        const float n0 = (f0 * t00_) + (f1 * t10_);
+        const float n1 = ((f0 * t01_) + (f1 * t11_)) * odds_[digital_sequence[i]];
+        const float sum = n0 + n1;
+        f0 = n0 / sum;
+        f1 = n1 / sum;
+        log_total += std::log(static_cast<double>(sum));
+    }
+    return static_cast<float>(log_total + std::log(static_cast<double>(f0 + f1))) + null_one_score(L);
+}
@@ -0,0 +1,116 @@
+#include "forward.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include "logsum.hpp"
+
+namespace {
+
+// Shared recurrence; `band` == nullptr evaluates every cell
+template<class Matrix>
+float forward_fill(const DigitalResidue* digital_sequence, int sequence_length, const HMMProfile& profile,
+                   const SpecialTransitions& specials, float tbmk, const DPBand* band, Matrix& dp_matrix) {
+    const int M = profile.model_length;
+    const int L = sequence_length;
+    if (M <= 0 || L < 0) {
+        return -eslINFINITY;
+    }
+    assert(band == nullptr || (band->model_length == M && band->sequence_length >= L));
+
+    const float t_nloop = specials(p7P_N, p7P_LOOP);
+    const float t_nmove = specials(p7P_N, p7P_MOVE);
+    const float t_eloop = specials(p7P_E, p7P_LOOP);
+    const float t_emove = specials(p7P_E, p7P_MOVE);
+    const float t_jloop = specials(p7P_J, p7P_LOOP);
+    const float t_jmove = specials(p7P_J, p7P_MOVE);
+    const float t_cloop = specials(p7P_C, p7P_LOOP);
+    const float t_cmove = specials(p7P_C, p7P_MOVE);
+
+    // Cell readers that see -inf outside the band
+    auto in_band = [&](int i, int k) {
+        return k >= 1 && (band == nullptr || band->contains(i, k));
+    };
+    auto mmx = [&](int i, int k) { return in_band(i, k) ? dp_matrix.match(i, k) : -eslINFINITY; };
+    auto imx = [&](int i, int k) { return in_band(i, k) ? dp_matrix.insert(i, k) : -eslINFINITY; };
+    auto dmx = [&](int i, int k) { return in_band(i, k) ? dp_matrix.delete_state(i, k) : -eslINFINITY; };
+
+    // --- A. Row 0 ---
+    dp_matrix.special(0, p7G_N) = 0.0f;
+    dp_matrix.special(0, p7G_B) = t_nmove;
+    dp_matrix.special(0, p7G_E) = dp_matrix.special(0, p7G_J) = dp_matrix.special(0, p7G_C) = -eslINFINITY;
+    if (band == nullptr) {
+        for (int k = 0; k <= M; k++) {
+            dp_matrix.match(0, k) = dp_matrix.insert(0, k) = dp_matrix.delete_state(0, k) = -eslINFINITY;
+        }
+    }
+
+    // --- B. Rows 1..L ---
+    for (int i = 1; i <= L; i++) {
+        const DigitalResidue x = digital_sequence[i];
+        const bool emits = x < profile.abc->Kp;
+        const float xB = dp_matrix.special(i - 1, p7G_B);
+        float xE = -eslINFINITY;
+
+        const int k_lo = band == nullptr ? 1 : band->kmin[i];
+        const int k_hi = band == nullptr ? M : band->kmax[i];
+        for (int k = k_lo; k <= k_hi; k++) {
+            const int j = k - 1;
+            float sc = p7_FLogsum(p7_FLogsum(mmx(i - 1, j) + profile.trans(j, p7P_MM),
+                                             imx(i - 1, j) + profile.trans(j, p7P_IM)),
+                                  p7_FLogsum(xB + tbmk, dmx(i - 1, j) + profile.trans(j, p7P_DM)));
+            sc += emits ? profile.match_score(k, x) : -eslINFINITY;
+            dp_matrix.match(i, k) = sc;
+
+            if (k < M) {
+                const float isc = p7_FLogsum(mmx(i - 1, k) + profile.trans(k, p7P_MI),
+                                             imx(i - 1, k) + profile.trans(k, p7P_II));
+                dp_matrix.insert(i, k) = isc + (emits ? profile.insert_score(k, x) : -eslINFINITY);
+            } else {
+                dp_matrix.insert(i, k) = -eslINFINITY;
+            }
+
+            dp_matrix.delete_state(i, k) = p7_FLogsum(mmx(i, j) + profile.trans(j, p7P_MD),
+                                                      dmx(i, j) + profile.trans(j, p7P_DD));
+
+            // Local mode: every M and D can end the domain
+            xE = p7_FLogsum(xE, p7_FLogsum(sc, dp_matrix.delete_state(i, k)));
+        }
+
+        dp_matrix.special(i, p7G_E) = xE;
+        dp_matrix.special(i, p7G_J) = p7_FLogsum(dp_matrix.special(i - 1, p7G_J) + t_jloop, xE + t_eloop);
+        dp_matrix.special(i, p7G_C) = p7_FLogsum(dp_matrix.special(i - 1, p7G_C) + t_cloop, xE + t_emove);
+        dp_matrix.special(i, p7G_N) = dp_matrix.special(i - 1, p7G_N) + t_nloop;
+        dp_matrix.special(i, p7G_B) = p7_FLogsum(dp_matrix.special(i, p7G_N) + t_nmove,
+                                                 dp_matrix.special(i, p7G_J) + t_jmove);
+    }
+
+    return dp_matrix.special(L, p7G_C) + t_cmove;
+}
+
+}  // namespace
+
+float compute_forward(const DigitalResidue* digital_sequence, int sequence_length, const HMMProfile& profile,
+                      const SpecialTransitions& specials, float tbmk, DPMatrix& dp_matrix) {
+    assert(dp_matrix.model_length >= profile.model_length && dp_matrix.sequence_length >= sequence_length);
+    return forward_fill(digital_sequence, sequence_length, profile, specials, tbmk, nullptr, dp_matrix);
+}
+
+float compute_forward(const DigitalResidue* digital_sequence, int sequence_length, const HMMProfile& profile,
+                      const LengthConfigCache& config, DPMatrix& dp_matrix) {
+    return compute_forward(digital_sequence, sequence_length, profile, config.for_length(sequence_length),
+                           config.msv_params(sequence_length).tbmk, dp_matrix);
+}
+
+float compute_forward_banded(const DigitalResidue* digital_sequence, int sequence_length,
+                             const HMMProfile& profile, const SpecialTransitions& specials, float tbmk,
+                             const DPBand& band, DPMatrix& dp_matrix) {
+    assert(dp_matrix.model_length >= profile.model_length && dp_matrix.sequence_length >= sequence_length);
+    return forward_fill(digital_sequence, sequence_length, profile, specials, tbmk, &band, dp_matrix);
+}
+
+float compute_forward_banded(const DigitalResidue* digital_sequence, int sequence_length,
+                             const HMMProfile& profile, const SpecialTransitions& specials, float tbmk,
+                             const DPBand& band, BandedDPMatrix& dp_matrix) {
+    dp_matrix.reshape(band);
+    return forward_fill(digital_sequence, sequence_length, profile, specials, tbmk, &dp_matrix.band(), dp_matrix);
+}
@@ -0,0 +1,302 @@
+#include "hmm_file.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+const float AMINO_BACKGROUND[20] = {0.0787945f, 0.0151600f, 0.0535222f, 0.0668298f, 0.0397062f,
+                                    0.0695071f, 0.0229198f, 0.0590092f, 0.0594422f, 0.0963728f,
+                                    0.0237718f, 0.0414386f, 0.0482904f, 0.0395639f, 0.0540978f,
+                                    0.0683364f, 0.0540687f, 0.0673417f, 0.0114135f, 0.0304133f};
+
+namespace {
+
+constexpr int K_AMINO = 20;
+
+// Reads lines and keeps the line number for error messages
+class LineReader {
+public:
+    explicit LineReader(std::istream& in) : in_(in) {}
+
+    bool next(std::string& line) {
+        while (std::getline(in_, line)) {
+            line_number_++;
+            if (line.find_first_not_of(" \t\r") != std::string::npos) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int line_number() const {
+        return line_number_;
+    }
+
+private:
+    std::istream& in_;
+    int line_number_ = 0;
+};
+
+// -ln(p) field to ln(p); "*" is probability zero
+bool parse_neglog(const std::string& field, float& logp) {
+    if (field == "*") {
+        logp = -eslINFINITY;
+        return true;
+    }
+    char* end = nullptr;
+    const float v = std::strtof(field.c_str(), &end);
+    if (end == field.c_str() || *end != '\0') {
+        return false;
+    }
+    logp = -v;
+    return true;
+}
+
+std::vector<std::string> split(const std::string& line) {
+    std::istringstream ss(line);
+    std::vector<std::string> fields;
+    std::string field;
+    while (ss >> field) {
+        fields.push_back(field);
+    }
+    return fields;
+}
+
+// Read `count` -ln(p) fields starting at fields[first]
+bool parse_row(const std::vector<std::string>& fields, size_t first, int count, float* out) {
+    if (fields.size() < first + count) {
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        if (!parse_neglog(fields[first + i], out[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string at_line(const LineReader& reader, const std::string& message) {
+    return "line " + std::to_string(reader.line_number()) + ": " + message;
+}
+
+// One model from its header up to and including "//"; false at clean EOF
+// with `error` empty
+bool read_one(LineReader& reader, const AminoAcidAlphabet& abc, std::vector<HMMProfile>& profiles,
+              std::string& error) {
+    std::string line;
+    if (!reader.next(line)) {
+        return false;
+    }
+    if (line.compare(0, 6, "HMMER3") != 0) {
+        error = at_line(reader, "expected a HMMER3 format tag");
+        return false;
+    }
+
+    // --- A. Header, up to the "HMM" line ---
+    std::string name;
+    int M = 0;
+    float evparam[p7_NEVPARAM] = {};
+    while (true) {
+        if (!reader.next(line)) {
+            error = at_line(reader, "unexpected end of file in header");
+            return false;
+        }
+        const std::vector<std::string> f = split(line);
+        if (f[0] == "NAME" && f.size() >= 2) {
+            name = f[1];
+        } else if (f[0] == "LENG" && f.size() >= 2) {
+            M = std::atoi(f[1].c_str());
+        } else if (f[0] == "ALPH" && f.size() >= 2 && f[1] != "amino") {
+            error = at_line(reader, "only amino models are supported, got " + f[1]);
+            return false;
+        } else if (f[0] == "STATS" && f.size() >= 5 && f[1] == "LOCAL") {
+            const float a = std::strtof(f[3].c_str(), nullptr);
+            const float b = std::strtof(f[4].c_str(), nullptr);
+            if (f[2] == "MSV") {
+                evparam[p7_MMU] = a;
+                evparam[p7_MLAMBDA] = b;
+            } else if (f[2] == "VITERBI") {
+                evparam[p7_VMU] = a;
+                evparam[p7_VLAMBDA] = b;
+            } else if (f[2] == "FORWARD") {
+                evparam[p7_FTAU] = a;
+                evparam[p7_FLAMBDA] = b;
+            }
+        } else if (f[0] == "HMM") {
+            break;
+        }
+    }
+    if (M <= 0) {
+        error = at_line(reader, "missing or invalid LENG");
+        return false;
+    }
+    if (!reader.next(line)) {  // Transition names line
+        error = at_line(reader, "unexpected end of file after HMM line");
+        return false;
+    }
+
+    HMMProfile profile(M, &abc);
+    profile.model_length = M;
+    profile.name = name;
+    profile.max_length = -1;
+    profile.nj = 1.0f;
+    profile.xsc[p7P_E][p7P_LOOP] = -eslCONST_LOG2;
+    profile.xsc[p7P_E][p7P_MOVE] = -eslCONST_LOG2;
+    for (int i = 0; i < p7_NEVPARAM; i++) {
+        profile.evparam[i] = evparam[i];
+    }
+
+    // --- B. Optional COMPO, then node 0's insert and transition lines ---
+    float values[K_AMINO];
+    if (!reader.next(line)) {
+        error = at_line(reader, "unexpected end of file before node 0");
+        return false;
+    }
+    std::vector<std::string> f = split(line);
+    if (f[0] == "COMPO") {
+        if (!parse_row(f, 1, K_AMINO, values)) {
+            error = at_line(reader, "bad COMPO line");
+            return false;
+        }
+        for (int x = 0; x < K_AMINO; x++) {
+            profile.compo[x] = std::exp(values[x]);
+        }
+        if (!reader.next(line)) {
+            error = at_line(reader, "unexpected end of file before node 0");
+            return false;
+        }
+    }
+    // `line` is node 0's insert emissions
+    if (!reader.next(line) || !parse_row(split(line), 0, p7P_NTRANS, values)) {
+        error = at_line(reader, "bad node 0 transition line");
+        return false;
+    }
+    for (int t = 0; t < p7P_NTRANS; t++) {
+        profile.trans(0, t) = values[t];
+    }
+
+    // --- C. Nodes 1..M: match emissions, insert emissions, transitions ---
+    for (int k = 1; k <= M; k++) {
+        if (!reader.next(line)) {
+            error = at_line(reader, "unexpected end of file in node " + std::to_string(k));
+            return false;
+        }
+        f = split(line);
+        if (f[0] != std::to_string(k) || !parse_row(f, 1, K_AMINO, values)) {
+            error = at_line(reader, "bad match emission line for node " + std::to_string(k));
+            return false;
+        }
+        for (int x = 0; x < K_AMINO; x++) {
+            profile.match_score(k, x) = values[x] - std::log(AMINO_BACKGROUND[x]);
+        }
+        if (!reader.next(line) || !parse_row(split(line), 0, K_AMINO, values)) {
+            error = at_line(reader, "bad insert emission line for node " + std::to_string(k));
+            return false;
+        }
+        if (k < M) {
+            for (int x = 0; x < K_AMINO; x++) {
+                profile.insert_score(k, x) = 0.0f;
+            }
+        }
+        if (!reader.next(line) || !parse_row(split(line), 0, p7P_NTRANS, values)) {
+            error = at_line(reader, "bad transition line for node " + std::to_string(k));
+            return false;
+        }
+        if (k < M) {
+            for (int t = 0; t < p7P_NTRANS; t++) {
+                profile.trans(k, t) = values[t];
+            }
+        }
+    }
+
+    if (!reader.next(line) || line.compare(0, 2, "//") != 0) {
+        error = at_line(reader, "expected // after node " + std::to_string(M));
+        return false;
+    }
+    profiles.push_back(std::move(profile));
+    return true;
+}
+
+void write_neglog(std::ostream& out, float logp) {
+    char buffer[32];
+    if (logp == -eslINFINITY) {
+        std::snprintf(buffer, sizeof(buffer), " %8s", "*");
+    } else {
+        std::snprintf(buffer, sizeof(buffer), " %8.5f", -logp);
+    }
+    out << buffer;
+}
+
+}  // namespace
+
+bool read_hmm_file(std::istream& in, const AminoAcidAlphabet& abc, std::vector<HMMProfile>& profiles,
+                   std::string& error) {
+    LineReader reader(in);
+    error.clear();
+    while (read_one(reader, abc, profiles, error)) {
+    }
+    return error.empty();
+}
+
+bool read_hmm_file(const std::string& path, const AminoAcidAlphabet& abc, std::vector<HMMProfile>& profiles,
+                   std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    if (!read_hmm_file(in, abc, profiles, error)) {
+        error = path + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+void write_hmm(std::ostream& out, const HMMProfile& profile) {
+    const int M = profile.model_length;
+    out << "HMMER3/f [msv_filter]\n";
+    out << "NAME  " << (profile.name.empty() ? "unnamed" : profile.name) << "\n";
+    out << "LENG  " << M << "\n";
+    out << "ALPH  amino\n";
+    if (profile.evparam[p7_MLAMBDA] > 0.0f) {
+        out << "STATS LOCAL MSV      " << profile.evparam[p7_MMU] << " " << profile.evparam[p7_MLAMBDA] << "\n";
+        out << "STATS LOCAL VITERBI  " << profile.evparam[p7_VMU] << " " << profile.evparam[p7_VLAMBDA] << "\n";
+        out << "STATS LOCAL FORWARD  " << profile.evparam[p7_FTAU] << " " << profile.evparam[p7_FLAMBDA] << "\n";
+    }
+    out << "HMM     ";
+    for (int x = 0; x < K_AMINO; x++) {
+        out << "    " << profile.abc->sym[x] << "    ";
+    }
+    out << "\n        m->m     m->i     m->d     i->m     i->i     d->m     d->d\n";
+
+    // Insert emissions are the background (zero insert scores)
+    auto write_inserts = [&]() {
+        out << "       ";
+        for (int x = 0; x < K_AMINO; x++) {
+            write_neglog(out, std::log(AMINO_BACKGROUND[x]));
+        }
+        out << "\n";
+    };
+    auto write_transitions = [&](int k) {
+        out << "       ";
+        for (int t = 0; t < p7P_NTRANS; t++) {
+            write_neglog(out, k < M ? profile.trans(k, t) : (t == p7P_MM || t == p7P_DM ? 0.0f : -eslINFINITY));
+        }
+        out << "\n";
+    };
+
+    write_inserts();
+    write_transitions(0);
+    for (int k = 1; k <= M; k++) {
+        out << "  " << k << "  ";
+        for (int x = 0; x < K_AMINO; x++) {
+            write_neglog(out, profile.match_score(k, x) + std::log(AMINO_BACKGROUND[x]));
+        }
+        out << "\n";
+        write_inserts();
+        write_transitions(k);
+    }
+    out << "//\n";
+}
@@ -0,0 +1,105 @@
+#include "incremental_msv.hpp"
+
+#include <algorithm>
+
+IncrementalMSV::IncrementalMSV(HMMProfile& profile)
+    : profile_(profile), edited_(profile.model_length + 1, false) {}
+
+float IncrementalMSV::scan_diagonal(const Entry& entry, int d) const {
+    const int M = profile_.model_length;
+    const int L = entry.sequence_length;
+    const int K = profile_.abc->K;
+
+    // First cell of the diagonal is (i0, i0 + d); walk until either edge
+    int i = std::max(1, 1 - d);
+    float value = 0.0f;
+    float best = 0.0f;
+    for (; i <= L && i + d <= M; i++) {
+        const DigitalResidue residue = entry.digital_sequence[i];
+        if (residue >= K) {
+            value = 0.0f;  // Non-canonical residue resets the segment
+            continue;
+        }
+        value = std::max(0.0f, value + profile_.match_score(i + d, residue));
+        best = std::max(best, value);
+    }
+    return best;
+}
+
+int IncrementalMSV::add_sequence(const DigitalResidue* digital_sequence, int sequence_length) {
+    const int M = profile_.model_length;
+    Entry entry;
+    entry.digital_sequence.assign(digital_sequence, digital_sequence + std::max(0, sequence_length) + 2);
+    entry.sequence_length = std::max(0, sequence_length);
+    entry.score = 0.0f;
+
+    if (M > 0 && entry.sequence_length > 0) {
+        const int L = entry.sequence_length;
+        entry.diagonal_max.resize(M + L - 1);
+        for (int d = 1 - L; d <= M - 1; d++) {
+            entry.diagonal_max[d + L - 1] = scan_diagonal(entry, d);
+        }
+        entry.score = *std::max_element(entry.diagonal_max.begin(), entry.diagonal_max.end());
+    }
+
+    entries_.push_back(std::move(entry));
+    return static_cast<int>(entries_.size()) - 1;
+}
+
+void IncrementalMSV::set_match_score(int k, int residue, float value) {
+    profile_.match_score(k, residue) = value;
+    mark_column_edited(k);
+}
+
+void IncrementalMSV::mark_column_edited(int k) {
+    if (k >= 1 && k < static_cast<int>(edited_.size())) {
+        edited_[k] = true;
+        any_edited_ = true;
+    }
+}
+
+RescoreStats IncrementalMSV::rescore() {
+    const int M = profile_.model_length;
+    RescoreStats stats;
+
+    std::vector<int> columns;
+    for (int k = 1; k <= M; k++) {
+        if (edited_[k]) {
+            columns.push_back(k);
+        }
+    }
+
+    for (Entry& entry : entries_) {
+        const int L = entry.sequence_length;
+        stats.sequences++;
+        if (M <= 0 || L <= 0) {
+            continue;
+        }
+        stats.diagonals_total += static_cast<uint64_t>(M + L - 1);
+        stats.cells_total += static_cast<uint64_t>(M) * static_cast<uint64_t>(L);
+        if (!any_edited_) {
+            continue;
+        }
+
+        // Column k is crossed by diagonals [k-L, k-1]; with columns sorted,
+        // these intervals arrive in order and overlapping ones are merged.
+        int next_d = 1 - L;  // Lowest diagonal not yet rescored
+        for (int k : columns) {
+            const int lo = std::max(next_d, k - L);
+            const int hi = k - 1;
+            for (int d = lo; d <= hi; d++) {
+                entry.diagonal_max[d + L - 1] = scan_diagonal(entry, d);
+                stats.diagonals_rescored++;
+                const int i_first = std::max(1, 1 - d);
+                const int i_last = std::min(L, M - d);
+                stats.cells_rescored += static_cast<uint64_t>(std::max(0, i_last - i_first + 1));
+            }
+            next_d = std::max(next_d, hi + 1);
+        }
+        entry.score = *std::max_element(entry.diagonal_max.begin(), entry.diagonal_max.end());
+    }
+
+    std::fill(edited_.begin(), edited_.end(), false);
+    any_edited_ = false;
+    return stats;
+}
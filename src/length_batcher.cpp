@@ -0,0 +1,114 @@
+#include "length_batcher.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+LengthBatcher::LengthBatcher(int lanes, std::vector<int> bucket_bounds)
+    : lanes_(std::max(1, lanes)), bucket_bounds_(std::move(bucket_bounds))
+{
+    // Bounds must be ascending and unique for the binary search in bucket_of()
+    std::sort(bucket_bounds_.begin(), bucket_bounds_.end());
+    bucket_bounds_.erase(std::unique(bucket_bounds_.begin(), bucket_bounds_.end()), bucket_bounds_.end());
+}
+
+std::vector<int> LengthBatcher::uniform_bounds(int width, int max_length) {
+    std::vector<int> bounds;
+    width = std::max(1, width);
+    for (int bound = width; bound < max_length + width; bound += width) {
+        bounds.push_back(bound);
+    }
+    return bounds;
+}
+
+std::vector<int> LengthBatcher::geometric_bounds(int first_width, double ratio, int max_length) {
+    std::vector<int> bounds;
+    double width = std::max(1, first_width);
+    ratio = std::max(1.0, ratio);
+    int bound = 0;
+    while (bound < max_length) {
+        bound += std::max(1, static_cast<int>(std::lround(width)));
+        bounds.push_back(bound);
+        width *= ratio;
+    }
+    return bounds;
+}
+
+int LengthBatcher::bucket_of(int length) const {
+    auto it = std::lower_bound(bucket_bounds_.begin(), bucket_bounds_.end(), length);
+    return static_cast<int>(it - bucket_bounds_.begin());
+}
+
+std::vector<SequenceBatch> LengthBatcher::make_batches(const std::vector<int>& lengths) const {
+    // --- A. Distribute sequence indices into buckets ---
+    std::vector<std::vector<int>> buckets(num_buckets());
+    for (int idx = 0; idx < static_cast<int>(lengths.size()); idx++) {
+        buckets[bucket_of(lengths[idx])].push_back(idx);
+    }
+
+    // --- B. Cut each bucket into batches, longest members first ---
+    // Sorting inside a bucket keeps the tail of each batch as close to its
+    // head as the bucket width allows; stable so equal lengths keep input order.
+    std::vector<SequenceBatch> batches;
+    for (int b = 0; b < num_buckets(); b++) {
+        std::vector<int>& members = buckets[b];
+        std::stable_sort(members.begin(), members.end(),
+                         [&lengths](int x, int y) { return lengths[x] > lengths[y]; });
+
+        for (size_t start = 0; start < members.size(); start += lanes_) {
+            size_t end = std::min(members.size(), start + lanes_);
+            SequenceBatch batch;
+            batch.bucket = b;
+            batch.max_length = lengths[members[start]];
+            batch.members.assign(members.begin() + start, members.begin() + end);
+            batches.push_back(std::move(batch));
+        }
+    }
+    return batches;
+}
+
+std::vector<SequenceBatch> LengthBatcher::make_batches(
+    const std::vector<std::vector<DigitalResidue>>& sequences) const
+{
+    std::vector<int> lengths(sequences.size());
+    for (size_t i = 0; i < sequences.size(); i++) {
+        lengths[i] = sequence_length_of(sequences[i]);
+    }
+    return make_batches(lengths);
+}
+
+std::vector<SequenceBatch> LengthBatcher::naive_batches(const std::vector<int>& lengths) const {
+    std::vector<SequenceBatch> batches;
+    for (size_t start = 0; start < lengths.size(); start += lanes_) {
+        size_t end = std::min(lengths.size(), start + lanes_);
+        SequenceBatch batch;
+        batch.bucket = 0;
+        batch.max_length = 0;
+        for (size_t idx = start; idx < end; idx++) {
+            batch.members.push_back(static_cast<int>(idx));
+            batch.max_length = std::max(batch.max_length, lengths[idx]);
+        }
+        batches.push_back(std::move(batch));
+    }
+    return batches;
+}
+
+BatchReport LengthBatcher::measure(const std::vector<SequenceBatch>& batches, const std::vector<int>& lengths) const {
+    BatchReport report;
+    report.per_bucket.resize(num_buckets());
+
+    for (const SequenceBatch& batch : batches) {
+        LaneOccupancy stats;
+        stats.batches = 1;
+        stats.sequences = static_cast<int64_t>(batch.members.size());
+        stats.lane_slots = static_cast<int64_t>(lanes_) * batch.max_length;
+        for (int idx : batch.members) {
+            stats.residue_slots += lengths[idx];
+        }
+
+        if (batch.bucket >= 0 && batch.bucket < num_buckets()) {
+            report.per_bucket[batch.bucket].add(stats);
+        }
+        report.total.add(stats);
+    }
+    return report;
+}
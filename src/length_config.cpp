@@ -0,0 +1,68 @@
+#include "length_config.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+LengthConfigCache::LengthConfigCache(const HMMProfile& profile, float expected_hit_count, int max_cached_length)
+    : nj_(profile.nj)
+{
+    // --- A. L-independent values ---
+    for (int s = 0; s < p7P_NXSTATES; s++) {
+        for (int t = 0; t < p7P_NXTRANS; t++) {
+            base_.xsc[s][t] = profile.xsc[s][t];
+        }
+    }
+    base_.sequence_length = 0;
+
+    const float M = static_cast<float>(std::max(1, profile.model_length));
+    tbmk_ = std::log(2.0f / (M * (M + 1.0f)));
+    tej_ = std::log((expected_hit_count - 1.0f) / expected_hit_count);
+    tec_ = std::log(1.0f / expected_hit_count);
+
+    // --- B. Length-dependent logs for L = 0..max_cached_length ---
+    max_cached_length = std::max(0, max_cached_length);
+    loop_move_.resize(max_cached_length + 1);
+    msv_loop_.resize(max_cached_length + 1);
+    for (int L = 0; L <= max_cached_length; L++) {
+        loop_move_[L] = profile_loop_move(L, nj_);
+        msv_loop_[L] = msv_loop_move(L);
+    }
+}
+
+LengthConfigCache::LoopMove LengthConfigCache::profile_loop_move(int sequence_length, float nj) {
+    // p7_ReconfigLength: pmove = (2 + nj) / (L + 2 + nj); 2/(L+2) unihit, 3/(L+3) multihit
+    const float L = static_cast<float>(sequence_length);
+    const float pmove = (2.0f + nj) / (L + 2.0f + nj);
+    const float ploop = 1.0f - pmove;
+    return {std::log(ploop), std::log(pmove)};
+}
+
+LengthConfigCache::LoopMove LengthConfigCache::msv_loop_move(int sequence_length) {
+    const float L = static_cast<float>(sequence_length);
+    return {std::log(L / (L + 3.0f)), std::log(3.0f / (L + 3.0f))};
+}
+
+SpecialTransitions LengthConfigCache::for_length(int sequence_length) const {
+    sequence_length = std::max(0, sequence_length);
+    const LoopMove lm = sequence_length <= max_cached_length() ? loop_move_[sequence_length]
+                                                               : profile_loop_move(sequence_length, nj_);
+    SpecialTransitions st = base_;
+    st.sequence_length = sequence_length;
+    st.xsc[p7P_N][p7P_LOOP] = st.xsc[p7P_C][p7P_LOOP] = st.xsc[p7P_J][p7P_LOOP] = lm.loop;
+    st.xsc[p7P_N][p7P_MOVE] = st.xsc[p7P_C][p7P_MOVE] = st.xsc[p7P_J][p7P_MOVE] = lm.move;
+    return st;
+}
+
+MSVLengthParams LengthConfigCache::msv_params(int sequence_length) const {
+    sequence_length = std::max(0, sequence_length);
+    const LoopMove lm = sequence_length <= max_cached_length() ? msv_loop_[sequence_length]
+                                                               : msv_loop_move(sequence_length);
+    return {lm.loop, lm.move, tbmk_, tej_, tec_};
+}
+
+void LengthConfigCache::reconfigure(HMMProfile& profile, int sequence_length) {
+    const LoopMove lm = profile_loop_move(sequence_length, profile.nj);
+    profile.xsc[p7P_N][p7P_LOOP] = profile.xsc[p7P_C][p7P_LOOP] = profile.xsc[p7P_J][p7P_LOOP] = lm.loop;
+    profile.xsc[p7P_N][p7P_MOVE] = profile.xsc[p7P_C][p7P_MOVE] = profile.xsc[p7P_J][p7P_MOVE] = lm.move;
+    profile.sequence_length = sequence_length;
+}
@@ -0,0 +1,15 @@
+#include "logsum.hpp"
+
+#include <cmath>
+#include <vector>
+
+const float* p7_flogsum_table() {
+    static const std::vector<float> table = []() {
+        std::vector<float> t(p7_LOGSUM_TBL);
+        for (int i = 0; i < p7_LOGSUM_TBL; i++) {
+            t[i] = static_cast<float>(std::log1p(std::exp(-static_cast<double>(i) / p7_LOGSUM_SCALE)));
+        }
+        return t;
+    }();
+    return table.data();
+}
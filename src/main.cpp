@@ -14,11 +14,26 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
+#include <cstring>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <cerrno>
+#include <cstdlib>
+#include <limits>
+#include <numeric>
 #include "hmmer_types.hpp"
 #include "aa_alphabet.hpp"
 #include "profile.hpp"
 #include "dp_matrix.hpp"
 #include "mock_data.hpp"
+#include "perf_counters.hpp"
+#include "run_stats.hpp"
+#include "pipeline.hpp"
+#include "hmm_file.hpp"
+#include "sequence_db.hpp"
+#include "search_daemon.hpp"
+#include "multi_search.hpp"
 
 /*******************************************************************************
  * Example signature of the MSV function to be implemented:
@@ -35,7 +50,269 @@
  *   - msv_score: Return value for MSV score
  ******************************************************************************/
 
-int main() {
+/*******************************************************************************
+ * Mock database search
+ *
+ * Runs a deterministic mock database with planted hits through the filter
+ * pipeline (SSV, MSV, bias, Viterbi, Forward) against a gapped pattern
+ * profile; per-stage counts and timings land in the run statistics. With a
+ * perf registry (--perf) every kernel call the pipeline makes is measured.
+ ******************************************************************************/
+
+static void run_mock_search(const AminoAcidAlphabet& abc, bool seg_mask, RunStats& stats,
+                            KernelPerfRegistry* perf_registry) {
+    const int model_length = 40;
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(model_length, abc);
+    std::vector<std::vector<DigitalResidue>> database =
+        MockDataGenerator::create_mock_database(2000, 50, 800, abc, 0.05, model_length);
+
+    PipelineConfig config;
+    config.do_seg_mask = seg_mask;
+    Pipeline pipeline(profile, config, stats);
+    pipeline.set_perf_registry(perf_registry);
+    for (const std::vector<DigitalResidue>& digital_sequence : database) {
+        pipeline.run(digital_sequence.data(), static_cast<int>(digital_sequence.size()) - 2);
+    }
+
+    std::cout << "    Sequences: " << database.size() << " (F1=" << config.F1 << ", F2=" << config.F2
+              << ", F3=" << config.F3 << ", bias filter " << (config.do_biasfilter ? "on" : "off")
+              << ", SEG masking " << (config.do_seg_mask ? "on" : "off") << ")"
+              << std::endl;
+    for (const StageStats& stage : stats.stages()) {
+        std::cout << "    " << stage.name << ": " << stage.sequences_passed << " / " << stage.sequences_in
+                  << " passed, " << stage.seconds * 1e3 << " ms, GCUPS " << stage.gcups() << std::endl;
+    }
+}
+
+static void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " [--perf] [--seg] [--stats-json FILE]" << std::endl;
+    std::cerr << "       " << program << " daemon --socket PATH --db FASTA --profiles HMMFILE [--threads N]"
+              << " [--coalesce-ms MS] [--seg]" << std::endl;
+    std::cerr << "       " << program << " query --socket PATH COMMAND..." << std::endl;
+    std::cerr << "       " << program << " search --db FASTA --profiles HMMFILE [--threads N] [--tile-kb KB] [--seg]"
+              << " [--stats-json FILE]" << std::endl;
+    std::cerr << "  --perf             Measure the mock search's kernel calls with hardware performance counters" << std::endl;
+    std::cerr << "  --seg              Mask low-complexity regions before the filter pipeline" << std::endl;
+    std::cerr << "  --stats-json FILE  Write run statistics as JSON to FILE ('-' for stdout, which then carries"
+              << " only the JSON; everything else goes to stderr)" << std::endl;
+    std::cerr << "  daemon             Keep FASTA and HMMFILE resident and answer queries on a Unix socket" << std::endl;
+    std::cerr << "  --coalesce-ms MS   Batch SEARCH requests arriving within MS into one database pass"
+              << " (default 5, 0 = off)" << std::endl;
+    std::cerr << "  query              Send one request (SEARCH name, LIST, PING, SHUTDOWN) to a daemon" << std::endl;
+    std::cerr << "  search             Run every profile in HMMFILE against FASTA in one tiled pass" << std::endl;
+    std::cerr << "  --tile-kb KB       Profile tile budget (default: half of L2)" << std::endl;
+}
+
+/*******************************************************************************
+ * Search daemon (daemon / query subcommands)
+ *
+ * "daemon" loads the database and profile library once and serves queries
+ * until a SHUTDOWN request; "query" is the matching one-shot client.
+ ******************************************************************************/
+
+static int run_daemon(int argc, char** argv) {
+    std::string socket_path;
+    std::string db_path;
+    std::string profiles_path;
+    SearchDaemonConfig config;
+    for (int a = 2; a < argc; a++) {
+        if (std::strcmp(argv[a], "--socket") == 0 && a + 1 < argc) {
+            socket_path = argv[++a];
+        } else if (std::strcmp(argv[a], "--db") == 0 && a + 1 < argc) {
+            db_path = argv[++a];
+        } else if (std::strcmp(argv[a], "--profiles") == 0 && a + 1 < argc) {
+            profiles_path = argv[++a];
+        } else if (std::strcmp(argv[a], "--threads") == 0 && a + 1 < argc) {
+            config.search.num_threads = std::atoi(argv[++a]);
+        } else if (std::strcmp(argv[a], "--coalesce-ms") == 0 && a + 1 < argc) {
+            config.coalesce_window_ms = std::atoi(argv[++a]);
+        } else if (std::strcmp(argv[a], "--seg") == 0) {
+            config.search.pipeline.do_seg_mask = true;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (socket_path.empty() || db_path.empty() || profiles_path.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    AminoAcidAlphabet abc;
+    std::string error;
+    SequenceDatabase db(abc);
+    std::vector<HMMProfile> profiles;
+    if (!db.load_fasta(db_path, error) || !read_hmm_file(profiles_path, abc, profiles, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    SearchDaemon daemon(db, profiles, config);
+    if (!daemon.listen(socket_path, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    std::cerr << "Serving " << profiles.size() << " profiles against " << db.size() << " sequences ("
+              << db.residues() << " residues) on " << socket_path << std::endl;
+    daemon.serve();
+    return 0;
+}
+
+static int run_query(int argc, char** argv) {
+    std::string socket_path;
+    std::string request;
+    for (int a = 2; a < argc; a++) {
+        if (std::strcmp(argv[a], "--socket") == 0 && a + 1 < argc) {
+            socket_path = argv[++a];
+        } else {
+            request += (request.empty() ? "" : " ") + std::string(argv[a]);
+        }
+    }
+    if (socket_path.empty() || request.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<std::string> reply;
+    std::string error;
+    if (!daemon_request(socket_path, request, reply, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    for (const std::string& line : reply) {
+        std::cout << line << std::endl;
+    }
+    return reply.back().compare(0, 3, "ERR") == 0 ? 1 : 0;
+}
+
+/*******************************************************************************
+ * Multi-profile search (search subcommand)
+ *
+ * Runs a whole profile library against a FASTA database in one pass over
+ * the database (multi_search.hpp) and prints one line per hit.
+ ******************************************************************************/
+
+static int run_search(int argc, char** argv) {
+    std::string db_path;
+    std::string profiles_path;
+    std::string stats_json_path;
+    MultiSearchConfig config;
+    for (int a = 2; a < argc; a++) {
+        if (std::strcmp(argv[a], "--db") == 0 && a + 1 < argc) {
+            db_path = argv[++a];
+        } else if (std::strcmp(argv[a], "--profiles") == 0 && a + 1 < argc) {
+            profiles_path = argv[++a];
+        } else if (std::strcmp(argv[a], "--threads") == 0 && a + 1 < argc) {
+            config.num_threads = std::atoi(argv[++a]);
+        } else if (std::strcmp(argv[a], "--tile-kb") == 0 && a + 1 < argc) {
+            char* end = nullptr;
+            errno = 0;
+            const long kb = std::strtol(argv[++a], &end, 10);
+            if (end == argv[a] || *end != '\0' || errno == ERANGE || kb <= 0 ||
+                static_cast<unsigned long>(kb) > std::numeric_limits<size_t>::max() / 1024) {
+                std::cerr << "--tile-kb needs a positive number of kilobytes, got '" << argv[a] << "'" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+            config.tile_bytes = static_cast<size_t>(kb) * 1024;
+        } else if (std::strcmp(argv[a], "--seg") == 0) {
+            config.pipeline.do_seg_mask = true;
+        } else if (std::strcmp(argv[a], "--stats-json") == 0 && a + 1 < argc) {
+            stats_json_path = argv[++a];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (db_path.empty() || profiles_path.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    RunStats run_stats;
+    run_stats.set_label("program", "msv_filter search");
+    AminoAcidAlphabet abc;
+    std::string error;
+    SequenceDatabase db(abc);
+    std::vector<HMMProfile> profiles;
+    if (!db.load_fasta(db_path, error) || !read_hmm_file(profiles_path, abc, profiles, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    MultiProfileSearch search(db, profiles, config);
+    std::vector<SearchResult> results = search.search_all();
+
+    // With --stats-json -, stdout carries only the JSON
+    std::ostream& hits_out = stats_json_path == "-" ? std::cerr : std::cout;
+    hits_out << "# profile\tsequence\tbits\tpvalue\tevalue" << std::endl;
+    for (size_t p = 0; p < results.size(); p++) {
+        for (const SearchHit& hit : results[p].hits) {
+            hits_out << profiles[p].name << "\t" << db.name(hit.sequence) << "\t" << hit.bits << "\t" << hit.pvalue
+                      << "\t" << hit.evalue << std::endl;
+        }
+    }
+    std::vector<int> library(profiles.size());
+    std::iota(library.begin(), library.end(), 0);
+    const double milliseconds = results.empty() ? 0.0 : results.front().milliseconds;
+    std::cerr << profiles.size() << " profiles x " << db.size() << " sequences (" << db.residues()
+              << " residues) in " << milliseconds << " ms: "
+              << make_profile_tiles(search.profile_bytes(), library, search.tile_bytes()).size() << " profile tiles of <= "
+              << search.tile_bytes() / 1024 << " KB x " << search.blocks().size() << " database blocks"
+              << std::endl;
+
+    search.collect_stats(run_stats);
+    run_stats.add_input(static_cast<uint64_t>(db.size()), static_cast<uint64_t>(db.residues()));
+    run_stats.finish();
+    if (stats_json_path == "-") {
+        run_stats.write_json(std::cout);
+    } else if (!stats_json_path.empty()) {
+        std::ofstream stats_out(stats_json_path);
+        if (!stats_out) {
+            std::cerr << "Cannot write stats to " << stats_json_path << std::endl;
+            return 1;
+        }
+        run_stats.write_json(stats_out);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "search") == 0) {
+        return run_search(argc, argv);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "daemon") == 0) {
+        return run_daemon(argc, argv);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "query") == 0) {
+        return run_query(argc, argv);
+    }
+
+    bool perf_report = false;
+    bool seg_mask = false;
+    std::string stats_json_path;
+    for (int a = 1; a < argc; a++) {
+        if (std::strcmp(argv[a], "--perf") == 0) {
+            perf_report = true;
+        } else if (std::strcmp(argv[a], "--seg") == 0) {
+            seg_mask = true;
+        } else if (std::strcmp(argv[a], "--stats-json") == 0 && a + 1 < argc) {
+            stats_json_path = argv[++a];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    RunStats run_stats;
+    run_stats.set_label("program", "msv_filter");
+
+    // With --stats-json -, stdout carries only the JSON: the report below
+    // goes to stderr until it is written
+    std::streambuf* const stdout_buffer = std::cout.rdbuf();
+    if (stats_json_path == "-") {
+        std::cout.rdbuf(std::cerr.rdbuf());
+    }
+
     std::cout << "========================================" << std::endl;
     std::cout << "MSV Filter - Mock Input Generator" << std::endl;
     std::cout << "========================================" << std::endl;
@@ -127,6 +404,35 @@ int main() {
     std::cout << "  - gm->model_length (model length)" << std::endl;
     std::cout << "  - gx->dp[i][k * 3 + 0] (match states)" << std::endl;
     std::cout << "  - gx->xmx[i * 5 + s] (special states: E,N,J,B,C)" << std::endl;
+
+    // --- Step 8: Score a mock database ---
+    std::cout << "\n[8] Running mock database through the filter pipeline..." << std::endl;
+    KernelPerfRegistry perf_registry;
+    run_mock_search(abc, seg_mask, run_stats, perf_report ? &perf_registry : nullptr);
+
+    // --- Step 9: Optional kernel performance counters ---
+    if (perf_report) {
+        std::cout << "\n[9] Kernel performance counters (mock search)..." << std::endl;
+        if (!PerfCounterGroup().available()) {
+            std::cout << "    Hardware counters unavailable (perf_event_open failed); reporting wall time only"
+                      << std::endl;
+        }
+        perf_registry.report(std::cout);
+    }
+
+    // --- Run statistics ---
+    run_stats.finish();
+    std::cout.rdbuf(stdout_buffer);
+    if (stats_json_path == "-") {
+        run_stats.write_json(std::cout);
+    } else if (!stats_json_path.empty()) {
+        std::ofstream stats_out(stats_json_path);
+        if (!stats_out) {
+            std::cerr << "Cannot write stats to " << stats_json_path << std::endl;
+            return 1;
+        }
+        run_stats.write_json(stats_out);
+    }
     
     return 0;
 }
@@ -0,0 +1,53 @@
+#include "msv_generic.hpp"
+
+#include <algorithm>
+
+float compute_msv_generic(const DigitalResidue* digital_sequence, int sequence_length, const HMMProfile& profile,
+                          const MSVLengthParams& params, std::vector<float>& row_buffer) {
+    const int M = profile.model_length;
+    const int L = sequence_length;
+    if (M <= 0 || L < 0) {
+        return -eslINFINITY;
+    }
+
+    // Row 0: only N and B are reachable
+    row_buffer.assign(static_cast<size_t>(M) + 1, -eslINFINITY);
+    float* mmx = row_buffer.data();
+    float xN = 0.0f;
+    float xB = params.tmove;
+    float xJ = -eslINFINITY;
+    float xC = -eslINFINITY;
+
+    for (int i = 1; i <= L; i++) {
+        const DigitalResidue x = digital_sequence[i];
+        float xE = -eslINFINITY;
+        if (x < profile.abc->Kp) {
+            // k descending so mmx[k-1] still holds row i-1
+            const float entry = xB + params.tbmk;
+            for (int k = M; k >= 1; k--) {
+                const float sc = std::max(mmx[k - 1], entry) + profile.match_score(k, x);
+                mmx[k] = sc;
+                xE = std::max(xE, sc);
+            }
+        } else {
+            std::fill(mmx + 1, mmx + M + 1, -eslINFINITY);
+        }
+
+        xJ = std::max(xJ + params.tloop, xE + params.tej);
+        xC = std::max(xC + params.tloop, xE + params.tec);
+        xN = xN + params.tloop;
+        xB = std::max(xN + params.tmove, xJ + params.tmove);
+    }
+    return xC + params.tmove;
+}
+
+float compute_msv_generic(const DigitalResidue* digital_sequence, int sequence_length, const HMMProfile& profile,
+                          const LengthConfigCache& config, std::vector<float>& row_buffer) {
+    return compute_msv_generic(digital_sequence, sequence_length, profile, config.msv_params(sequence_length),
+                               row_buffer);
+}
+
+float ssv_sequence_score(float segment_nats, int sequence_length, const MSVLengthParams& params) {
+    return segment_nats + params.tmove + params.tbmk + params.tec + params.tmove +
+           static_cast<float>(sequence_length) * params.tloop;
+}
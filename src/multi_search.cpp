@@ -0,0 +1,129 @@
+#include "multi_search.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+size_t l2_cache_bytes() {
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    const long bytes = ::sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if (bytes > 0) {
+        return static_cast<size_t>(bytes);
+    }
+#endif
+    return size_t(1) << 20;
+}
+
+size_t profile_tile_bytes(const PipelineProfile& tables) {
+    const ViterbiWordProfile& om = tables.viterbi_profile;
+    size_t bytes = tables.ssv_table.scores.size() * sizeof(tables.ssv_table.scores[0]);
+    bytes += tables.seed_table.scores.size() * sizeof(tables.seed_table.scores[0]);
+    bytes += (om.match.size() + om.insert.size() + om.trans.size()) * sizeof(WordVector);
+    for (const std::vector<float>& row : tables.profile.rsc) {
+        bytes += row.size() * sizeof(float);
+    }
+    return bytes + tables.profile.tsc.size() * sizeof(float);
+}
+
+std::vector<std::vector<int>> make_profile_tiles(const std::vector<size_t>& profile_bytes,
+                                                 const std::vector<int>& profiles, size_t tile_bytes) {
+    std::vector<std::vector<int>> tiles;
+    size_t filled = 0;
+    for (size_t q = 0; q < profiles.size(); q++) {
+        const size_t bytes = profile_bytes[profiles[q]];
+        if (tiles.empty() || filled + bytes > tile_bytes) {
+            tiles.emplace_back();
+            filled = 0;
+        }
+        tiles.back().push_back(static_cast<int>(q));
+        filled += bytes;
+    }
+    return tiles;
+}
+
+MultiProfileSearch::MultiProfileSearch(const SequenceDatabase& db, const std::vector<HMMProfile>& profiles,
+                                       const MultiSearchConfig& config)
+    : db_(db), profiles_(profiles), tile_bytes_(config.tile_bytes > 0 ? config.tile_bytes : l2_cache_bytes() / 2),
+      blocks_(db.chunks(config.chunk_residues)), pool_(config.num_threads) {
+    for (const HMMProfile& profile : profiles_) {
+        tables_.push_back(std::make_unique<PipelineProfile>(profile, config.pipeline));
+        profile_bytes_.push_back(profile_tile_bytes(*tables_.back()));
+    }
+    for (int w = 0; w < pool_.size(); w++) {
+        auto state = std::make_unique<WorkerState>();
+        for (const std::unique_ptr<PipelineProfile>& tables : tables_) {
+            state->pipelines.push_back(std::make_unique<Pipeline>(*tables, state->scratch, state->stats));
+        }
+        workers_.push_back(std::move(state));
+    }
+}
+
+std::vector<SearchResult> MultiProfileSearch::search(const std::vector<int>& profiles) {
+    const auto start = std::chrono::steady_clock::now();
+    const size_t P = profiles.size();
+    const size_t B = blocks_.size();
+    const double Z = static_cast<double>(db_.size());
+
+    for (int p : profiles) {
+        if (p < 0 || static_cast<size_t>(p) >= profiles_.size()) {
+            throw std::out_of_range("profile index " + std::to_string(p) + " outside the library");
+        }
+    }
+    const std::vector<std::vector<int>> tiles = make_profile_tiles(profile_bytes_, profiles, tile_bytes_);
+
+    std::vector<std::vector<SearchHit>> block_hits(P * B);  // [q * B + b]
+    pool_.parallel_for(static_cast<int>(B), [&](int b, int worker) {
+        WorkerState& state = *workers_[worker];
+        for (const std::vector<int>& tile : tiles) {
+            for (int s = blocks_[b].first; s < blocks_[b].last; s++) {
+                const DigitalResidue* digital_sequence = db_.sequence(s);
+                const int L = db_.length(s);
+                for (int q : tile) {
+                    const PipelineResult r = state.pipelines[profiles[q]]->run(digital_sequence, L);
+                    if (r.passed) {
+                        block_hits[q * B + b].push_back({s, r.forward_bits, r.pvalue, r.pvalue * Z});
+                    }
+                }
+            }
+        }
+    });
+
+    const double milliseconds =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::vector<SearchResult> results(P);
+    for (size_t q = 0; q < P; q++) {
+        SearchResult& result = results[q];
+        for (size_t b = 0; b < B; b++) {
+            const std::vector<SearchHit>& hits = block_hits[q * B + b];
+            result.hits.insert(result.hits.end(), hits.begin(), hits.end());
+        }
+        std::sort(result.hits.begin(), result.hits.end(), [](const SearchHit& a, const SearchHit& b) {
+            return a.pvalue < b.pvalue || (a.pvalue == b.pvalue && a.sequence < b.sequence);
+        });
+        result.sequences = db_.size();
+        result.milliseconds = milliseconds;
+        result.batch_profiles = static_cast<int>(P);
+    }
+    return results;
+}
+
+std::vector<SearchResult> MultiProfileSearch::search_all() {
+    std::vector<int> all(profiles_.size());
+    for (size_t p = 0; p < all.size(); p++) {
+        all[p] = static_cast<int>(p);
+    }
+    return search(all);
+}
+
+void MultiProfileSearch::collect_stats(RunStats& run) const {
+    for (const std::unique_ptr<WorkerState>& worker : workers_) {
+        for (const StageStats& stage : worker->stats.stages()) {
+            StageStats& total = run.stage(stage.name);
+            total.threshold = stage.threshold;
+            total.threshold_kind = stage.threshold_kind;
+            total.merge(stage);
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#include "nt_alphabet.hpp"
+#include "alphabet_traits.hpp"
+
+NucleotideAlphabet::NucleotideAlphabet(bool rna) {
+  // Tables are generated at compile time (NucleotideTraits): Easel DNA symbol
+  // order, case-insensitive input with U read as T, and IUPAC degeneracy.
+  load_tables<NucleotideTraits>();
+  if (rna) {
+    type = eslRNA;
+    sym[3] = 'U';
+  }
+}
+
+bool PackedNucleotideSequence::packable(const DigitalResidue* digital_sequence, int sequence_length) {
+  for (int i = 1; i <= sequence_length; i++) {
+    if (digital_sequence[i] > 3) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool PackedNucleotideSequence::pack(const DigitalResidue* digital_sequence, int sequence_length) {
+  words_.clear();
+  length_ = 0;
+  if (sequence_length < 0 || !packable(digital_sequence, sequence_length)) {
+    return false;
+  }
+
+  words_.assign((sequence_length + RESIDUES_PER_WORD - 1) / RESIDUES_PER_WORD, 0);
+  for (int idx = 0; idx < sequence_length; idx++) {
+    words_[idx / RESIDUES_PER_WORD] |= static_cast<uint64_t>(digital_sequence[idx + 1])
+                                       << (2 * (idx % RESIDUES_PER_WORD));
+  }
+  length_ = sequence_length;
+  return true;
+}
+
+std::vector<DigitalResidue> PackedNucleotideSequence::unpack() const {
+  std::vector<DigitalResidue> digital_sequence(length_ + 2);
+  digital_sequence[0] = digitalResidueSentinel;
+  for (int i = 1; i <= length_; i++) {
+    digital_sequence[i] = at(i);
+  }
+  digital_sequence[length_ + 1] = digitalResidueSentinel;
+  return digital_sequence;
+}
@@ -0,0 +1,38 @@
+#include "nt_msv.hpp"
+
+#include <algorithm>
+
+float compute_msv_packed(const PackedNucleotideSequence& sequence, const NucleotideScoreRows& scores,
+                         std::vector<float>& row_buffer)
+{
+    const int M = scores.model_length;
+    const int L = sequence.length();
+    if (L <= 0 || M <= 0) {
+        return 0.0f;
+    }
+
+    // Two DP rows back to back: prev = row i-1, cur = row i. Column 0 stays 0.
+    row_buffer.assign(2 * (M + 1), 0.0f);
+    float* prev = row_buffer.data();
+    float* cur = prev + (M + 1);
+    float max_score = 0.0f;
+
+    const std::vector<uint64_t>& words = sequence.words();
+    int i = 0;
+    for (uint64_t word : words) {
+        const int in_word = std::min(PackedNucleotideSequence::RESIDUES_PER_WORD, L - i);
+        for (int r = 0; r < in_word; r++, word >>= 2) {
+            const float* s = scores.row(static_cast<int>(word & 3u));
+            float row_max = 0.0f;
+            for (int k = 1; k <= M; k++) {
+                const float v = std::max(0.0f, prev[k - 1] + s[k]);
+                cur[k] = v;
+                row_max = std::max(row_max, v);
+            }
+            max_score = std::max(max_score, row_max);
+            std::swap(prev, cur);
+        }
+        i += in_word;
+    }
+    return max_score;
+}
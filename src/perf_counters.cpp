@@ -0,0 +1,236 @@
+#include "perf_counters.hpp"
+
+#include <iomanip>
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+namespace {
+
+#ifdef __linux__
+// Open one counting event for the calling thread on any CPU; -1 on failure
+int open_event(uint32_t type, uint64_t config) {
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    long fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    return static_cast<int>(fd);
+}
+
+uint64_t cache_config(uint64_t cache, uint64_t op, uint64_t result) {
+    return cache | (op << 8) | (result << 16);
+}
+#endif
+
+}  // namespace
+
+/*******************************************************************************
+ * PerfCounterGroup
+ ******************************************************************************/
+
+PerfCounterGroup::PerfCounterGroup() {
+    fds_.fill(-1);
+#ifdef __linux__
+    fds_[PERF_CYCLES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    fds_[PERF_INSTRUCTIONS] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    fds_[PERF_L1D_MISSES] = open_event(PERF_TYPE_HW_CACHE, cache_config(PERF_COUNT_HW_CACHE_L1D,
+                                                                        PERF_COUNT_HW_CACHE_OP_READ,
+                                                                        PERF_COUNT_HW_CACHE_RESULT_MISS));
+    fds_[PERF_LLC_MISSES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    fds_[PERF_BRANCH_MISSES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+}
+
+PerfCounterGroup::~PerfCounterGroup() {
+#ifdef __linux__
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+bool PerfCounterGroup::available() const {
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* PerfCounterGroup::event_name(int event) {
+    switch (event) {
+    case PERF_CYCLES: return "cycles";
+    case PERF_INSTRUCTIONS: return "instructions";
+    case PERF_L1D_MISSES: return "L1D-misses";
+    case PERF_LLC_MISSES: return "LLC-misses";
+    case PERF_BRANCH_MISSES: return "branch-misses";
+    default: return "?";
+    }
+}
+
+bool PerfCounterGroup::read_event(int event, Reading& out) const {
+#ifdef __linux__
+    if (fds_[event] < 0) {
+        return false;
+    }
+    uint64_t buf[3];
+    if (read(fds_[event], buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf))) {
+        return false;
+    }
+    out = {buf[0], buf[1], buf[2]};
+    return true;
+#else
+    (void)event;
+    (void)out;
+    return false;
+#endif
+}
+
+void PerfCounterGroup::start() {
+#ifdef __linux__
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        if (fds_[e] >= 0) {
+            ioctl(fds_[e], PERF_EVENT_IOC_ENABLE, 0);
+            if (!read_event(e, begin_[e])) {
+                begin_[e] = {0, 0, 0};
+            }
+        }
+    }
+#endif
+    begin_time_ = std::chrono::steady_clock::now();
+}
+
+PerfSample PerfCounterGroup::stop() {
+    PerfSample sample;
+    sample.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin_time_).count();
+
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        Reading end{};
+        if (!read_event(e, end)) {
+            continue;
+        }
+        const uint64_t value = end.value - begin_[e].value;
+        const uint64_t enabled = end.enabled - begin_[e].enabled;
+        const uint64_t running = end.running - begin_[e].running;
+        if (running == 0) {
+            continue;  // Never scheduled on the PMU during the region
+        }
+        // Scale up if the kernel multiplexed this counter with others
+        sample.counts[e] = running < enabled ? static_cast<uint64_t>(static_cast<double>(value) *
+                                                                     static_cast<double>(enabled) / running)
+                                             : value;
+        sample.valid[e] = true;
+    }
+#ifdef __linux__
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+#endif
+    return sample;
+}
+
+/*******************************************************************************
+ * KernelPerfRegistry
+ ******************************************************************************/
+
+int KernelPerfRegistry::bucket_of(int n) {
+    int bucket = 1;
+    while (bucket < n) {
+        bucket <<= 1;
+    }
+    return bucket;
+}
+
+void KernelPerfRegistry::record(const std::string& kernel, int model_length, int sequence_length,
+                                const PerfSample& sample) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Totals& t = totals_[Key(kernel, bucket_of(model_length), bucket_of(sequence_length))];
+    t.calls++;
+    t.cells += static_cast<uint64_t>(model_length) * static_cast<uint64_t>(sequence_length);
+    t.seconds += sample.seconds;
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        if (sample.valid[e]) {
+            t.counts[e] += sample.counts[e];
+            t.valid[e] = true;
+        }
+    }
+}
+
+bool KernelPerfRegistry::empty() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return totals_.empty();
+}
+
+uint64_t KernelPerfRegistry::calls(const std::string& kernel) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t total = 0;
+    for (const auto& entry : totals_) {
+        if (std::get<0>(entry.first) == kernel) {
+            total += entry.second.calls;
+        }
+    }
+    return total;
+}
+
+void KernelPerfRegistry::report(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::ios_base::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+
+    auto ratio = [](const Totals& t, int num, int den, double scale) -> std::string {
+        if (!t.valid[num] || !t.valid[den] || t.counts[den] == 0) {
+            return "n/a";
+        }
+        std::ostringstream s;
+        s << std::fixed << std::setprecision(2)
+          << scale * static_cast<double>(t.counts[num]) / static_cast<double>(t.counts[den]);
+        return s.str();
+    };
+
+    out << std::left << std::setw(14) << "kernel" << std::setw(10) << "M<=" << std::setw(10) << "L<="
+        << std::right << std::setw(8) << "calls" << std::setw(12) << "Mcells" << std::setw(10) << "cyc/cell"
+        << std::setw(8) << "IPC" << std::setw(10) << "L1D/ki" << std::setw(10) << "LLC/ki" << std::setw(10)
+        << "brm/ki" << std::setw(10) << "GCUPS" << std::endl;
+
+    for (const auto& entry : totals_) {
+        const Totals& t = entry.second;
+        std::string cycles_per_cell = "n/a";
+        if (t.valid[PERF_CYCLES] && t.cells > 0) {
+            std::ostringstream s;
+            s << std::fixed << std::setprecision(2)
+              << static_cast<double>(t.counts[PERF_CYCLES]) / static_cast<double>(t.cells);
+            cycles_per_cell = s.str();
+        }
+        std::ostringstream gcups;
+        gcups << std::fixed << std::setprecision(3)
+              << (t.seconds > 0.0 ? static_cast<double>(t.cells) / t.seconds / 1e9 : 0.0);
+
+        out << std::left << std::setw(14) << std::get<0>(entry.first) << std::setw(10) << std::get<1>(entry.first)
+            << std::setw(10) << std::get<2>(entry.first) << std::right << std::setw(8) << t.calls << std::setw(12)
+            << std::fixed << std::setprecision(3) << static_cast<double>(t.cells) / 1e6 << std::setw(10)
+            << cycles_per_cell << std::setw(8) << ratio(t, PERF_INSTRUCTIONS, PERF_CYCLES, 1.0) << std::setw(10)
+            << ratio(t, PERF_L1D_MISSES, PERF_INSTRUCTIONS, 1000.0) << std::setw(10)
+            << ratio(t, PERF_LLC_MISSES, PERF_INSTRUCTIONS, 1000.0) << std::setw(10)
+            << ratio(t, PERF_BRANCH_MISSES, PERF_INSTRUCTIONS, 1000.0) << std::setw(10) << gcups.str()
+            << std::endl;
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
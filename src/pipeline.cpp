@@ -0,0 +1,241 @@
+#include "pipeline.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include "dp_band.hpp"
+#include "forward.hpp"
+#include "msv_generic.hpp"
+#include "pvalue.hpp"
+#include "viterbi.hpp"
+
+namespace {
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Storage of a DPMatrix for M x L: main cells plus specials, per row
+size_t dp_matrix_bytes(int model_length, int sequence_length) {
+    const size_t row = (static_cast<size_t>(model_length) + 1) * p7G_NSCELLS + p7G_NXCELLS;
+    return (static_cast<size_t>(sequence_length) + 1) * row * sizeof(float);
+}
+
+}  // namespace
+
+PipelineProfile::PipelineProfile(const HMMProfile& profile, const PipelineConfig& config)
+    : profile(profile),
+      config(config),
+      length_config(profile, config.expected_hit_count),
+      ssv_table(profile),
+      seed_table(profile),
+      viterbi_profile(profile, length_config.msv_params(1).tbmk),
+      bias_filter(profile),
+      seg_masker(*profile.abc, config.seg)
+{
+    assert(profile.abc != nullptr && profile.abc->K == AminoTraits::K);
+
+    const bool calibrated = profile.evparam[p7_MLAMBDA] > 0.0f && profile.evparam[p7_VLAMBDA] > 0.0f &&
+                            profile.evparam[p7_FLAMBDA] > 0.0f;
+    for (int i = 0; i < p7_NEVPARAM; i++) {
+        evparam[i] = calibrated ? profile.evparam[i] : config.fallback_evparam[i];
+    }
+}
+
+Pipeline::Pipeline(const HMMProfile& profile, const PipelineConfig& config, RunStats& stats)
+    : Pipeline(std::make_unique<PipelineProfile>(profile, config), std::make_unique<PipelineScratch>(), stats) {}
+
+Pipeline::Pipeline(std::unique_ptr<PipelineProfile> tables, std::unique_ptr<PipelineScratch> scratch,
+                   RunStats& stats)
+    : Pipeline(*tables, *scratch, stats)
+{
+    owned_tables_ = std::move(tables);
+    owned_scratch_ = std::move(scratch);
+}
+
+Pipeline::Pipeline(const PipelineProfile& tables, PipelineScratch& scratch, RunStats& stats)
+    : tables_(tables), scratch_(scratch), stats_(stats)
+{
+    // Stages, in pipeline order
+    const PipelineConfig& config = tables.config;
+    if (config.do_seg_mask) {
+        seg_stage_ = &stats.stage("seg");
+    }
+    const double thresholds[NUM_PIPELINE_STAGES] = {config.F1, config.F1, config.F1, config.F2, config.F3};
+    for (int s = 0; s < NUM_PIPELINE_STAGES; s++) {
+        if ((s == STAGE_SSV && !config.do_ssv) || (s == STAGE_BIAS && !config.do_biasfilter)) {
+            continue;
+        }
+        stage_[s] = &stats.stage(STAGE_NAMES[s]);
+        stage_[s]->threshold = thresholds[s];
+        stage_[s]->threshold_kind = "pvalue";
+    }
+}
+
+void Pipeline::set_perf_registry(KernelPerfRegistry* registry) {
+    perf_registry_ = registry;
+    if (registry != nullptr && perf_counters_ == nullptr) {
+        perf_counters_ = std::make_unique<PerfCounterGroup>();
+    }
+}
+
+PipelineResult Pipeline::run(const DigitalResidue* digital_sequence, int sequence_length) {
+    const HMMProfile& profile = tables_.profile;
+    const PipelineConfig& config = tables_.config;
+    const std::array<float, p7_NEVPARAM>& evparam = tables_.evparam;
+    const int M = profile.model_length;
+    const int L = sequence_length;
+    PipelineResult result;
+    stats_.add_input(1, static_cast<uint64_t>(std::max(0, L)));
+    if (L <= 0 || M <= 0) {
+        result.rejected_at = config.do_ssv ? STAGE_SSV : STAGE_MSV;
+        return result;
+    }
+
+    // Masking works on a private copy; the caller's sequence is untouched
+    if (config.do_seg_mask) {
+        const auto start = std::chrono::steady_clock::now();
+        scratch_.seg_sequence.assign(digital_sequence, digital_sequence + L + 2);
+        result.masked_residues = tables_.seg_masker.mask(scratch_.seg_sequence.data(), L, scratch_.seg_entropy);
+        digital_sequence = scratch_.seg_sequence.data();
+        seg_stage_->add(1, L, result.masked_residues > 0, seconds_since(start));
+    }
+
+    const MSVLengthParams msv_params = tables_.length_config.msv_params(L);
+    result.null_score = null_one_score(L);
+    result.filter_score = result.null_score;
+
+    // Runs one kernel call under hardware counters (no-op without a registry)
+    auto measure = [&](const char* kernel, auto&& call) {
+        ScopedPerfRegion region(perf_registry_, perf_counters_.get(), kernel, M, L);
+        return call();
+    };
+
+    // Records one stage over `cells` DP cells; false rejects the sequence
+    const uint64_t full_cells = static_cast<uint64_t>(M) * static_cast<uint64_t>(L);
+    auto gate = [&](int s, double pvalue, std::chrono::steady_clock::time_point start, uint64_t cells) {
+        const bool passed = pvalue <= stage_[s]->threshold;
+        stage_[s]->add_cells(cells, L, passed, seconds_since(start));
+        result.pvalue = pvalue;
+        if (!passed) {
+            result.rejected_at = s;
+        }
+        return passed;
+    };
+
+    // --- A. SSV: best single segment, uint8 ---
+    if (config.do_ssv) {
+        const auto start = std::chrono::steady_clock::now();
+        const float segment = measure("ssv/uint8", [&]() {
+            return msv_kernel<AminoTraits, Uint8Policy>(digital_sequence, L, tables_.ssv_table, scratch_.ssv_buffer);
+        });
+        const float bits = bit_score(ssv_sequence_score(segment, L, msv_params), result.null_score);
+        if (!gate(STAGE_SSV, gumbel_survival(bits, evparam[p7_MMU], evparam[p7_MLAMBDA]), start, full_cells)) {
+            return result;
+        }
+    }
+
+    // --- B. MSV: multi-hit with specials ---
+    auto start = std::chrono::steady_clock::now();
+    const float msv_score = measure("msv/float", [&]() {
+        return compute_msv_generic(digital_sequence, L, profile, msv_params, scratch_.msv_buffer);
+    });
+    result.msv_bits = bit_score(msv_score, result.null_score);
+    if (!gate(STAGE_MSV, gumbel_survival(result.msv_bits, evparam[p7_MMU], evparam[p7_MLAMBDA]), start, full_cells)) {
+        return result;
+    }
+
+    // --- C. Bias: same MSV score against the composition null ---
+    if (config.do_biasfilter) {
+        // O(L), not a DP over the model: one cell per residue
+        start = std::chrono::steady_clock::now();
+        {
+            ScopedPerfRegion region(perf_registry_, perf_counters_.get(), "bias", 1, L);
+            result.filter_score = tables_.bias_filter.score(digital_sequence, L);
+        }
+        const float bits = bit_score(msv_score, result.filter_score);
+        if (!gate(STAGE_BIAS, gumbel_survival(bits, evparam[p7_MMU], evparam[p7_MLAMBDA]), start,
+                  static_cast<uint64_t>(L))) {
+            return result;
+        }
+    }
+
+    // --- D. Viterbi filter ---
+    start = std::chrono::steady_clock::now();
+    const SpecialTransitions specials = tables_.length_config.for_length(L);
+    const float viterbi_score = measure("viterbi/int16", [&]() {
+        return viterbi_filter(digital_sequence, L, tables_.viterbi_profile, specials, scratch_.viterbi_buffer);
+    });
+    result.viterbi_bits = bit_score(viterbi_score, result.filter_score);
+    if (!gate(STAGE_VITERBI, gumbel_survival(result.viterbi_bits, evparam[p7_VMU], evparam[p7_VLAMBDA]),
+              start, full_cells)) {
+        return result;
+    }
+
+    // --- E. Forward, inside the Viterbi band unless band_margin < 0 ---
+    // Viterbi path from a banded Viterbi around the best MSV diagonals
+    start = std::chrono::steady_clock::now();
+    float forward_score;
+    uint64_t forward_cells = full_cells;  // Cells inside the band when banded
+    if (config.band_margin >= 0) {
+        measure("msv/seeds", [&]() {
+            msv_kernel_segments<AminoTraits>(digital_sequence, L, tables_.seed_table, scratch_.seed_runs,
+                                             config.seed_segments, scratch_.seeds);
+        });
+    }
+    if (config.band_margin >= 0 && !scratch_.seeds.empty()) {
+        // Seeds on distant diagonals that share rows widen those rows to
+        // their hull; a band near M x L saves nothing over the full matrix
+        const DPBand seeded = seed_band(scratch_.seeds, M, L, config.seed_width);
+        const bool too_wide =
+            static_cast<double>(seeded.cells()) > config.max_seed_band_fraction * static_cast<double>(full_cells);
+        const std::vector<TraceCell> trace = measure("viterbi/trace", [&]() {
+            if (!too_wide) {
+                const float banded = compute_viterbi_banded(digital_sequence, L, profile, specials, msv_params.tbmk,
+                                                            seeded, scratch_.banded_matrix);
+                // Below the filter's score (beyond its word rounding, at
+                // most a unit per row and per node) the seeds missed part of
+                // the best path
+                const float rounding = static_cast<float>(M + L) / tables_.viterbi_profile.scale;
+                if (!std::isfinite(viterbi_score) || banded >= viterbi_score - rounding) {
+                    return viterbi_traceback(L, profile, specials, msv_params.tbmk, scratch_.banded_matrix);
+                }
+            }
+            // Full matrix, in O(M sqrt(L)) memory
+            result.full_viterbi = true;
+            compute_viterbi_checkpointed(digital_sequence, L, profile, specials, msv_params.tbmk,
+                                         scratch_.checkpoint_matrix);
+            return viterbi_traceback(digital_sequence, L, profile, specials, msv_params.tbmk,
+                                     scratch_.checkpoint_matrix);
+        });
+        const DPBand band = trace_band(trace, M, L, config.band_margin);
+        forward_cells = band.cells();
+        forward_score = measure("forward/band", [&]() {
+            return compute_forward_banded(digital_sequence, L, profile, specials, msv_params.tbmk, band,
+                                          scratch_.banded_matrix);
+        });
+    } else {
+        // No band, or no seed to build one around: a full Viterbi just to
+        // find a band would cost as much as the Forward it saves
+        if (scratch_.dp_matrix.sequence_length < L || scratch_.dp_matrix.model_length < M) {
+            scratch_.dp_matrix = DPMatrix(M, L);
+        }
+        forward_score = measure("forward/full", [&]() {
+            return compute_forward(digital_sequence, L, profile, specials, msv_params.tbmk, scratch_.dp_matrix);
+        });
+        // One unusually long sequence must not pin an M x L matrix for the
+        // rest of the run
+        if (dp_matrix_bytes(M, L) > config.max_retained_dp_bytes) {
+            scratch_.dp_matrix = DPMatrix(M, 0);
+        }
+    }
+    result.forward_bits = bit_score(forward_score, result.filter_score);
+    if (!gate(STAGE_FORWARD, exponential_survival(result.forward_bits, evparam[p7_FTAU], evparam[p7_FLAMBDA]),
+              start, forward_cells)) {
+        return result;
+    }
+
+    result.passed = true;
+    return result;
+}
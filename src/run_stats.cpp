@@ -0,0 +1,138 @@
+#include "run_stats.hpp"
+
+#include <cstdio>
+#include <ctime>
+#include <iomanip>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+// Minimal JSON string escaping (quotes, backslash, control characters)
+std::string json_string(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                out += buf;
+            } else {
+                out += c;
+            }
+        }
+    }
+    return out + "\"";
+}
+
+}  // namespace
+
+RunStats::RunStats()
+    : wall_start_(std::chrono::steady_clock::now()), cpu_start_(process_cpu_seconds()) {}
+
+StageStats& RunStats::stage(const std::string& name) {
+    for (StageStats& s : stages_) {
+        if (s.name == name) {
+            return s;
+        }
+    }
+    stages_.emplace_back();
+    stages_.back().name = name;
+    return stages_.back();
+}
+
+void RunStats::set_label(const std::string& key, const std::string& value) {
+    for (auto& label : labels_) {
+        if (label.first == key) {
+            label.second = value;
+            return;
+        }
+    }
+    labels_.emplace_back(key, value);
+}
+
+void RunStats::finish() {
+    wall_seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start_).count();
+    cpu_seconds_ = process_cpu_seconds() - cpu_start_;
+    peak_rss_bytes_ = process_peak_rss_bytes();
+}
+
+double RunStats::process_cpu_seconds() {
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+               static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    }
+#endif
+    return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+}
+
+uint64_t RunStats::process_peak_rss_bytes() {
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+        return static_cast<uint64_t>(usage.ru_maxrss);          // bytes on macOS
+#else
+        return static_cast<uint64_t>(usage.ru_maxrss) * 1024u;  // kilobytes on Linux
+#endif
+    }
+#endif
+    return 0;
+}
+
+void RunStats::write_json(std::ostream& out) const {
+    const std::ios::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    out << std::setprecision(6);
+
+    uint64_t total_cells = 0;
+    for (const StageStats& s : stages_) {
+        total_cells += s.cells;
+    }
+
+    out << "{\n";
+    for (const auto& label : labels_) {
+        out << "  " << json_string(label.first) << ": " << json_string(label.second) << ",\n";
+    }
+    out << "  \"sequences\": " << sequences_ << ",\n";
+    out << "  \"residues\": " << residues_ << ",\n";
+    out << "  \"total_cells\": " << total_cells << ",\n";
+    out << "  \"wall_seconds\": " << wall_seconds_ << ",\n";
+    out << "  \"cpu_seconds\": " << cpu_seconds_ << ",\n";
+    out << "  \"gcups\": " << (wall_seconds_ > 0.0 ? static_cast<double>(total_cells) / wall_seconds_ / 1e9 : 0.0)
+        << ",\n";
+    out << "  \"peak_rss_bytes\": " << peak_rss_bytes_ << ",\n";
+    out << "  \"stages\": [";
+    for (size_t i = 0; i < stages_.size(); i++) {
+        const StageStats& s = stages_[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\n";
+        out << "      \"name\": " << json_string(s.name) << ",\n";
+        if (!s.threshold_kind.empty()) {
+            out << "      \"threshold\": " << s.threshold << ",\n";
+            out << "      \"threshold_kind\": " << json_string(s.threshold_kind) << ",\n";
+        }
+        out << "      \"sequences_in\": " << s.sequences_in << ",\n";
+        out << "      \"sequences_passed\": " << s.sequences_passed << ",\n";
+        out << "      \"pass_rate\": " << s.pass_rate() << ",\n";
+        out << "      \"residues\": " << s.residues << ",\n";
+        out << "      \"cells\": " << s.cells << ",\n";
+        out << "      \"seconds\": " << s.seconds << ",\n";
+        out << "      \"gcups\": " << s.gcups() << "\n";
+        out << "    }";
+    }
+    out << (stages_.empty() ? "]\n" : "\n  ]\n");
+    out << "}\n";
+
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,335 @@
+#include "search_daemon.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <sstream>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr int POLL_INTERVAL_MS = 100;  // How often blocked loops re-check the stop flag
+
+bool make_address(const std::string& socket_path, sockaddr_un& address, std::string& error) {
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socket_path.empty() || socket_path.size() >= sizeof(address.sun_path)) {
+        error = "invalid socket path '" + socket_path + "'";
+        return false;
+    }
+    std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+    return true;
+}
+
+bool send_all(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        const ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool is_status_line(const std::string& line) {
+    return line == "OK" || line.compare(0, 3, "OK ") == 0 || line.compare(0, 4, "ERR ") == 0;
+}
+
+}  // namespace
+
+SearchDaemon::SearchDaemon(const SequenceDatabase& db, const std::vector<HMMProfile>& profiles,
+                           const SearchDaemonConfig& config)
+    : db_(db), profiles_(profiles), config_(config), engine_(db, profiles, config.search) {}
+
+SearchDaemon::~SearchDaemon() {
+    stop();
+    for (std::unique_ptr<Connection>& connection : connections_) {
+        connection->thread.join();
+    }
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        ::unlink(socket_path_.c_str());
+    }
+}
+
+int SearchDaemon::find_profile(const std::string& name) const {
+    for (size_t p = 0; p < profiles_.size(); p++) {
+        if (profiles_[p].name == name) {
+            return static_cast<int>(p);
+        }
+    }
+    return -1;
+}
+
+SearchResult SearchDaemon::search(int profile) {
+    return search(std::vector<int>{profile}).front();
+}
+
+SearchResult SearchDaemon::search_coalesced(int profile) {
+    if (config_.coalesce_window_ms <= 0) {
+        return search(profile);
+    }
+
+    PendingQuery query{profile, {}, nullptr, false};
+    std::unique_lock<std::mutex> lock(batch_mutex_);
+    pending_.push_back(&query);
+    if (collecting_) {
+        // Another query leads this batch; wait for it to hand back our result
+        batch_cv_.wait(lock, [&query]() { return query.done; });
+        if (query.error) {
+            std::rethrow_exception(query.error);
+        }
+        return query.result;
+    }
+
+    // Lead the batch: let others join for the window, and until the pass
+    // ahead of us is off the pool, then take everything that queued up
+    collecting_ = true;
+    lock.unlock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(config_.coalesce_window_ms));
+    lock.lock();
+    batch_cv_.wait(lock, [this]() { return !running_; });
+    std::vector<PendingQuery*> batch;
+    batch.swap(pending_);
+    collecting_ = false;
+    running_ = true;
+    lock.unlock();
+
+    std::vector<int> profiles;
+    for (const PendingQuery* q : batch) {
+        if (std::find(profiles.begin(), profiles.end(), q->profile) == profiles.end()) {
+            profiles.push_back(q->profile);
+        }
+    }
+    // Whatever happens the batch must be answered and the pool released,
+    // or its followers and every later batch would wait forever
+    std::vector<SearchResult> results;
+    std::exception_ptr error;
+    try {
+        results = search(profiles);
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    lock.lock();
+    for (PendingQuery* q : batch) {
+        if (error) {
+            q->error = error;
+        } else {
+            q->result = results[std::find(profiles.begin(), profiles.end(), q->profile) - profiles.begin()];
+        }
+        q->done = true;
+    }
+    running_ = false;
+    batch_cv_.notify_all();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return query.result;
+}
+
+std::string SearchDaemon::handle_request(const std::string& line) {
+    std::istringstream in(line);
+    std::string command;
+    std::string argument;
+    in >> command >> argument;
+
+    std::ostringstream out;
+    if (command == "SEARCH") {
+        const int profile = find_profile(argument);
+        if (profile < 0) {
+            return "ERR unknown profile '" + argument + "'\n";
+        }
+        SearchResult result;
+        try {
+            result = search_coalesced(profile);
+        } catch (const std::exception& e) {
+            return std::string("ERR search failed: ") + e.what() + "\n";
+        }
+        char buffer[64];
+        for (size_t rank = 0; rank < result.hits.size(); rank++) {
+            const SearchHit& hit = result.hits[rank];
+            out << "HIT " << rank + 1 << " " << db_.name(hit.sequence);
+            std::snprintf(buffer, sizeof(buffer), " %.2f %.3g %.3g\n", hit.bits, hit.pvalue, hit.evalue);
+            out << buffer;
+        }
+        std::snprintf(buffer, sizeof(buffer), " %.3f %d\n", result.milliseconds, result.batch_profiles);
+        out << "OK " << result.hits.size() << " " << result.sequences << buffer;
+    } else if (command == "LIST") {
+        for (const HMMProfile& profile : profiles_) {
+            out << "PROFILE " << profile.name << " " << profile.model_length << "\n";
+        }
+        out << "OK " << profiles_.size() << "\n";
+    } else if (command == "PING") {
+        out << "OK\n";
+    } else if (command == "SHUTDOWN") {
+        stop();
+        out << "OK\n";
+    } else {
+        out << "ERR unknown command '" << command << "'\n";
+    }
+    return out.str();
+}
+
+bool SearchDaemon::listen(const std::string& socket_path, std::string& error) {
+    sockaddr_un address;
+    if (!make_address(socket_path, address, error)) {
+        return false;
+    }
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        error = std::string("socket: ") + std::strerror(errno);
+        return false;
+    }
+    ::unlink(socket_path.c_str());
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || ::listen(fd, 16) != 0) {
+        error = socket_path + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    listen_fd_ = fd;
+    socket_path_ = socket_path;
+    return true;
+}
+
+void SearchDaemon::serve() {
+    pollfd listener = {listen_fd_, POLLIN, 0};
+    while (!stopping_ && listen_fd_ >= 0) {
+        const bool ready = ::poll(&listener, 1, POLL_INTERVAL_MS) > 0 && (listener.revents & POLLIN);
+        reap_connections();
+        if (!ready) {
+            continue;
+        }
+        const int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) {
+            // The pending connection stays queued (EMFILE, ENFILE, ENOBUFS):
+            // give open connections time to close instead of spinning
+            if (errno != EINTR && errno != ECONNABORTED) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(POLL_INTERVAL_MS));
+            }
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        connections_.push_back(std::make_unique<Connection>());
+        Connection& connection = *connections_.back();
+        connection.thread = std::thread(&SearchDaemon::serve_connection, this, fd, std::ref(connection));
+    }
+
+    // Refuse new connections before draining the open ones
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        ::unlink(socket_path_.c_str());
+        listen_fd_ = -1;
+    }
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    for (std::unique_ptr<Connection>& connection : connections_) {
+        connection->thread.join();
+    }
+    connections_.clear();
+}
+
+void SearchDaemon::reap_connections() {
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    auto finished = std::partition(connections_.begin(), connections_.end(),
+                                   [](const std::unique_ptr<Connection>& c) { return !c->done; });
+    for (auto c = finished; c != connections_.end(); ++c) {
+        (*c)->thread.join();
+    }
+    connections_.erase(finished, connections_.end());
+}
+
+size_t SearchDaemon::open_connections() {
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    return connections_.size();
+}
+
+void SearchDaemon::serve_connection(int fd, Connection& connection) {
+    std::string pending;
+    char buffer[4096];
+    pollfd client = {fd, POLLIN, 0};
+    while (!stopping_) {
+        if (::poll(&client, 1, POLL_INTERVAL_MS) <= 0) {
+            continue;
+        }
+        const ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            break;  // Client closed the connection
+        }
+        pending.append(buffer, static_cast<size_t>(n));
+
+        size_t newline;
+        bool open = true;
+        while (open && (newline = pending.find('\n')) != std::string::npos && newline <= MAX_REQUEST_LINE) {
+            std::string line = pending.substr(0, newline);
+            pending.erase(0, newline + 1);
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            open = send_all(fd, handle_request(line));
+        }
+        if (!open) {
+            break;
+        }
+        // The rest of an overlong line cannot be told from the next request
+        if (pending.size() > MAX_REQUEST_LINE) {
+            send_all(fd, "ERR request line longer than " + std::to_string(MAX_REQUEST_LINE) + " bytes\n");
+            break;
+        }
+    }
+    ::close(fd);
+    connection.done = true;
+}
+
+bool daemon_request(const std::string& socket_path, const std::string& request, std::vector<std::string>& reply,
+                    std::string& error) {
+    sockaddr_un address;
+    if (!make_address(socket_path, address, error)) {
+        return false;
+    }
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        error = std::string("socket: ") + std::strerror(errno);
+        return false;
+    }
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        error = socket_path + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    if (!send_all(fd, request + "\n")) {
+        error = "send failed";
+        ::close(fd);
+        return false;
+    }
+
+    reply.clear();
+    std::string pending;
+    char buffer[4096];
+    while (true) {
+        const ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            error = "connection closed before the status line";
+            ::close(fd);
+            return false;
+        }
+        pending.append(buffer, static_cast<size_t>(n));
+        size_t newline;
+        while ((newline = pending.find('\n')) != std::string::npos) {
+            reply.push_back(pending.substr(0, newline));
+            pending.erase(0, newline + 1);
+            if (is_status_line(reply.back())) {
+                ::close(fd);
+                return true;
+            }
+        }
+    }
+}
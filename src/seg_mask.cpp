@@ -0,0 +1,130 @@
+#include "seg_mask.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+
+constexpr double FIXED_ONE = 65536.0;
+
+}  // namespace
+
+SegMasker::SegMasker(const DigitalAlphabet& abc, const SegMaskConfig& config)
+    : config_(config), K_(abc.K), mask_code_(static_cast<DigitalResidue>(abc.any_index()))
+{
+    assert(abc.K <= p7_MAXABET);
+    config_.window = std::clamp(config_.window, 2, 255);
+    clogc_.resize(config_.window + 1);
+    for (int c = 0; c <= config_.window; c++) {
+        clogc_[c] = c > 0 ? static_cast<int32_t>(std::lround(c * std::log2(static_cast<double>(c)) * FIXED_ONE)) : 0;
+    }
+}
+
+double SegMasker::window_entropy_at(const DigitalResidue* digital_sequence, int start) const {
+    const int W = config_.window;
+    int counts[p7_MAXABET + 1] = {};
+    for (int i = start; i < start + W; i++) {
+        counts[bin(digital_sequence[i])]++;
+    }
+    double h = 0.0;
+    for (int b = 0; b <= K_; b++) {
+        if (counts[b] > 0) {
+            const double p = static_cast<double>(counts[b]) / W;
+            h -= p * std::log2(p);
+        }
+    }
+    return h;
+}
+
+void SegMasker::window_entropy(const DigitalResidue* digital_sequence, int sequence_length,
+                               std::vector<float>& entropy) const {
+    const int W = config_.window;
+    const int L = sequence_length;
+    const int n = L - W + 1;
+    if (n <= 0) {
+        entropy.clear();
+        return;
+    }
+    entropy.resize(n);
+
+    // H = log2 W - S / W with S = sum_x c_x log2 c_x in 16.16 fixed point
+    const float log2w = static_cast<float>(std::log2(static_cast<double>(W)));
+    const float inv = static_cast<float>(1.0 / (W * FIXED_ONE));
+    const int32_t* f = clogc_.data();
+
+    uint8_t counts[SEG_LANES][p7_MAXABET + 1] = {};
+    int32_t sum[SEG_LANES] = {};
+    int pos[SEG_LANES];  // Next window start (1-based) per lane
+
+    const int chunk = n / SEG_LANES;
+    const int lanes = chunk >= SEG_MIN_CHUNK ? SEG_LANES : 1;
+    for (int c = 0; c < lanes; c++) {
+        pos[c] = 1 + (c * chunk);
+        for (int i = pos[c]; i < pos[c] + W; i++) {
+            uint8_t& cnt = counts[c][bin(digital_sequence[i])];
+            sum[c] += f[cnt + 1] - f[cnt];
+            cnt++;
+        }
+    }
+
+    // Emit window pos[c], then slide it one residue right
+    auto step = [&](int c) {
+        const int s = pos[c];
+        entropy[s - 1] = log2w - (static_cast<float>(sum[c]) * inv);
+        if (s + W <= L) {
+            uint8_t& out = counts[c][bin(digital_sequence[s])];
+            sum[c] += f[out - 1] - f[out];
+            out--;
+            uint8_t& in = counts[c][bin(digital_sequence[s + W])];
+            sum[c] += f[in + 1] - f[in];
+            in++;
+        }
+        pos[c] = s + 1;
+    };
+
+    if (lanes > 1) {
+        for (int j = 0; j < chunk; j++) {
+            for (int c = 0; c < SEG_LANES; c++) {
+                step(c);
+            }
+        }
+    }
+    // The last lane (or the only one) runs on to the final window
+    const int last = lanes - 1;
+    while (pos[last] <= n) {
+        step(last);
+    }
+}
+
+int SegMasker::mask(DigitalResidue* digital_sequence, int sequence_length, std::vector<float>& entropy_buffer) const {
+    window_entropy(digital_sequence, sequence_length, entropy_buffer);
+    const int n = static_cast<int>(entropy_buffer.size());
+    const int W = config_.window;
+    int masked = 0;
+
+    // Maximal runs of windows at or below the extension entropy; a run that
+    // holds a trigger window masks every residue its windows cover
+    int s = 0;
+    while (s < n) {
+        if (entropy_buffer[s] > config_.extension_bits) {
+            s++;
+            continue;
+        }
+        int e = s;
+        bool triggered = false;
+        while (e < n && entropy_buffer[e] <= config_.extension_bits) {
+            triggered = triggered || entropy_buffer[e] <= config_.trigger_bits;
+            e++;
+        }
+        if (triggered) {
+            // Window index w starts at residue w + 1
+            for (int i = s + 1; i <= e + W - 1; i++) {
+                masked += digital_sequence[i] != mask_code_ ? 1 : 0;
+                digital_sequence[i] = mask_code_;
+            }
+        }
+        s = e;
+    }
+    return masked;
+}
@@ -0,0 +1,86 @@
+#include "sequence_db.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+
+bool SequenceDatabase::load_fasta(std::istream& in, std::string& error) {
+    std::string line;
+    std::string name;
+    std::vector<DigitalResidue> residues(1, digitalResidueSentinel);
+    bool in_record = false;
+    int line_number = 0;
+    const DigitalResidue any = static_cast<DigitalResidue>(abc_.any_index());
+
+    auto flush = [&]() {
+        if (in_record) {
+            const int L = static_cast<int>(residues.size()) - 1;
+            residues.push_back(digitalResidueSentinel);
+            add(name, residues.data(), L);
+            residues.resize(1);
+        }
+    };
+
+    while (std::getline(in, line)) {
+        line_number++;
+        if (!line.empty() && line[0] == '>') {
+            flush();
+            const size_t end = line.find_first_of(" \t\r", 1);
+            name = line.substr(1, end == std::string::npos ? std::string::npos : end - 1);
+            in_record = true;
+            continue;
+        }
+        for (char ch : line) {
+            const unsigned char c = static_cast<unsigned char>(ch);
+            if (std::isspace(c) || std::isdigit(c)) {
+                continue;
+            }
+            if (!in_record) {
+                error = "line " + std::to_string(line_number) + ": sequence data before the first '>' header";
+                return false;
+            }
+            const int code = c < abc_.inmap.size() ? abc_.inmap[std::toupper(c)] : -1;
+            residues.push_back(code >= 0 && code < abc_.Kp ? static_cast<DigitalResidue>(code) : any);
+        }
+    }
+    flush();
+    return true;
+}
+
+bool SequenceDatabase::load_fasta(const std::string& path, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    if (!load_fasta(in, error)) {
+        error = path + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+int SequenceDatabase::add(const std::string& name, const DigitalResidue* digital_sequence, int sequence_length) {
+    names_.push_back(name);
+    residues_ += std::max(0, sequence_length);
+    return stream_.add(digital_sequence, sequence_length);
+}
+
+std::vector<SequenceRange> SequenceDatabase::chunks(int64_t target_residues) const {
+    std::vector<SequenceRange> ranges;
+    target_residues = std::max<int64_t>(1, target_residues);
+    int first = 0;
+    int64_t filled = 0;
+    for (int s = 0; s < size(); s++) {
+        filled += length(s);
+        if (filled >= target_residues) {
+            ranges.push_back({first, s + 1});
+            first = s + 1;
+            filled = 0;
+        }
+    }
+    if (first < size()) {
+        ranges.push_back({first, size()});
+    }
+    return ranges;
+}
@@ -0,0 +1,63 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(int num_threads) {
+    int threads = num_threads > 0 ? num_threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, threads);
+    for (int w = 0; w < threads; w++) {
+        workers_.emplace_back(&ThreadPool::worker_loop, this, w);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_ready_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallel_for(int n, const Task& task) {
+    if (n <= 0) {
+        return;
+    }
+    auto job = std::make_shared<Job>();
+    job->task = &task;
+    job->n = n;
+    job->remaining = n;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    jobs_.push_back(job);
+    work_ready_.notify_all();
+    job->done.wait(lock, [&job]() { return job->remaining == 0; });
+}
+
+void ThreadPool::worker_loop(int worker) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        work_ready_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+        if (jobs_.empty()) {
+            return;  // Stopping, and nothing left to hand out
+        }
+
+        // Take one index of the oldest job; retire the job from the queue
+        // once its last index is handed out
+        std::shared_ptr<Job> job = jobs_.front();
+        const int index = job->next++;
+        if (job->next == job->n) {
+            jobs_.pop_front();
+        }
+
+        lock.unlock();
+        (*job->task)(index, worker);
+        lock.lock();
+
+        if (--job->remaining == 0) {
+            job->done.notify_all();
+        }
+    }
+}
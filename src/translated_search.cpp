@@ -0,0 +1,54 @@
+#include "translated_search.hpp"
+
+#include <cstring>
+
+// NCBI transl_table=1, codons in TCAG order
+const char* const CodonTable::STANDARD = "FFLLSSSSYY**CC*WLLLLPPPPHHQQRRRRIIIMTTTTNNKKSSRRVVVVAAAADDEEGGGG";
+
+CodonTable::CodonTable(const char* ncbi_amino_acids) {
+    // Position of each digital base (A=0, C=1, G=2, T=3) in TCAG order
+    static const int tcag[4] = {2, 1, 3, 0};
+
+    const DigitalResidue any = static_cast<DigitalResidue>(AminoTraits::Kp - 3);  // X
+    const bool valid = ncbi_amino_acids != nullptr && std::strlen(ncbi_amino_acids) >= NUM_CODONS;
+    for (int b1 = 0; b1 < 4; b1++) {
+        for (int b2 = 0; b2 < 4; b2++) {
+            for (int b3 = 0; b3 < 4; b3++) {
+                const int codon = (b1 << 4) | (b2 << 2) | b3;
+                if (!valid) {
+                    amino_[codon] = any;
+                    continue;
+                }
+                const char aa = ncbi_amino_acids[(tcag[b1] * 16) + (tcag[b2] * 4) + tcag[b3]];
+                const DigitalResidue code = AminoTraits::inmap[static_cast<unsigned char>(aa) & 0x7f];
+                amino_[codon] = code == digitalResidueIllegal ? any : code;
+            }
+        }
+    }
+    amino_[DEGENERATE_CODON] = any;
+}
+
+int translate_frame(const DigitalResidue* dna, int sequence_length, int frame_index, int first, int last,
+                    const CodonTable& codons, DigitalResidue* out) {
+    const int n = std::max(0, last - first + 1);
+    const int offset = frame_index % 3;
+    out[0] = digitalResidueSentinel;
+
+    if (frame_index < 3) {
+        // Codon j starts at nucleotide offset + 3(j-1) + 1
+        const DigitalResidue* p = dna + offset + (3 * (first - 1)) + 1;
+        for (int j = 1; j <= n; j++, p += 3) {
+            out[j] = codons[CodonTable::codon_index(p[0], p[1], p[2])];
+        }
+    } else {
+        // Codon j of the minus strand covers forward nucleotides
+        // L - offset - 3j + 1 .. L - offset - 3(j-1), read backwards
+        const DigitalResidue* p = dna + sequence_length - offset - (3 * first) + 1;
+        for (int j = 1; j <= n; j++, p -= 3) {
+            out[j] = codons[CodonTable::reverse_codon_index(p[0], p[1], p[2])];
+        }
+    }
+
+    out[n + 1] = digitalResidueSentinel;
+    return n;
+}
@@ -0,0 +1,287 @@
+#include "viterbi.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace {
+
+// Core cells of row i from row i-1 and B(i-1), over a full row (`band` ==
+// nullptr) or the band's columns; returns E(i) before the specials update
+template<class Matrix>
+float viterbi_row(const DigitalResidue* digital_sequence, const HMMProfile& profile, float tbmk,
+                  const DPBand* band, int i, Matrix& dp_matrix) {
+    const int M = profile.model_length;
+
+    // Cell readers that see -inf outside the band
+    auto in_band = [&](int r, int k) {
+        return k >= 1 && (band == nullptr || band->contains(r, k));
+    };
+    auto mmx = [&](int r, int k) { return in_band(r, k) ? dp_matrix.match(r, k) : -eslINFINITY; };
+    auto imx = [&](int r, int k) { return in_band(r, k) ? dp_matrix.insert(r, k) : -eslINFINITY; };
+    auto dmx = [&](int r, int k) { return in_band(r, k) ? dp_matrix.delete_state(r, k) : -eslINFINITY; };
+
+    const DigitalResidue x = digital_sequence[i];
+    const bool emits = x < profile.abc->Kp;
+    const float xB = dp_matrix.special(i - 1, p7G_B);
+    float xE = -eslINFINITY;
+
+    const int k_lo = band == nullptr ? 1 : band->kmin[i];
+    const int k_hi = band == nullptr ? M : band->kmax[i];
+    if (band == nullptr) {
+        dp_matrix.match(i, 0) = dp_matrix.insert(i, 0) = dp_matrix.delete_state(i, 0) = -eslINFINITY;
+    }
+    for (int k = k_lo; k <= k_hi; k++) {
+        const int j = k - 1;
+        float sc = std::max(std::max(mmx(i - 1, j) + profile.trans(j, p7P_MM),
+                                     imx(i - 1, j) + profile.trans(j, p7P_IM)),
+                            std::max(dmx(i - 1, j) + profile.trans(j, p7P_DM), xB + tbmk));
+        sc += emits ? profile.match_score(k, x) : -eslINFINITY;
+        dp_matrix.match(i, k) = sc;
+        xE = std::max(xE, sc);
+
+        if (k < M) {
+            const float isc = std::max(mmx(i - 1, k) + profile.trans(k, p7P_MI),
+                                       imx(i - 1, k) + profile.trans(k, p7P_II));
+            dp_matrix.insert(i, k) = isc + (emits ? profile.insert_score(k, x) : -eslINFINITY);
+        } else {
+            dp_matrix.insert(i, k) = -eslINFINITY;
+        }
+
+        dp_matrix.delete_state(i, k) = std::max(mmx(i, j) + profile.trans(j, p7P_MD),
+                                                dmx(i, j) + profile.trans(j, p7P_DD));
+    }
+    // Local end from D_M as well (glocal-style wing retraction)
+    return std::max(xE, dmx(i, M));
+}
+
+// Shared recurrence over a full matrix (`band` == nullptr) or the cells
+// of a BandedDPMatrix (`band` == its band)
+template<class Matrix>
+float viterbi_fill(const DigitalResidue* digital_sequence, int sequence_length, const HMMProfile& profile,
+                   const SpecialTransitions& specials, float tbmk, const DPBand* band, Matrix& dp_matrix) {
+    const int M = profile.model_length;
+    const int L = sequence_length;
+    if (M <= 0 || L < 0) {
+        return -eslINFINITY;
+    }
+
+    const float t_nloop = specials(p7P_N, p7P_LOOP);
+    const float t_nmove = specials(p7P_N, p7P_MOVE);
+    const float t_eloop = specials(p7P_E, p7P_LOOP);
+    const float t_emove = specials(p7P_E, p7P_MOVE);
+    const float t_jloop = specials(p7P_J, p7P_LOOP);
+    const float t_jmove = specials(p7P_J, p7P_MOVE);
+    const float t_cloop = specials(p7P_C, p7P_LOOP);
+    const float t_cmove = specials(p7P_C, p7P_MOVE);
+
+    // --- A. Row 0: only N and B are reachable ---
+    dp_matrix.special(0, p7G_N) = 0.0f;
+    dp_matrix.special(0, p7G_B) = t_nmove;
+    dp_matrix.special(0, p7G_E) = dp_matrix.special(0, p7G_J) = dp_matrix.special(0, p7G_C) = -eslINFINITY;
+    if (band == nullptr) {
+        for (int k = 0; k <= M; k++) {
+            dp_matrix.match(0, k) = dp_matrix.insert(0, k) = dp_matrix.delete_state(0, k) = -eslINFINITY;
+        }
+    }
+
+    // --- B. Rows 1..L ---
+    for (int i = 1; i <= L; i++) {
+        const float xE = viterbi_row(digital_sequence, profile, tbmk, band, i, dp_matrix);
+        dp_matrix.special(i, p7G_E) = xE;
+        dp_matrix.special(i, p7G_J) = std::max(dp_matrix.special(i - 1, p7G_J) + t_jloop, xE + t_eloop);
+        dp_matrix.special(i, p7G_C) = std::max(dp_matrix.special(i - 1, p7G_C) + t_cloop, xE + t_emove);
+        dp_matrix.special(i, p7G_N) = dp_matrix.special(i - 1, p7G_N) + t_nloop;
+        dp_matrix.special(i, p7G_B) = std::max(dp_matrix.special(i, p7G_N) + t_nmove,
+                                               dp_matrix.special(i, p7G_J) + t_jmove);
+    }
+
+    return dp_matrix.special(L, p7G_C) + t_cmove;
+}
+
+}  // namespace
+
+float compute_viterbi(const DigitalResidue* digital_sequence, int sequence_length, const HMMProfile& profile,
+                      const SpecialTransitions& specials, float tbmk, DPMatrix& dp_matrix) {
+    assert(dp_matrix.model_length >= profile.model_length && dp_matrix.sequence_length >= sequence_length);
+    return viterbi_fill(digital_sequence, sequence_length, profile, specials, tbmk, nullptr, dp_matrix);
+}
+
+float compute_viterbi(const DigitalResidue* digital_sequence, int sequence_length, const HMMProfile& profile,
+                      const LengthConfigCache& config, DPMatrix& dp_matrix) {
+    return compute_viterbi(digital_sequence, sequence_length, profile, config.for_length(sequence_length),
+                           config.msv_params(sequence_length).tbmk, dp_matrix);
+}
+
+float compute_viterbi_banded(const DigitalResidue* digital_sequence, int sequence_length,
+                             const HMMProfile& profile, const SpecialTransitions& specials, float tbmk,
+                             const DPBand& band, BandedDPMatrix& dp_matrix) {
+    assert(band.model_length == profile.model_length && band.sequence_length >= sequence_length);
+    dp_matrix.reshape(band);
+    return viterbi_fill(digital_sequence, sequence_length, profile, specials, tbmk, &dp_matrix.band(), dp_matrix);
+}
+
+float compute_viterbi_checkpointed(const DigitalResidue* digital_sequence, int sequence_length,
+                                  const HMMProfile& profile, const SpecialTransitions& specials, float tbmk,
+                                  CheckpointedDPMatrix& dp_matrix) {
+    dp_matrix.reshape(profile.model_length, sequence_length);
+    const float score = viterbi_fill(digital_sequence, sequence_length, profile, specials, tbmk, nullptr, dp_matrix);
+    dp_matrix.set_resident_block(dp_matrix.block_of(std::max(0, sequence_length)));
+    return score;
+}
+
+namespace {
+
+// `load_rows(i)` is called before every step and must leave rows i and
+// i - 1 of `dp_matrix` readable
+template<class Matrix, class RowLoader>
+std::vector<TraceCell> traceback(int sequence_length, const HMMProfile& profile, const SpecialTransitions& specials,
+                                 float tbmk, const Matrix& dp_matrix, RowLoader&& load_rows) {
+    enum TraceState { ST_N, ST_B, ST_M, ST_I, ST_D, ST_E, ST_J, ST_C };
+
+    const int M = profile.model_length;
+    int i = sequence_length;
+    std::vector<TraceCell> trace;
+    if (M <= 0 || i < 0 || dp_matrix.special(i, p7G_C) == -eslINFINITY) {
+        return trace;
+    }
+
+    // Walk back from C(L); at every step take the predecessor that attains
+    // the stored value (first one on ties), as p7_GTrace does
+    int k = 0;
+    TraceState st = ST_C;
+    while (st != ST_N) {
+        load_rows(i);
+        float best = -eslINFINITY;
+        TraceState next = st;
+        auto consider = [&](float value, TraceState state) {
+            if (value > best) {
+                best = value;
+                next = state;
+            }
+        };
+
+        switch (st) {
+        case ST_C:
+            consider(dp_matrix.special(i, p7G_E) + specials(p7P_E, p7P_MOVE), ST_E);
+            if (i > 0) {
+                consider(dp_matrix.special(i - 1, p7G_C) + specials(p7P_C, p7P_LOOP), ST_C);
+            }
+            if (next == ST_C) {
+                i--;
+            }
+            break;
+        case ST_J:
+            consider(dp_matrix.special(i, p7G_E) + specials(p7P_E, p7P_LOOP), ST_E);
+            if (i > 0) {
+                consider(dp_matrix.special(i - 1, p7G_J) + specials(p7P_J, p7P_LOOP), ST_J);
+            }
+            if (next == ST_J) {
+                i--;
+            }
+            break;
+        case ST_E: {
+            int best_k = 0;
+            for (int kk = 1; kk <= M; kk++) {
+                if (dp_matrix.match(i, kk) > best) {
+                    best = dp_matrix.match(i, kk);
+                    best_k = kk;
+                    next = ST_M;
+                }
+            }
+            if (dp_matrix.delete_state(i, M) > best) {
+                best = dp_matrix.delete_state(i, M);
+                best_k = M;
+                next = ST_D;
+            }
+            k = best_k;
+            break;
+        }
+        case ST_M:
+            trace.push_back({i, k, p7G_M});
+            consider(dp_matrix.special(i - 1, p7G_B) + tbmk, ST_B);
+            consider(dp_matrix.match(i - 1, k - 1) + profile.trans(k - 1, p7P_MM), ST_M);
+            consider(dp_matrix.insert(i - 1, k - 1) + profile.trans(k - 1, p7P_IM), ST_I);
+            consider(dp_matrix.delete_state(i - 1, k - 1) + profile.trans(k - 1, p7P_DM), ST_D);
+            i--;
+            k--;
+            break;
+        case ST_I:
+            trace.push_back({i, k, p7G_I});
+            consider(dp_matrix.match(i - 1, k) + profile.trans(k, p7P_MI), ST_M);
+            consider(dp_matrix.insert(i - 1, k) + profile.trans(k, p7P_II), ST_I);
+            i--;
+            break;
+        case ST_D:
+            trace.push_back({i, k, p7G_D});
+            consider(dp_matrix.match(i, k - 1) + profile.trans(k - 1, p7P_MD), ST_M);
+            consider(dp_matrix.delete_state(i, k - 1) + profile.trans(k - 1, p7P_DD), ST_D);
+            k--;
+            break;
+        case ST_B:
+            consider(dp_matrix.special(i, p7G_N) + specials(p7P_N, p7P_MOVE), ST_N);
+            consider(dp_matrix.special(i, p7G_J) + specials(p7P_J, p7P_MOVE), ST_J);
+            break;
+        case ST_N:
+            break;
+        }
+
+        if (best == -eslINFINITY) {
+            break;  // Inconsistent matrix; return what was traced
+        }
+        st = next;
+    }
+
+    std::reverse(trace.begin(), trace.end());
+    return trace;
+}
+
+}  // namespace
+
+std::vector<TraceCell> viterbi_traceback(int sequence_length, const HMMProfile& profile,
+                                         const SpecialTransitions& specials, float tbmk,
+                                         const DPMatrix& dp_matrix) {
+    return traceback(sequence_length, profile, specials, tbmk, dp_matrix, [](int) {});
+}
+
+std::vector<TraceCell> viterbi_traceback(int sequence_length, const HMMProfile& profile,
+                                         const SpecialTransitions& specials, float tbmk,
+                                         const BandedDPMatrix& dp_matrix) {
+    return traceback(sequence_length, profile, specials, tbmk, dp_matrix, [](int) {});
+}
+
+std::vector<TraceCell> viterbi_traceback(const DigitalResidue* digital_sequence, int sequence_length,
+                                         const HMMProfile& profile, const SpecialTransitions& specials, float tbmk,
+                                         CheckpointedDPMatrix& dp_matrix) {
+    assert(dp_matrix.model_length() == profile.model_length && dp_matrix.sequence_length() == sequence_length);
+    const int L = sequence_length;
+    const int B = dp_matrix.block_rows();
+
+    // Refill block b's rows from its checkpoint; the specials were kept
+    auto recompute = [&](int b) {
+        dp_matrix.set_resident_block(b);
+        const int last = std::min(L, (b * B) + B - 1);
+        for (int r = (b * B) + 1; r <= last; r++) {
+            viterbi_row(digital_sequence, profile, tbmk, nullptr, r, dp_matrix);
+        }
+    };
+    auto load_rows = [&](int i) {
+        for (int r : {i, i - 1}) {
+            if (r >= 0 && !dp_matrix.resident(r)) {
+                recompute(dp_matrix.block_of(r));
+            }
+        }
+    };
+    const CheckpointedDPMatrix& filled = dp_matrix;
+    return traceback(sequence_length, profile, specials, tbmk, filled, load_rows);
+}
+
+DPBand trace_band(const std::vector<TraceCell>& trace, int model_length, int sequence_length, int margin) {
+    DPBand band(model_length, sequence_length);
+    margin = std::max(0, margin);
+    for (const TraceCell& cell : trace) {
+        for (int r = cell.i - margin; r <= cell.i + margin; r++) {
+            band.include(r, cell.k - margin, cell.k + margin);
+        }
+    }
+    return band;
+}
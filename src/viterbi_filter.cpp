@@ -0,0 +1,219 @@
+#include "viterbi_filter.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr int NEG = ViterbiWordProfile::NEG_INF;
+constexpr int POS = ViterbiWordProfile::POS_MAX;
+
+// Saturating add with a sticky -infinity
+inline int16_t adds(int16_t a, int16_t b) {
+    if (a == NEG || b == NEG) {
+        return static_cast<int16_t>(NEG);
+    }
+    return static_cast<int16_t>(std::clamp(static_cast<int>(a) + static_cast<int>(b), NEG, POS));
+}
+
+inline WordVector adds(const WordVector& a, const WordVector& b) {
+    WordVector r;
+    for (int z = 0; z < VITERBI_LANES; z++) {
+        r[z] = adds(a[z], b[z]);
+    }
+    return r;
+}
+
+inline WordVector max(const WordVector& a, const WordVector& b) {
+    WordVector r;
+    for (int z = 0; z < VITERBI_LANES; z++) {
+        r[z] = std::max(a[z], b[z]);
+    }
+    return r;
+}
+
+// Move every lane up by one; lane 0 becomes -inf (node k-1 of lane 0 is
+// the last vector of the previous lane)
+inline WordVector rightshift(const WordVector& a) {
+    WordVector r;
+    r[0] = static_cast<int16_t>(NEG);
+    for (int z = 1; z < VITERBI_LANES; z++) {
+        r[z] = a[z - 1];
+    }
+    return r;
+}
+
+inline bool any_gt(const WordVector& a, const WordVector& b) {
+    bool gt = false;
+    for (int z = 0; z < VITERBI_LANES; z++) {
+        gt |= a[z] > b[z];
+    }
+    return gt;
+}
+
+inline int16_t hmax(const WordVector& a) {
+    return *std::max_element(a.begin(), a.end());
+}
+
+inline WordVector splat(int16_t v) {
+    WordVector r;
+    r.fill(v);
+    return r;
+}
+
+}  // namespace
+
+/*******************************************************************************
+ * ViterbiWordProfile
+ ******************************************************************************/
+
+ViterbiWordProfile::ViterbiWordProfile(const HMMProfile& profile, float tbmk, float scale)
+    : model_length(std::max(0, profile.model_length)),
+      Q(std::max(1, (model_length + VITERBI_LANES - 1) / VITERBI_LANES)),
+      Kp(profile.abc->Kp),
+      scale(scale),
+      match(static_cast<size_t>(Kp + 1) * Q, splat(static_cast<int16_t>(NEG))),
+      insert(static_cast<size_t>(Kp + 1) * Q, splat(static_cast<int16_t>(NEG))),
+      trans(static_cast<size_t>(Q) * NUM_TRANSITIONS, splat(static_cast<int16_t>(NEG)))
+{
+    const int M = model_length;
+    for (int k = 1; k <= M; k++) {
+        const int q = vector_of(k);
+        const int z = lane_of(k);
+        for (int x = 0; x < Kp; x++) {
+            match[(x * Q) + q][z] = wordify(profile.match_score(k, x));
+            insert[(x * Q) + q][z] = k < M ? wordify(profile.insert_score(k, x)) : static_cast<int16_t>(NEG);
+        }
+
+        WordVector* t = &trans[static_cast<size_t>(q) * NUM_TRANSITIONS];
+        t[T_BM][z] = wordify(tbmk);
+        t[T_MM][z] = wordify(profile.trans(k - 1, p7P_MM));
+        t[T_IM][z] = wordify(profile.trans(k - 1, p7P_IM));
+        t[T_DM][z] = wordify(profile.trans(k - 1, p7P_DM));
+        if (k < M) {
+            t[T_MD][z] = wordify(profile.trans(k, p7P_MD));
+            t[T_MI][z] = wordify(profile.trans(k, p7P_MI));
+            t[T_II][z] = wordify(profile.trans(k, p7P_II));
+            t[T_DD][z] = wordify(profile.trans(k, p7P_DD));
+        }
+    }
+}
+
+int16_t ViterbiWordProfile::wordify(float score) const {
+    if (std::isnan(score) || score == -eslINFINITY) {
+        return static_cast<int16_t>(NEG);
+    }
+    if (score == eslINFINITY) {
+        return static_cast<int16_t>(POS);
+    }
+    const long v = std::lround(score * scale);
+    return static_cast<int16_t>(std::clamp<long>(v, NEG, POS));
+}
+
+/*******************************************************************************
+ * viterbi_filter
+ ******************************************************************************/
+
+float viterbi_filter(const DigitalResidue* digital_sequence, int sequence_length, const ViterbiWordProfile& om,
+                     const SpecialTransitions& specials, std::vector<WordVector>& row_buffer) {
+    const int M = om.model_length;
+    const int L = sequence_length;
+    const int Q = om.Q;
+    if (M <= 0 || L < 0) {
+        return -eslINFINITY;
+    }
+
+    const int16_t t_nloop = om.wordify(specials(p7P_N, p7P_LOOP));
+    const int16_t t_nmove = om.wordify(specials(p7P_N, p7P_MOVE));
+    const int16_t t_eloop = om.wordify(specials(p7P_E, p7P_LOOP));
+    const int16_t t_emove = om.wordify(specials(p7P_E, p7P_MOVE));
+    const int16_t t_jloop = om.wordify(specials(p7P_J, p7P_LOOP));
+    const int16_t t_jmove = om.wordify(specials(p7P_J, p7P_MOVE));
+    const int16_t t_cloop = om.wordify(specials(p7P_C, p7P_LOOP));
+    const int16_t t_cmove = om.wordify(specials(p7P_C, p7P_MOVE));
+
+    row_buffer.assign(3 * static_cast<size_t>(Q), splat(static_cast<int16_t>(NEG)));
+    WordVector* mmx = row_buffer.data();
+    WordVector* imx = mmx + Q;
+    WordVector* dmx = imx + Q;
+
+    int16_t xN = static_cast<int16_t>(ViterbiWordProfile::BASE);
+    int16_t xB = adds(xN, t_nmove);
+    int16_t xJ = static_cast<int16_t>(NEG);
+    int16_t xC = static_cast<int16_t>(NEG);
+    const int end_q = om.vector_of(M);
+    const int end_z = om.lane_of(M);
+
+    for (int i = 1; i <= L; i++) {
+        const int x = digital_sequence[i] < om.Kp ? digital_sequence[i] : om.Kp;
+        const WordVector* rsc = &om.match[static_cast<size_t>(x) * Q];
+        const WordVector* isc = &om.insert[static_cast<size_t>(x) * Q];
+
+        // --- A. Match and insert cells; D gets M->D within each lane ---
+        WordVector mpv = rightshift(mmx[Q - 1]);
+        WordVector ipv = rightshift(imx[Q - 1]);
+        WordVector dpv = rightshift(dmx[Q - 1]);
+        WordVector xEv = splat(static_cast<int16_t>(NEG));
+        WordVector dcv = splat(static_cast<int16_t>(NEG));
+        const WordVector xBv = splat(xB);
+
+        for (int q = 0; q < Q; q++) {
+            const WordVector* t = &om.trans[static_cast<size_t>(q) * ViterbiWordProfile::NUM_TRANSITIONS];
+            WordVector sv = adds(xBv, t[ViterbiWordProfile::T_BM]);
+            sv = max(sv, adds(mpv, t[ViterbiWordProfile::T_MM]));
+            sv = max(sv, adds(ipv, t[ViterbiWordProfile::T_IM]));
+            sv = max(sv, adds(dpv, t[ViterbiWordProfile::T_DM]));
+            sv = adds(sv, rsc[q]);
+            xEv = max(xEv, sv);
+
+            // Previous row's cells at q are next q's diagonal predecessors
+            mpv = mmx[q];
+            ipv = imx[q];
+            dpv = dmx[q];
+
+            mmx[q] = sv;
+            dmx[q] = dcv;
+            dcv = adds(sv, t[ViterbiWordProfile::T_MD]);
+            imx[q] = adds(max(adds(mpv, t[ViterbiWordProfile::T_MI]), adds(ipv, t[ViterbiWordProfile::T_II])),
+                          isc[q]);
+        }
+
+        // --- B. Lazy F: carry D->D chains across lanes until nothing improves ---
+        dcv = rightshift(dcv);
+        for (int q = 0; q < Q; q++) {
+            dmx[q] = max(dcv, dmx[q]);
+            dcv = adds(dmx[q], om.trans[(static_cast<size_t>(q) * ViterbiWordProfile::NUM_TRANSITIONS) +
+                                        ViterbiWordProfile::T_DD]);
+        }
+        bool improved = true;
+        while (improved) {
+            dcv = rightshift(dcv);
+            improved = false;
+            for (int q = 0; q < Q; q++) {
+                if (!any_gt(dcv, dmx[q])) {
+                    break;
+                }
+                dmx[q] = max(dcv, dmx[q]);
+                dcv = adds(dmx[q], om.trans[(static_cast<size_t>(q) * ViterbiWordProfile::NUM_TRANSITIONS) +
+                                            ViterbiWordProfile::T_DD]);
+                improved = q == Q - 1;
+            }
+        }
+
+        // --- C. Specials ---
+        const int16_t xE = std::max(hmax(xEv), dmx[end_q][end_z]);
+        if (xE >= POS) {
+            return eslINFINITY;
+        }
+        xN = adds(xN, t_nloop);
+        xJ = std::max(adds(xJ, t_jloop), adds(xE, t_eloop));
+        xC = std::max(adds(xC, t_cloop), adds(xE, t_emove));
+        xB = std::max(adds(xN, t_nmove), adds(xJ, t_jmove));
+    }
+
+    const int16_t sc = adds(xC, t_cmove);
+    if (sc == NEG) {
+        return -eslINFINITY;
+    }
+    return static_cast<float>(static_cast<int>(sc) - ViterbiWordProfile::BASE) / om.scale;
+}
@@ -0,0 +1,55 @@
+/*******************************************************************************
+ * File: tests/fuzz_msv_kernels.cpp
+ * Description: libFuzzer target comparing every MSV kernel with the scalar
+ * reference. Built only with -DMSV_BUILD_FUZZERS=ON and a Clang compiler.
+ *
+ * Input layout:
+ *   bytes 0..3   seed for the match scores
+ *   byte  4      model length (1..128, 0 maps to an empty model)
+ *   byte  5      bit 0: DNA alphabet; bits 1-2: score mode
+ *   bytes 6..    residues; byte b becomes code b % (Kp + 2), where Kp maps
+ *                to the illegal code and Kp+1 to a sentinel byte
+ ******************************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include "kernel_diff.hpp"
+#include "aa_alphabet.hpp"
+#include "nt_alphabet.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    static const AminoAcidAlphabet amino;
+    static const NucleotideAlphabet dna;
+    if (size < 6) {
+        return 0;
+    }
+
+    const uint32_t seed = static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+                          (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+    const int model_length = data[4] % 129;
+    const DigitalAlphabet& abc = (data[5] & 1) ? static_cast<const DigitalAlphabet&>(dna) : amino;
+    const auto mode = static_cast<msv_test::ScoreMode>(((data[5] >> 1) & 3) % 3);
+
+    const int sequence_length = static_cast<int>(size - 6);
+    std::vector<DigitalResidue> dsq(sequence_length + 2);
+    dsq[0] = digitalResidueSentinel;
+    dsq[sequence_length + 1] = digitalResidueSentinel;
+    for (int i = 0; i < sequence_length; i++) {
+        const int code = data[6 + i] % (abc.Kp + 2);
+        dsq[i + 1] = static_cast<DigitalResidue>(code < abc.Kp ? code
+                                                 : (code == abc.Kp ? digitalResidueIllegal : digitalResidueSentinel));
+    }
+
+    std::mt19937 rng(seed);
+    msv_test::DiffCase c{&abc, msv_test::random_profile(abc, model_length, mode, rng), dsq, sequence_length};
+    for (const msv_test::KernelCheck& check : msv_test::run_differential(c, 10.0f)) {
+        if (!check.ok) {
+            std::fprintf(stderr, "%s: %s (%s) reference=%g actual=%g tolerance=%g\n", check.kernel.c_str(),
+                         check.detail.c_str(), c.describe().c_str(), check.reference, check.actual, check.tolerance);
+            std::abort();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,223 @@
+/*******************************************************************************
+ * File: tests/kernel_diff.hpp
+ * Description: Differential testing of the fast MSV kernels against the
+ * scalar reference (compute_msv).
+ *
+ * Shared by the randomized gtest suite (test_msv_differential.cpp) and the
+ * libFuzzer target (fuzz_msv_kernels.cpp). A DiffCase is one profile and one
+ * sequence; run_differential() scores it with the reference and with every
+ * kernel that applies to its alphabet, and checks each kernel's score and
+ * pass/fail decision against the reference within that kernel's tolerance.
+ ******************************************************************************/
+
+#ifndef MSV_FILTER_KERNEL_DIFF_HPP
+#define MSV_FILTER_KERNEL_DIFF_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "hmmer_types.hpp"
+#include "alphabet.hpp"
+#include "profile.hpp"
+#include "dp_matrix.hpp"
+#include "msv_kernel.hpp"
+#include "nt_msv.hpp"
+
+float compute_msv(const DigitalResidue* digital_sequence, int sequence_length,
+                  const HMMProfile& profile, DPMatrix& dp_matrix, float expected_hit_count);
+
+namespace msv_test {
+
+// ============================================================================
+// Case Generation
+// ============================================================================
+
+// How match scores are drawn
+enum class ScoreMode {
+    TYPICAL,   // Uniform in [-4, 3] nats
+    GRID,      // Whole multiples of one uint8 unit (1/3 bit)
+    EXTREME,   // Mix of -inf, huge, tiny and ordinary scores
+};
+
+struct DiffCase {
+    const DigitalAlphabet* abc;
+    HMMProfile profile;
+    std::vector<DigitalResidue> digital_sequence;  // Sentinel-framed
+    int sequence_length;
+
+    std::string describe() const {
+        std::ostringstream out;
+        out << (abc->K == 4 ? "DNA" : "amino") << " M=" << profile.model_length << " L=" << sequence_length;
+        return out.str();
+    }
+};
+
+inline HMMProfile random_profile(const DigitalAlphabet& abc, int model_length, ScoreMode mode, std::mt19937& rng) {
+    HMMProfile profile(model_length, &abc);
+    profile.model_length = model_length;
+    profile.name = "differential_model";
+    profile.max_length = 100;
+
+    std::uniform_real_distribution<float> typical(-4.0f, 3.0f);
+    std::uniform_int_distribution<int> grid(-12, 9);
+    std::uniform_int_distribution<int> pick(0, 9);
+    const float unit = eslCONST_LOG2 / 3.0f;
+
+    for (int k = 1; k <= model_length; k++) {
+        for (int x = 0; x < abc.K; x++) {
+            float sc = 0.0f;
+            switch (mode) {
+            case ScoreMode::TYPICAL:
+                sc = typical(rng);
+                break;
+            case ScoreMode::GRID:
+                sc = static_cast<float>(grid(rng)) * unit;
+                break;
+            case ScoreMode::EXTREME:
+                switch (pick(rng)) {
+                case 0: sc = -eslINFINITY; break;
+                case 1: sc = -1.0e4f; break;
+                case 2: sc = 50.0f; break;
+                case 3: sc = 1.0e-6f; break;
+                case 4: sc = -1.0e-6f; break;
+                default: sc = typical(rng); break;
+                }
+                break;
+            }
+            profile.match_score(k, x) = sc;
+        }
+    }
+    return profile;
+}
+
+// Residues are mostly canonical; `degenerate_rate` of them are drawn from the
+// non-canonical codes K..Kp-1 (gap, degeneracies, *, ~) or are illegal bytes.
+inline std::vector<DigitalResidue> random_sequence(const DigitalAlphabet& abc, int sequence_length,
+                                                   double degenerate_rate, std::mt19937& rng) {
+    std::vector<DigitalResidue> dsq(sequence_length + 2);
+    dsq[0] = digitalResidueSentinel;
+    dsq[sequence_length + 1] = digitalResidueSentinel;
+
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    std::uniform_int_distribution<int> canonical(0, abc.K - 1);
+    std::uniform_int_distribution<int> other(abc.K, abc.Kp);
+    for (int i = 1; i <= sequence_length; i++) {
+        if (coin(rng) < degenerate_rate) {
+            const int code = other(rng);
+            dsq[i] = static_cast<DigitalResidue>(code == abc.Kp ? digitalResidueIllegal : code);
+        } else {
+            dsq[i] = static_cast<DigitalResidue>(canonical(rng));
+        }
+    }
+    return dsq;
+}
+
+inline DiffCase random_case(const DigitalAlphabet& abc, int model_length, int sequence_length, ScoreMode mode,
+                            double degenerate_rate, std::mt19937& rng) {
+    return {&abc, random_profile(abc, model_length, mode, rng),
+            random_sequence(abc, sequence_length, degenerate_rate, rng), sequence_length};
+}
+
+// ============================================================================
+// Comparison
+// ============================================================================
+
+struct KernelCheck {
+    std::string kernel;
+    float reference;
+    float actual;
+    float tolerance;
+    bool ok;
+    std::string detail;
+};
+
+namespace detail {
+
+inline bool passes(float score, float threshold) {
+    return score >= threshold;
+}
+
+// Check one kernel result. `overflow_floor` is the smallest true score (in
+// nats) at which an integer kernel may legitimately saturate.
+inline KernelCheck check_kernel(const std::string& kernel, float reference, float actual, float tolerance,
+                                float overflow_floor, float threshold) {
+    KernelCheck check{kernel, reference, actual, tolerance, true, ""};
+    if (std::isinf(actual)) {
+        if (reference < overflow_floor - tolerance) {
+            check.ok = false;
+            check.detail = "saturated below the overflow floor";
+        }
+        return check;
+    }
+    if (std::fabs(reference - actual) > tolerance) {
+        check.ok = false;
+        check.detail = "score outside tolerance";
+    } else if (passes(reference, threshold) != passes(actual, threshold) &&
+               std::fabs(reference - threshold) > tolerance) {
+        check.ok = false;
+        check.detail = "pass decision differs";
+    }
+    return check;
+}
+
+template<class Traits, class Policy>
+KernelCheck run_policy(const DiffCase& c, float reference, float threshold) {
+    MatchScoreTable<Traits::K, Policy> table(c.profile);
+    std::vector<typename Policy::cell_type> buffer;
+    const float actual = msv_kernel<Traits, Policy>(c.digital_sequence.data(), c.sequence_length, table, buffer);
+
+    // Float sums in the same order as the reference; integer kernels round
+    // each cell on the best segment by at most half a unit
+    float tolerance = 1e-4f * std::max(1.0f, std::fabs(reference));
+    if constexpr (!std::is_floating_point_v<typename Policy::cell_type>) {
+        const int segment_max = std::max(0, std::min(c.profile.model_length, c.sequence_length));
+        tolerance += 0.5f * static_cast<float>(segment_max) / table.quant.scale;
+    }
+
+    const float overflow_floor =
+        static_cast<float>(std::numeric_limits<typename Policy::cell_type>::max() - table.quant.bias) /
+        table.quant.scale;
+    return check_kernel(std::string(Policy::name) + (Traits::K == 4 ? "/dna" : "/amino"), reference, actual,
+                        tolerance, overflow_floor, threshold);
+}
+
+template<class Traits>
+void run_family(const DiffCase& c, float reference, float threshold, std::vector<KernelCheck>& checks) {
+    checks.push_back(run_policy<Traits, FloatPolicy>(c, reference, threshold));
+    checks.push_back(run_policy<Traits, Int16Policy>(c, reference, threshold));
+    checks.push_back(run_policy<Traits, Uint8Policy>(c, reference, threshold));
+}
+
+}  // namespace detail
+
+// Score `c` with the reference and every applicable kernel
+inline std::vector<KernelCheck> run_differential(const DiffCase& c, float threshold) {
+    DPMatrix dp_matrix(c.profile.model_length, c.sequence_length);
+    const float reference = compute_msv(c.digital_sequence.data(), c.sequence_length, c.profile, dp_matrix, 2.0f);
+
+    std::vector<KernelCheck> checks;
+    if (c.abc->K == AminoTraits::K) {
+        detail::run_family<AminoTraits>(c, reference, threshold, checks);
+    } else if (c.abc->K == NucleotideTraits::K) {
+        detail::run_family<NucleotideTraits>(c, reference, threshold, checks);
+
+        PackedNucleotideSequence packed;
+        if (packed.pack(c.digital_sequence.data(), c.sequence_length)) {
+            NucleotideScoreRows rows(c.profile);
+            std::vector<float> buffer;
+            const float actual = compute_msv_packed(packed, rows, buffer);
+            checks.push_back(detail::check_kernel("packed/dna", reference, actual,
+                                                  1e-4f * std::max(1.0f, std::fabs(reference)), eslINFINITY,
+                                                  threshold));
+        }
+    }
+    return checks;
+}
+
+}  // namespace msv_test
+
+#endif // MSV_FILTER_KERNEL_DIFF_HPP
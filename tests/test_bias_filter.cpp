@@ -0,0 +1,96 @@
+/*******************************************************************************
+ * File: tests/test_bias_filter.cpp
+ * Description: Tests for the two-state composition filter null: lane-chunked
+ * score() against the scalar recurrence, and its response to biased input.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include "bias_filter.hpp"
+#include "kernel_diff.hpp"
+#include "mock_data.hpp"
+#include "pvalue.hpp"
+#include "test_vectors.hpp"
+
+namespace {
+
+// Every node prefers residue `x`, so compo is heavily skewed towards it
+HMMProfile single_residue_profile(const AminoAcidAlphabet& abc, int model_length, int x) {
+    HMMProfile profile = MockDataGenerator::create_pattern_profile(model_length, abc);
+    for (int k = 1; k <= model_length; k++) {
+        for (int y = 0; y < abc.K; y++) {
+            profile.match_score(k, y) = y == x ? 2.0f : -1.0f;
+        }
+    }
+    return profile;
+}
+
+}  // namespace
+
+TEST(BiasFilterTest, OddsFollowCompo) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = MockDataGenerator::create_pattern_profile(10, abc);
+    for (int x = 0; x < abc.K; x++) {
+        profile.compo[x] = x < 10 ? 0.08f : 0.02f;
+    }
+    BiasFilter filter(profile);
+    EXPECT_NEAR(1.6f, filter.odds(0), 1e-5f);
+    EXPECT_NEAR(0.4f, filter.odds(19), 1e-5f);
+    EXPECT_EQ(1.0f, filter.odds(static_cast<DigitalResidue>(abc.K)));
+    EXPECT_EQ(1.0f, filter.odds(digitalResidueSentinel));
+}
+
+TEST(BiasFilterTest, UnsetCompoIsTheMeanMatchEmission) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    BiasFilter filter(single_residue_profile(abc, 16, 3));
+    const double preferred = std::exp(2.0);
+    const double other = std::exp(-1.0);
+    const double total = preferred + (19.0 * other);
+    EXPECT_NEAR(preferred / total * 20.0, filter.odds(3), 1e-4);
+    EXPECT_NEAR(other / total * 20.0, filter.odds(4), 1e-4);
+}
+
+TEST(BiasFilterTest, ChunkedScoreMatchesScalar) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(29);
+    BiasFilter pattern(MockDataGenerator::create_pattern_profile(40, abc));
+    BiasFilter skewed(single_residue_profile(abc, 40, 0));
+    for (int L : {1, 2, 5, 255, 256, 257, 258, 300, 777, 1024, 4099, 20000}) {
+        std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.02, rng);
+        for (int i = L / 4; i < L / 2; i++) {
+            dsq[i] = 0;  // A low-complexity run for the skewed filter to pick up
+        }
+        for (const BiasFilter* filter : {&pattern, &skewed}) {
+            const float expected = filter->score_scalar(dsq.data(), L);
+            EXPECT_NEAR(expected, filter->score(dsq.data(), L), 1e-3f + (std::fabs(expected) * 1e-5f))
+                << "L=" << L;
+        }
+    }
+}
+
+TEST(BiasFilterTest, CloseToTheIidNullOnUnbiasedSequence) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    BiasFilter filter(MockDataGenerator::create_gapped_pattern_profile(40, abc));
+    std::mt19937 rng(4);
+    for (int L : {50, 500, 5000}) {
+        std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.0, rng);
+        EXPECT_NEAR(null_one_score(L), filter.score(dsq.data(), L), 3.0f + (L / 400.0f)) << "L=" << L;
+    }
+}
+
+TEST(BiasFilterTest, LowComplexityRunRaisesTheNull) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    BiasFilter filter(single_residue_profile(abc, 40, 0));
+    std::mt19937 rng(6);
+    const int L = 600;
+    std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.0, rng);
+    const float before = filter.score(dsq.data(), L);
+    for (int i = 200; i < 260; i++) {
+        dsq[i] = 0;
+    }
+    const float after = filter.score(dsq.data(), L);
+
+    // ~log(odds(A)) per run residue, less the switching costs
+    EXPECT_GT(after - before, 60.0f * std::log(filter.odds(0)) - 20.0f);
+}
@@ -0,0 +1,327 @@
+/*******************************************************************************
+ * File: tests/test_forward.cpp
+ * Description: Tests for the table-driven logsum, generic Forward, Viterbi
+ * traceback, Forward restricted to the Viterbi band and seeded banded
+ * Viterbi over sparse storage.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <utility>
+#include "forward.hpp"
+#include "kernel_diff.hpp"
+#include "logsum.hpp"
+#include "mock_data.hpp"
+#include "msv_segments.hpp"
+#include "test_vectors.hpp"
+#include "viterbi.hpp"
+
+namespace {
+
+float exact_logsum(float a, float b) {
+    const double m = std::max(a, b);
+    return static_cast<float>(m + std::log(std::exp(a - m) + std::exp(b - m)));
+}
+
+// Planted copy of the pattern profile's preferred residues in random sequence
+std::vector<DigitalResidue> planted_sequence(const AminoAcidAlphabet& abc, int model_length, int L, int offset,
+                                             std::mt19937& rng) {
+    std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.0, rng);
+    for (int k = 1; k <= model_length; k++) {
+        dsq[offset + k - 1] = static_cast<DigitalResidue>((k - 1) % abc.K);
+    }
+    return dsq;
+}
+
+// The gapped pattern profile with each node's preferred residue moved to a
+// random one, so no shifted copy of the model scores like the real diagonal
+HMMProfile shuffled_pattern_profile(const AminoAcidAlphabet& abc, int model_length, std::mt19937& rng,
+                                    std::vector<DigitalResidue>& consensus) {
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(model_length, abc);
+    consensus.assign(static_cast<size_t>(model_length) + 1, 0);
+    for (int k = 1; k <= model_length; k++) {
+        const int from = (k - 1) % abc.K;
+        const int to = static_cast<int>(rng() % abc.K);
+        std::swap(profile.match_score(k, from), profile.match_score(k, to));
+        consensus[k] = static_cast<DigitalResidue>(to);
+    }
+    return profile;
+}
+
+}  // namespace
+
+// ============================================================================
+// Logsum
+// ============================================================================
+
+TEST(LogsumTest, TableMatchesExactWithinTolerance) {
+    for (float a = -20.0f; a <= 20.0f; a += 0.37f) {
+        for (float d = 0.0f; d <= 18.0f; d += 0.013f) {
+            EXPECT_NEAR(exact_logsum(a, a - d), p7_FLogsum(a, a - d), 1e-3f) << "a=" << a << " d=" << d;
+        }
+    }
+}
+
+TEST(LogsumTest, InfinityAndSymmetry) {
+    EXPECT_EQ(3.0f, p7_FLogsum(3.0f, -eslINFINITY));
+    EXPECT_EQ(3.0f, p7_FLogsum(-eslINFINITY, 3.0f));
+    EXPECT_EQ(-eslINFINITY, p7_FLogsum(-eslINFINITY, -eslINFINITY));
+    EXPECT_EQ(p7_FLogsum(1.5f, -2.0f), p7_FLogsum(-2.0f, 1.5f));
+    EXPECT_NEAR(std::log(2.0f), p7_FLogsum(0.0f, 0.0f), 1e-3f);
+}
+
+// ============================================================================
+// Forward
+// ============================================================================
+
+TEST(ForwardTest, SumsAllPathsOfATinyModel) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(1, abc);
+    LengthConfigCache config(profile, 2.0f, 16);
+    std::vector<DigitalResidue> dsq = msv_test::create_digital_sequence({0, 0});  // A A
+
+    DPMatrix dp_matrix(1, 2);
+    const float score = compute_forward(dsq.data(), 2, profile, config, dp_matrix);
+
+    // M=1, L=2: the match emits one A and N or C emits the other, or two
+    // domains joined through J (tbmk = 0 for M=1)
+    const SpecialTransitions st = config.for_length(2);
+    const float n_loop = st(p7P_N, p7P_LOOP);
+    const float n_move = st(p7P_N, p7P_MOVE);
+    const float c_loop = st(p7P_C, p7P_LOOP);
+    const float c_move = st(p7P_C, p7P_MOVE);
+    const float e_loop = st(p7P_E, p7P_LOOP);
+    const float e_move = st(p7P_E, p7P_MOVE);
+    const float j_move = st(p7P_J, p7P_MOVE);
+    const float a = n_loop + n_move + 2.0f + e_move + c_move;
+    const float b = n_move + 2.0f + e_move + c_loop + c_move;
+    const float c = n_move + 2.0f + e_loop + j_move + 2.0f + e_move + c_move;
+    EXPECT_NEAR(exact_logsum(exact_logsum(a, b), c), score, 3e-3f);
+}
+
+TEST(ForwardTest, ForwardIsAtLeastViterbi) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(5);
+    for (int n = 0; n < 20; n++) {
+        const int M = 5 + (3 * n);
+        const int L = 20 + (7 * n);
+        HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(M, abc);
+        LengthConfigCache config(profile, 2.0f, 512);
+        std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.02, rng);
+
+        DPMatrix vit(M, L);
+        DPMatrix fwd(M, L);
+        const float v = compute_viterbi(dsq.data(), L, profile, config, vit);
+        const float f = compute_forward(dsq.data(), L, profile, config, fwd);
+        EXPECT_GE(f, v - 1e-3f) << "M=" << M << " L=" << L;
+    }
+}
+
+// ============================================================================
+// Viterbi Traceback
+// ============================================================================
+
+TEST(ViterbiTraceTest, PlantedHitTracesTheDiagonal) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(17);
+    const int M = 30;
+    const int L = 200;
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(M, abc);
+    LengthConfigCache config(profile, 2.0f, 512);
+    std::vector<DigitalResidue> dsq = planted_sequence(abc, M, L, 81, rng);
+
+    DPMatrix dp_matrix(M, L);
+    compute_viterbi(dsq.data(), L, profile, config, dp_matrix);
+    std::vector<TraceCell> trace = viterbi_traceback(L, profile, config.for_length(L),
+                                                     config.msv_params(L).tbmk, dp_matrix);
+
+    ASSERT_EQ(static_cast<size_t>(M), trace.size());
+    for (int k = 1; k <= M; k++) {
+        EXPECT_EQ(p7G_M, trace[k - 1].state);
+        EXPECT_EQ(k, trace[k - 1].k);
+        EXPECT_EQ(80 + k, trace[k - 1].i);
+    }
+}
+
+TEST(ViterbiTraceTest, TraceFollowsInsertAndDeleteStates) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    const int M = 10;
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(M, abc);
+    for (int k = 1; k < M; k++) {
+        for (int x = 0; x < abc.K; x++) {
+            profile.insert_score(k, x) = 0.0f;
+        }
+    }
+    LengthConfigCache config(profile, 2.0f, 64);
+
+    // Nodes 1..4, one inserted residue (W), nodes 5..7, skip 8, nodes 9..10
+    std::vector<DigitalResidue> residues;
+    for (int k : {1, 2, 3, 4, -1, 5, 6, 7, 9, 10}) {
+        residues.push_back(k < 0 ? static_cast<DigitalResidue>(18) : static_cast<DigitalResidue>(k - 1));
+    }
+    std::vector<DigitalResidue> dsq = msv_test::create_digital_sequence(residues);
+    const int L = static_cast<int>(residues.size());
+
+    DPMatrix dp_matrix(M, L);
+    compute_viterbi(dsq.data(), L, profile, config, dp_matrix);
+    std::vector<TraceCell> trace = viterbi_traceback(L, profile, config.for_length(L),
+                                                     config.msv_params(L).tbmk, dp_matrix);
+
+    std::string states;
+    for (const TraceCell& cell : trace) {
+        states += cell.state == p7G_M ? 'M' : (cell.state == p7G_I ? 'I' : 'D');
+    }
+    EXPECT_EQ("MMMMIMMMDMM", states);
+}
+
+// ============================================================================
+// Banded (Sparse) Forward
+// ============================================================================
+
+TEST(ForwardBandTest, FullBandEqualsFullForward) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(23);
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(25, abc);
+    LengthConfigCache config(profile, 2.0f, 512);
+    std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, 90, 0.02, rng);
+
+    DPMatrix full(25, 90);
+    DPMatrix banded(25, 90);
+    const float expected = compute_forward(dsq.data(), 90, profile, config, full);
+    const float actual = compute_forward_banded(dsq.data(), 90, profile, config.for_length(90),
+                                                config.msv_params(90).tbmk, DPBand::full(25, 90), banded);
+    EXPECT_EQ(expected, actual);
+}
+
+TEST(ForwardBandTest, ViterbiBandRecoversForwardAtAFractionOfTheCells) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(31);
+    const int M = 40;
+    const int L = 600;
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(M, abc);
+    LengthConfigCache config(profile, 2.0f, 1024);
+    std::vector<DigitalResidue> dsq = planted_sequence(abc, M, L, 300, rng);
+    const SpecialTransitions st = config.for_length(L);
+    const float tbmk = config.msv_params(L).tbmk;
+
+    DPMatrix dp_matrix(M, L);
+    const float viterbi = compute_viterbi(dsq.data(), L, profile, st, tbmk, dp_matrix);
+    const DPBand band = trace_band(viterbi_traceback(L, profile, st, tbmk, dp_matrix), M, L, 8);
+
+    DPMatrix full(M, L);
+    const float forward = compute_forward(dsq.data(), L, profile, st, tbmk, full);
+    const float sparse = compute_forward_banded(dsq.data(), L, profile, st, tbmk, band, dp_matrix);
+
+    EXPECT_GE(sparse, viterbi - 1e-3f);
+    EXPECT_LE(sparse, forward + 1e-3f);
+    EXPECT_NEAR(forward, sparse, 0.5f);
+    EXPECT_LT(static_cast<double>(band.cells()), 0.1 * M * L);
+}
+
+// ============================================================================
+// Seeded Banded Viterbi (sparse storage)
+// ============================================================================
+
+TEST(SeededBandTest, BandCoversEachSeedDiagonal) {
+    std::vector<MSVSegment> seeds = {{21, 30, 1, 10, 12.0f}};  // d = 20
+    const DPBand band = seed_band(seeds, 50, 200, 3);
+    EXPECT_FALSE(band.contains(17, 1));
+    EXPECT_TRUE(band.contains(18, 1));
+    EXPECT_TRUE(band.contains(40, 17));
+    EXPECT_TRUE(band.contains(40, 23));
+    EXPECT_FALSE(band.contains(40, 24));
+    EXPECT_TRUE(band.contains(73, 50));
+    EXPECT_FALSE(band.contains(74, 50));
+    EXPECT_EQ(band.cells(), BandedDPMatrix(band).cells());
+}
+
+TEST(SeededBandTest, SeedsOnDistantDiagonalsWidenTheRowsTheyShare) {
+    const int M = 100;
+    const int L = 100;
+    const int w = 4;
+    const std::vector<MSVSegment> near = {{1, 40, 1, 40, 10.0f}};    // d = 0
+    const std::vector<MSVSegment> far = {{1, 40, 61, 100, 10.0f}};   // d = -60, rows 1..44
+    std::vector<MSVSegment> both = near;
+    both.push_back(far.front());
+
+    const uint64_t one_seed = static_cast<uint64_t>(M + 2 * w) * (2 * w + 1);
+    EXPECT_LE(seed_band(near, M, L, w).cells(), one_seed);
+    EXPECT_LE(seed_band(far, M, L, w).cells(), one_seed);
+
+    // Each shared row keeps the hull, columns i - 4 .. i + 64
+    const DPBand band = seed_band(both, M, L, w);
+    EXPECT_TRUE(band.contains(30, 60));
+    EXPECT_EQ(69, band.kmax[30] - band.kmin[30] + 1);
+    EXPECT_GT(band.cells(), 2 * one_seed);
+}
+
+TEST(SeededBandTest, FullBandEqualsFullViterbi) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(67);
+    for (int n = 0; n < 10; n++) {
+        const int M = 6 + (4 * n);
+        const int L = 30 + (11 * n);
+        HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(M, abc);
+        LengthConfigCache config(profile, 2.0f, 512);
+        std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.02, rng);
+        const SpecialTransitions st = config.for_length(L);
+        const float tbmk = config.msv_params(L).tbmk;
+
+        DPMatrix full(M, L);
+        BandedDPMatrix banded;
+        const float expected = compute_viterbi(dsq.data(), L, profile, st, tbmk, full);
+        EXPECT_EQ(expected, compute_viterbi_banded(dsq.data(), L, profile, st, tbmk, DPBand::full(M, L), banded));
+        EXPECT_EQ(static_cast<uint64_t>(M) * L, banded.cells());
+
+        // Same path from the sparse matrix
+        const std::vector<TraceCell> a = viterbi_traceback(L, profile, st, tbmk, full);
+        const std::vector<TraceCell> b = viterbi_traceback(L, profile, st, tbmk, banded);
+        ASSERT_EQ(a.size(), b.size());
+        for (size_t c = 0; c < a.size(); c++) {
+            EXPECT_EQ(a[c].i, b[c].i);
+            EXPECT_EQ(a[c].k, b[c].k);
+            EXPECT_EQ(a[c].state, b[c].state);
+        }
+    }
+}
+
+TEST(SeededBandTest, MSVSeedsRecoverViterbiInAFractionOfTheCells) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(71);
+    const int M = 200;
+    const int L = 2000;
+    std::vector<DigitalResidue> consensus;
+    HMMProfile profile = shuffled_pattern_profile(abc, M, rng, consensus);
+    LengthConfigCache config(profile, 2.0f, 4096);
+    std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.0, rng);
+    for (int k = 1; k <= M; k++) {
+        dsq[700 + k - 1] = consensus[k];
+    }
+    // A two-residue insertion halfway through shifts the second half by two diagonals
+    dsq.insert(dsq.begin() + 800, {static_cast<DigitalResidue>(18), static_cast<DigitalResidue>(18)});
+    dsq.resize(L + 2);
+    dsq[L + 1] = digitalResidueSentinel;
+    const SpecialTransitions st = config.for_length(L);
+    const float tbmk = config.msv_params(L).tbmk;
+
+    AminoScoreTable table(profile);
+    std::vector<SegmentRun<float>> runs;
+    std::vector<MSVSegment> seeds;
+    msv_kernel_segments<AminoTraits>(dsq.data(), L, table, runs, 1, seeds);
+    ASSERT_EQ(1u, seeds.size());
+
+    DPMatrix full(M, L);
+    BandedDPMatrix banded;
+    const float expected = compute_viterbi(dsq.data(), L, profile, st, tbmk, full);
+    const float actual = compute_viterbi_banded(dsq.data(), L, profile, st, tbmk, seed_band(seeds, M, L, 8), banded);
+    EXPECT_EQ(expected, actual);
+    EXPECT_LT(static_cast<double>(banded.cells()), 0.02 * M * L);
+    EXPECT_LT(banded.bytes(), full.dp.size() * full.dp[0].size() * sizeof(float) / 20);
+
+    // And Forward in the resulting trace band, stored sparsely too
+    const DPBand band = trace_band(viterbi_traceback(L, profile, st, tbmk, banded), M, L, 8);
+    DPMatrix dense(M, L);
+    const float dense_forward = compute_forward_banded(dsq.data(), L, profile, st, tbmk, band, dense);
+    EXPECT_EQ(dense_forward, compute_forward_banded(dsq.data(), L, profile, st, tbmk, band, banded));
+}
@@ -0,0 +1,121 @@
+/*******************************************************************************
+ * File: tests/test_incremental_msv.cpp
+ * Description: Tests for incremental MSV rescoring after profile edits. Every
+ * rescored sequence must match a full compute_msv() of the edited profile.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <random>
+#include "incremental_msv.hpp"
+#include "kernel_diff.hpp"
+#include "test_vectors.hpp"
+
+namespace {
+
+float full_msv(const std::vector<DigitalResidue>& dsq, int L, const HMMProfile& profile) {
+    DPMatrix dp_matrix(profile.model_length, L);
+    return compute_msv(dsq.data(), L, profile, dp_matrix, 1.0f);
+}
+
+}  // namespace
+
+// ============================================================================
+// Correctness
+// ============================================================================
+
+TEST(IncrementalMSVTest, InitialScoresMatchFullScan) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(7);
+    HMMProfile profile = msv_test::random_profile(abc, 60, msv_test::ScoreMode::TYPICAL, rng);
+    IncrementalMSV engine(profile);
+
+    std::vector<std::vector<DigitalResidue>> sequences;
+    for (int L : {0, 1, 17, 60, 150}) {
+        sequences.push_back(msv_test::random_sequence(abc, L, 0.05, rng));
+        const int id = engine.add_sequence(sequences.back().data(), L);
+        EXPECT_FLOAT_EQ(full_msv(sequences.back(), L, profile), engine.score(id)) << "L=" << L;
+    }
+    EXPECT_EQ(5, engine.num_sequences());
+}
+
+TEST(IncrementalMSVTest, RescoreAfterEditsMatchesFullScan) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(11);
+    HMMProfile profile = msv_test::random_profile(abc, 80, msv_test::ScoreMode::TYPICAL, rng);
+    IncrementalMSV engine(profile);
+
+    std::vector<std::vector<DigitalResidue>> sequences;
+    std::vector<int> lengths;
+    std::uniform_int_distribution<int> length(1, 40);
+    for (int n = 0; n < 30; n++) {
+        lengths.push_back(length(rng));
+        sequences.push_back(msv_test::random_sequence(abc, lengths.back(), 0.05, rng));
+        engine.add_sequence(sequences.back().data(), lengths.back());
+    }
+
+    std::uniform_int_distribution<int> column(1, 80);
+    std::uniform_int_distribution<int> residue(0, abc.K - 1);
+    std::uniform_real_distribution<float> value(-4.0f, 6.0f);
+    for (int round = 0; round < 10; round++) {
+        for (int e = 0; e < 3; e++) {
+            engine.set_match_score(column(rng), residue(rng), value(rng));
+        }
+        engine.rescore();
+        for (int id = 0; id < engine.num_sequences(); id++) {
+            EXPECT_FLOAT_EQ(full_msv(sequences[id], lengths[id], profile), engine.score(id))
+                << "round " << round << " sequence " << id;
+        }
+    }
+}
+
+TEST(IncrementalMSVTest, DirectProfileEditsNeedMarking) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = msv_test::create_constant_score_profile(10, -1.0f, abc);
+    IncrementalMSV engine(profile);
+
+    std::vector<DigitalResidue> dsq = {digitalResidueSentinel, 0, 0, 0, digitalResidueSentinel};
+    const int id = engine.add_sequence(dsq.data(), 3);
+    EXPECT_FLOAT_EQ(0.0f, engine.score(id));
+
+    profile.match_score(5, 0) = 2.5f;
+    engine.mark_column_edited(5);
+    engine.rescore();
+    EXPECT_FLOAT_EQ(2.5f, engine.score(id));
+}
+
+// ============================================================================
+// Work Accounting
+// ============================================================================
+
+TEST(IncrementalMSVTest, RescoresOnlyDiagonalsCrossingEditedColumns) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(3);
+    HMMProfile profile = msv_test::random_profile(abc, 400, msv_test::ScoreMode::TYPICAL, rng);
+    IncrementalMSV engine(profile);
+
+    const int L = 20;
+    std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.0, rng);
+    engine.add_sequence(dsq.data(), L);
+
+    // One interior column: exactly L diagonals, each crossing it in one cell
+    // and running at most L cells
+    engine.set_match_score(200, 0, 5.0f);
+    RescoreStats stats = engine.rescore();
+    EXPECT_EQ(1u, stats.sequences);
+    EXPECT_EQ(static_cast<uint64_t>(400 + L - 1), stats.diagonals_total);
+    EXPECT_EQ(static_cast<uint64_t>(L), stats.diagonals_rescored);
+    EXPECT_EQ(static_cast<uint64_t>(400 * L), stats.cells_total);
+    EXPECT_EQ(static_cast<uint64_t>(L * L), stats.cells_rescored);
+    EXPECT_LT(stats.cell_fraction(), 0.06);
+
+    // Adjacent columns share all but one diagonal
+    engine.set_match_score(100, 1, 1.0f);
+    engine.set_match_score(101, 1, 1.0f);
+    stats = engine.rescore();
+    EXPECT_EQ(static_cast<uint64_t>(L + 1), stats.diagonals_rescored);
+
+    // Nothing edited: nothing rescored
+    stats = engine.rescore();
+    EXPECT_EQ(0u, stats.diagonals_rescored);
+    EXPECT_EQ(0u, stats.cells_rescored);
+}
@@ -0,0 +1,100 @@
+/*******************************************************************************
+ * File: tests/test_length_batcher.cpp
+ * Description: Tests for length-bucketed batching and lane occupancy stats.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include "length_batcher.hpp"
+#include "test_vectors.hpp"
+
+// ============================================================================
+// Bucket Layout
+// ============================================================================
+
+TEST(LengthBatcherTest, UniformBoundsCoverMaxLength) {
+    std::vector<int> bounds = LengthBatcher::uniform_bounds(50, 200);
+    ASSERT_EQ(std::vector<int>({50, 100, 150, 200}), bounds);
+}
+
+TEST(LengthBatcherTest, GeometricBoundsGrow) {
+    std::vector<int> bounds = LengthBatcher::geometric_bounds(32, 2.0, 500);
+    ASSERT_EQ(std::vector<int>({32, 96, 224, 480, 992}), bounds);
+}
+
+TEST(LengthBatcherTest, BucketOfUsesInclusiveUpperBounds) {
+    LengthBatcher batcher(4, {10, 20});
+    EXPECT_EQ(0, batcher.bucket_of(1));
+    EXPECT_EQ(0, batcher.bucket_of(10));
+    EXPECT_EQ(1, batcher.bucket_of(11));
+    EXPECT_EQ(1, batcher.bucket_of(20));
+    EXPECT_EQ(2, batcher.bucket_of(21));  // Overflow bucket
+    EXPECT_EQ(3, batcher.num_buckets());
+}
+
+// ============================================================================
+// Batch Construction
+// ============================================================================
+
+TEST(LengthBatcherTest, EverySequenceIsBatchedExactlyOnce) {
+    std::vector<int> lengths = {5, 300, 12, 7, 150, 9, 33, 310, 2, 18};
+    LengthBatcher batcher(3, LengthBatcher::uniform_bounds(100, 400));
+    std::vector<SequenceBatch> batches = batcher.make_batches(lengths);
+
+    std::vector<int> seen;
+    for (const SequenceBatch& batch : batches) {
+        ASSERT_LE(static_cast<int>(batch.members.size()), batcher.lanes());
+        for (int idx : batch.members) {
+            EXPECT_EQ(batch.bucket, batcher.bucket_of(lengths[idx]));
+            EXPECT_LE(lengths[idx], batch.max_length);
+            seen.push_back(idx);
+        }
+    }
+    std::sort(seen.begin(), seen.end());
+    ASSERT_EQ(lengths.size(), seen.size());
+    for (int i = 0; i < static_cast<int>(seen.size()); i++) {
+        EXPECT_EQ(i, seen[i]);
+    }
+}
+
+TEST(LengthBatcherTest, DigitalSequencesUseLengthWithoutSentinels) {
+    std::vector<std::vector<DigitalResidue>> sequences = {
+        msv_test::create_digital_sequence({0, 1, 2}),
+        msv_test::create_digital_sequence({0, 1, 2, 3, 4, 5, 6, 7}),
+    };
+    LengthBatcher batcher(2, {4});
+    std::vector<SequenceBatch> batches = batcher.make_batches(sequences);
+    ASSERT_EQ(2u, batches.size());
+    EXPECT_EQ(3, batches[0].max_length);
+    EXPECT_EQ(8, batches[1].max_length);
+}
+
+// ============================================================================
+// Lane Occupancy
+// ============================================================================
+
+TEST(LengthBatcherTest, BucketingImprovesOccupancyOnMixedLengths) {
+    // Alternate short peptides with long proteins, the worst case for input order
+    std::vector<int> lengths;
+    for (int i = 0; i < 64; i++) {
+        lengths.push_back(i % 2 == 0 ? 40 + i : 900 + i);
+    }
+    LengthBatcher batcher(8, LengthBatcher::uniform_bounds(128, 1024));
+
+    BatchReport naive = batcher.measure(batcher.naive_batches(lengths), lengths);
+    BatchReport bucketed = batcher.measure(batcher.make_batches(lengths), lengths);
+
+    EXPECT_EQ(naive.total.residue_slots, bucketed.total.residue_slots);
+    EXPECT_GT(naive.total.idle_fraction(), 0.4);
+    EXPECT_LT(bucketed.total.idle_fraction(), 0.05);
+}
+
+TEST(LengthBatcherTest, PartialBatchCountsIdleLanes) {
+    std::vector<int> lengths = {10, 10, 10};
+    LengthBatcher batcher(4, {});
+    BatchReport report = batcher.measure(batcher.make_batches(lengths), lengths);
+    EXPECT_EQ(1, report.total.batches);
+    EXPECT_EQ(30, report.total.residue_slots);
+    EXPECT_EQ(40, report.total.lane_slots);
+    EXPECT_DOUBLE_EQ(0.75, report.total.occupancy());
+}
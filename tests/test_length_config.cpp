@@ -0,0 +1,115 @@
+/*******************************************************************************
+ * File: tests/test_length_config.cpp
+ * Description: Tests for cached target-length configuration of special
+ * transitions (p7_ReconfigLength / p7_GMSV length constants).
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include "length_config.hpp"
+#include "test_vectors.hpp"
+
+namespace {
+
+HMMProfile make_multihit_profile(int model_length, const AminoAcidAlphabet& abc) {
+    HMMProfile profile = msv_test::create_constant_score_profile(model_length, 1.0f, abc);
+    profile.nj = 1.0f;
+    profile.xsc[p7P_E][p7P_LOOP] = -eslCONST_LOG2;
+    profile.xsc[p7P_E][p7P_MOVE] = -eslCONST_LOG2;
+    return profile;
+}
+
+}  // namespace
+
+TEST(LengthConfigTest, CachedValuesMatchReconfigLength) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = make_multihit_profile(10, abc);
+    LengthConfigCache cache(profile, 2.0f, 1000);
+
+    for (int L : {1, 2, 100, 400, 1000}) {
+        HMMProfile reference = profile;
+        LengthConfigCache::reconfigure(reference, L);
+        SpecialTransitions st = cache.for_length(L);
+        for (int s = 0; s < p7P_NXSTATES; s++) {
+            for (int t = 0; t < p7P_NXTRANS; t++) {
+                EXPECT_FLOAT_EQ(reference.xsc[s][t], st(s, t)) << "L=" << L << " s=" << s << " t=" << t;
+            }
+        }
+        EXPECT_FLOAT_EQ(std::log(3.0f / (L + 3.0f)), st(p7P_N, p7P_MOVE));
+    }
+}
+
+TEST(LengthConfigTest, LengthsBeyondCacheAreComputedDirectly) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = make_multihit_profile(10, abc);
+    LengthConfigCache small(profile, 2.0f, 16);
+    LengthConfigCache large(profile, 2.0f, 100000);
+
+    ASSERT_EQ(16, small.max_cached_length());
+    SpecialTransitions a = small.for_length(50000);
+    SpecialTransitions b = large.for_length(50000);
+    EXPECT_FLOAT_EQ(b(p7P_C, p7P_LOOP), a(p7P_C, p7P_LOOP));
+    EXPECT_FLOAT_EQ(b(p7P_C, p7P_MOVE), a(p7P_C, p7P_MOVE));
+    EXPECT_FLOAT_EQ(large.msv_params(50000).tloop, small.msv_params(50000).tloop);
+}
+
+TEST(LengthConfigTest, UnihitProfileUsesTwoOverLPlusTwo) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = msv_test::create_constant_score_profile(5, 1.0f, abc);
+    profile.nj = 0.0f;
+    LengthConfigCache cache(profile, 1.0f, 100);
+
+    SpecialTransitions st = cache.for_length(98);
+    EXPECT_FLOAT_EQ(std::log(2.0f / 100.0f), st(p7P_J, p7P_MOVE));
+    EXPECT_FLOAT_EQ(std::log(98.0f / 100.0f), st(p7P_J, p7P_LOOP));
+}
+
+TEST(LengthConfigTest, MSVParamsMatchGMSVFormulas) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = make_multihit_profile(20, abc);
+    LengthConfigCache cache(profile, 2.0f);
+
+    MSVLengthParams p = cache.msv_params(250);
+    EXPECT_FLOAT_EQ(std::log(250.0f / 253.0f), p.tloop);
+    EXPECT_FLOAT_EQ(std::log(3.0f / 253.0f), p.tmove);
+    EXPECT_FLOAT_EQ(std::log(2.0f / (20.0f * 21.0f)), p.tbmk);
+    EXPECT_FLOAT_EQ(std::log(0.5f), p.tej);
+    EXPECT_FLOAT_EQ(std::log(0.5f), p.tec);
+}
+
+TEST(LengthConfigTest, SharedProfileIsNotMutated) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = make_multihit_profile(10, abc);
+    LengthConfigCache cache(profile, 2.0f, 64);
+
+    for (int L = 1; L <= 64; L++) {
+        (void)cache.for_length(L);
+    }
+    EXPECT_EQ(0, profile.sequence_length);
+    EXPECT_EQ(0.0f, profile.xsc[p7P_N][p7P_LOOP]);
+    EXPECT_EQ(0.0f, profile.xsc[p7P_C][p7P_MOVE]);
+}
+
+TEST(LengthConfigTest, NegativeLengthIsTreatedAsZero) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = make_multihit_profile(10, abc);
+    LengthConfigCache cache(profile, 2.0f, 64);
+
+    const SpecialTransitions negative = cache.for_length(-5);
+    const SpecialTransitions zero = cache.for_length(0);
+    EXPECT_EQ(0, negative.sequence_length);
+    EXPECT_FLOAT_EQ(zero(p7P_N, p7P_MOVE), negative(p7P_N, p7P_MOVE));
+    EXPECT_FLOAT_EQ(zero(p7P_C, p7P_LOOP), negative(p7P_C, p7P_LOOP));
+    EXPECT_FLOAT_EQ(cache.msv_params(0).tmove, cache.msv_params(-1).tmove);
+}
+
+TEST(LengthConfigTest, DefaultCacheStaysSmall) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = make_multihit_profile(10, abc);
+    LengthConfigCache cache(profile, 2.0f);
+    EXPECT_LE(cache.max_cached_length(), 4096);
+
+    // Past the cap the values are computed directly and agree with the formulas
+    const int L = cache.max_cached_length() + 500;
+    EXPECT_FLOAT_EQ(std::log(3.0f / (L + 3.0f)), cache.msv_params(L).tmove);
+}
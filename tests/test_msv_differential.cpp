@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * File: tests/test_msv_differential.cpp
+ * Description: Randomized differential tests of every MSV kernel against the
+ * scalar reference. Seeds are fixed, so a failure reproduces exactly; the
+ * failing case is printed with its seed and dimensions.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include "kernel_diff.hpp"
+#include "nt_alphabet.hpp"
+#include "test_vectors.hpp"
+
+namespace {
+
+constexpr float kThreshold = 10.0f;
+
+void expect_all_kernels_agree(const msv_test::DiffCase& c, uint32_t seed) {
+    for (const msv_test::KernelCheck& check : msv_test::run_differential(c, kThreshold)) {
+        EXPECT_TRUE(check.ok) << check.kernel << ": " << check.detail << " (" << c.describe() << ", seed "
+                              << seed << ") reference=" << check.reference << " actual=" << check.actual
+                              << " tolerance=" << check.tolerance;
+    }
+}
+
+void run_random_cases(const DigitalAlphabet& abc, msv_test::ScoreMode mode, int cases, uint32_t base_seed) {
+    for (int n = 0; n < cases; n++) {
+        const uint32_t seed = base_seed + static_cast<uint32_t>(n);
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> model(1, 80);
+        std::uniform_int_distribution<int> length(0, 200);
+        msv_test::DiffCase c = msv_test::random_case(abc, model(rng), length(rng), mode, 0.05, rng);
+        expect_all_kernels_agree(c, seed);
+    }
+}
+
+}  // namespace
+
+// ============================================================================
+// Randomized Cases
+// ============================================================================
+
+TEST(MSVDifferentialTest, AminoTypicalScores) {
+    run_random_cases(msv_test::get_test_alphabet(), msv_test::ScoreMode::TYPICAL, 200, 1000);
+}
+
+TEST(MSVDifferentialTest, AminoGridScores) {
+    run_random_cases(msv_test::get_test_alphabet(), msv_test::ScoreMode::GRID, 200, 2000);
+}
+
+TEST(MSVDifferentialTest, AminoExtremeScores) {
+    run_random_cases(msv_test::get_test_alphabet(), msv_test::ScoreMode::EXTREME, 200, 3000);
+}
+
+TEST(MSVDifferentialTest, NucleotideTypicalScores) {
+    NucleotideAlphabet dna;
+    run_random_cases(dna, msv_test::ScoreMode::TYPICAL, 200, 4000);
+}
+
+TEST(MSVDifferentialTest, NucleotideExtremeScores) {
+    NucleotideAlphabet dna;
+    run_random_cases(dna, msv_test::ScoreMode::EXTREME, 200, 5000);
+}
+
+// ============================================================================
+// Dimension Edges (as in test_msv_edge_cases.cpp)
+// ============================================================================
+
+TEST(MSVDifferentialTest, ModelAndSequenceLengthEdges) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    NucleotideAlphabet dna;
+    const int edges[] = {0, 1, 2, 3, 15, 16, 17, 31, 32, 33, 64, 255, 256};
+    uint32_t seed = 6000;
+    for (int M : edges) {
+        for (int L : edges) {
+            std::mt19937 rng(seed);
+            expect_all_kernels_agree(msv_test::random_case(abc, M, L, msv_test::ScoreMode::TYPICAL, 0.1, rng), seed);
+            expect_all_kernels_agree(msv_test::random_case(dna, M, L, msv_test::ScoreMode::GRID, 0.0, rng), seed);
+            seed++;
+        }
+    }
+}
+
+TEST(MSVDifferentialTest, AllDegenerateSequence) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(7000);
+    expect_all_kernels_agree(msv_test::random_case(abc, 20, 50, msv_test::ScoreMode::TYPICAL, 1.0, rng), 7000);
+}
+
+TEST(MSVDifferentialTest, HarnessDetectsAWrongKernel) {
+    // A check that is off by more than the tolerance must be flagged
+    msv_test::KernelCheck check = msv_test::detail::check_kernel("broken", 12.0f, 8.0f, 0.5f, eslINFINITY, kThreshold);
+    EXPECT_FALSE(check.ok);
+    check = msv_test::detail::check_kernel("saturated", 1.0f, eslINFINITY, 0.5f, 40.0f, kThreshold);
+    EXPECT_FALSE(check.ok);
+}
@@ -0,0 +1,144 @@
+/*******************************************************************************
+ * File: tests/test_msv_kernel.cpp
+ * Description: Tests for the alphabet-specialized MSV kernels.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include "msv_kernel.hpp"
+#include "nt_alphabet.hpp"
+#include "test_vectors.hpp"
+
+float compute_msv(const DigitalResidue* digital_sequence, int sequence_length,
+                  const HMMProfile& profile, DPMatrix& dp_matrix, float expected_hit_count);
+
+// ============================================================================
+// Compile-time Tables
+// ============================================================================
+
+static_assert(AminoTraits::inmap['A'] == 0, "A is the first amino acid");
+static_assert(AminoTraits::inmap['X'] == AminoTraits::Kp - 3, "X is the any-residue code");
+static_assert(AminoTraits::ndegen[AminoTraits::Kp - 3] == AminoTraits::K, "X covers all residues");
+static_assert(NucleotideTraits::ndegen[NucleotideTraits::Kp - 3] == 4, "N covers all bases");
+
+TEST(AlphabetTraitsTest, RuntimeAminoAlphabetMatchesTraits) {
+    // Reference values from the original hand-written constructor
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    EXPECT_EQ(20, abc.K);
+    EXPECT_EQ(29, abc.Kp);
+    EXPECT_EQ("ACDEFGHIKLMNPQRSTVWY-BJZOUX*~", abc.sym);
+    EXPECT_EQ(digitalResidueIllegal, abc.inmap['a']);  // Case sensitive
+    for (int x = 0; x < abc.Kp; x++) {
+        EXPECT_EQ(x, abc.inmap[static_cast<unsigned char>(abc.sym[x])]);
+        const int expected_ndegen = x < abc.K ? 1 : (x == abc.Kp - 3 ? abc.K : 0);
+        EXPECT_EQ(expected_ndegen, abc.ndegen[x]) << "symbol " << abc.sym[x];
+    }
+}
+
+TEST(AlphabetTraitsTest, RuntimeNucleotideAlphabetMatchesTraits) {
+    NucleotideAlphabet dna;
+    for (int c = 0; c < 128; c++) {
+        EXPECT_EQ(NucleotideTraits::inmap[c], dna.inmap[c]);
+    }
+    for (int x = 0; x < dna.Kp; x++) {
+        EXPECT_EQ(NucleotideTraits::ndegen[x], dna.ndegen[x]);
+    }
+}
+
+// ============================================================================
+// Kernel Equivalence
+// ============================================================================
+
+TEST(MSVKernelTest, AminoKernelMatchesReferenceOnTestVectors) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::vector<float> buffer;
+
+    auto check = [&](auto test_case) {
+        using TestCase = decltype(test_case);
+        std::vector<DigitalResidue> dsq = TestCase::get_sequence();
+        HMMProfile profile = TestCase::get_profile(abc);
+        DPMatrix dp_matrix = TestCase::get_dp_matrix();
+        AminoScoreTable table(profile);
+        float expected = compute_msv(dsq.data(), TestCase::SEQUENCE_LENGTH, profile, dp_matrix, 1.0f);
+        float actual = msv_kernel<AminoTraits>(dsq.data(), TestCase::SEQUENCE_LENGTH, table, buffer);
+        EXPECT_NEAR(expected, actual, 1e-4f) << profile.name;
+    };
+
+    check(msv_test::ConstantAllOnesTest());
+    check(msv_test::ConstantAllTwosTest());
+    check(msv_test::SinglePositionModelTest());
+    check(msv_test::SingleResidueSequenceTest());
+    check(msv_test::AlternatingPatternTest());
+    check(msv_test::AllSameResidueTest());
+    check(msv_test::AllDifferentResiduesTest());
+    check(msv_test::ShorterSequenceTest());
+    check(msv_test::LongerSequenceTest());
+    check(msv_test::MixedScoresTest());
+}
+
+TEST(MSVKernelTest, NonCanonicalResidueResetsSegments) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = msv_test::create_constant_score_profile(10, 1.0f, abc);
+    AminoScoreTable table(profile);
+    const DigitalResidue X = static_cast<DigitalResidue>(abc.inmap['X']);
+    std::vector<DigitalResidue> dsq = msv_test::create_digital_sequence({0, 1, 2, X, 3, 4});
+
+    std::vector<float> buffer;
+    EXPECT_FLOAT_EQ(3.0f, msv_kernel<AminoTraits>(dsq.data(), 6, table, buffer));
+}
+
+// ============================================================================
+// Score Type Policies
+// ============================================================================
+
+TEST(MSVKernelTest, QuantizedKernelsAreExactOnTheGrid) {
+    // Scores that are whole multiples of one uint8 unit (1/3 bit) quantize
+    // exactly for bytes; words (1/500 bit) round each score by < 1/2 unit.
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    const float unit = eslCONST_LOG2 / 3.0f;
+    HMMProfile profile = msv_test::create_alternating_pattern_profile(12, 4.0f * unit, -2.0f * unit, abc);
+    std::vector<DigitalResidue> dsq = msv_test::create_digital_sequence({0, 1, 2, 3, 7, 5, 6, 7, 8, 9, 10, 11});
+
+    std::vector<float> fbuf;
+    std::vector<int16_t> wbuf;
+    std::vector<uint8_t> bbuf;
+    float reference = msv_kernel<AminoTraits>(dsq.data(), 12, AminoScoreTable(profile), fbuf);
+    float words = msv_kernel<AminoTraits, Int16Policy>(dsq.data(), 12, AminoScoreTableT<Int16Policy>(profile), wbuf);
+    float bytes = msv_kernel<AminoTraits, Uint8Policy>(dsq.data(), 12, AminoScoreTableT<Uint8Policy>(profile), bbuf);
+
+    EXPECT_NEAR(reference, words, 12 * 0.5f / Int16Policy::default_scale());
+    EXPECT_NEAR(reference, bytes, 1e-4f);
+}
+
+TEST(MSVKernelTest, ByteKernelReportsOverflowAsInfinity) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = msv_test::create_constant_score_profile(200, 2.0f, abc);
+    std::vector<DigitalResidue> residues(200, 0);
+    std::vector<DigitalResidue> dsq = msv_test::create_digital_sequence(residues);
+
+    std::vector<uint8_t> bbuf;
+    std::vector<int16_t> wbuf;
+    EXPECT_TRUE(std::isinf(msv_kernel<AminoTraits, Uint8Policy>(dsq.data(), 200,
+                                                                AminoScoreTableT<Uint8Policy>(profile), bbuf)));
+    // 400 nats is beyond int16 range at 1/500 bit as well
+    EXPECT_TRUE(std::isinf(msv_kernel<AminoTraits, Int16Policy>(dsq.data(), 200,
+                                                                AminoScoreTableT<Int16Policy>(profile), wbuf)));
+}
+
+TEST(MSVKernelTest, WordKernelTracksFloatWithinRoundingError) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = msv_test::create_alternating_pattern_profile(20, 1.37f, -0.61f, abc);
+    std::vector<DigitalResidue> residues;
+    for (int i = 0; i < 40; i++) {
+        residues.push_back(static_cast<DigitalResidue>((i * 3) % 20));
+    }
+    std::vector<DigitalResidue> dsq = msv_test::create_digital_sequence(residues);
+
+    std::vector<float> fbuf;
+    std::vector<int16_t> wbuf;
+    AminoScoreTableT<Int16Policy> words(profile);
+    float reference = msv_kernel<AminoTraits>(dsq.data(), 40, AminoScoreTable(profile), fbuf);
+    float actual = msv_kernel<AminoTraits, Int16Policy>(dsq.data(), 40, words, wbuf);
+    // At most half a unit of rounding per model position
+    EXPECT_NEAR(reference, actual, 20 * 0.5f / words.quant.scale);
+}
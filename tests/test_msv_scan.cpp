@@ -0,0 +1,139 @@
+/*******************************************************************************
+ * File: tests/test_msv_scan.cpp
+ * Description: Tests for the blocked max-plus scan: any block layout,
+ * thread count or pool gives msv_kernel's score, overflow included.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <random>
+#include "kernel_diff.hpp"
+#include "mock_data.hpp"
+#include "msv_kernel.hpp"
+#include "msv_scan.hpp"
+#include "test_vectors.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+MSVScanConfig scan_config(int threads, int blocks) {
+    MSVScanConfig config;
+    config.num_threads = threads;
+    config.num_blocks = blocks;
+    config.min_block_rows = 1;
+    return config;
+}
+
+}  // namespace
+
+TEST(MSVScanTest, IntegerPoliciesMatchTheKernelExactly) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(83);
+    std::vector<int16_t> word_rows;
+    std::vector<uint8_t> byte_rows;
+    std::vector<MSVBlockSummary<int64_t>> blocks;
+    for (int n = 0; n < 30; n++) {
+        const int M = 1 + (n * 5);
+        const int L = 1 + (n * 37);
+        HMMProfile profile = msv_test::random_profile(abc, M, msv_test::ScoreMode::TYPICAL, rng);
+        std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.03, rng);
+        AminoScoreTableT<Int16Policy> wt(profile);
+        AminoScoreTableT<Uint8Policy> bt(profile);
+        const float word = msv_kernel<AminoTraits, Int16Policy>(dsq.data(), L, wt, word_rows);
+        const float byte = msv_kernel<AminoTraits, Uint8Policy>(dsq.data(), L, bt, byte_rows);
+        for (int nb : {1, 2, 3, 7, 16, L}) {
+            const MSVScanConfig config = scan_config(3, nb);
+            EXPECT_EQ(word, (msv_scan<AminoTraits, Int16Policy>(dsq.data(), L, wt, config, blocks)))
+                << "M=" << M << " L=" << L << " blocks=" << nb;
+            EXPECT_EQ(byte, (msv_scan<AminoTraits, Uint8Policy>(dsq.data(), L, bt, config, blocks)))
+                << "M=" << M << " L=" << L << " blocks=" << nb;
+        }
+    }
+}
+
+TEST(MSVScanTest, FloatMatchesTheKernelUpToRounding) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(89);
+    std::vector<float> rows;
+    std::vector<MSVBlockSummary<float>> blocks;
+    for (int n = 0; n < 20; n++) {
+        const int M = 10 + (n * 9);
+        const int L = 50 + (n * 101);
+        HMMProfile profile = MockDataGenerator::create_pattern_profile(M, abc);
+        AminoScoreTable table(profile);
+        std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.01, rng);
+        const float expected = msv_kernel<AminoTraits>(dsq.data(), L, table, rows);
+        for (int nb : {1, 4, 13}) {
+            EXPECT_NEAR(expected, msv_scan<AminoTraits>(dsq.data(), L, table, scan_config(4, nb), blocks),
+                        1e-4f * std::max(1.0f, expected));
+        }
+    }
+}
+
+TEST(MSVScanTest, HitSpanningManyBlocksIsCarriedAcross) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(97);
+    const int M = 300;
+    const int L = 5000;
+    HMMProfile profile = MockDataGenerator::create_pattern_profile(M, abc);
+    std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.0, rng);
+    for (int k = 1; k <= M; k++) {
+        dsq[2000 + k - 1] = static_cast<DigitalResidue>((k - 1) % abc.K);
+    }
+    AminoScoreTableT<Int16Policy> table(profile);
+    std::vector<int16_t> rows;
+    std::vector<MSVBlockSummary<int64_t>> blocks;
+    const float expected = msv_kernel<AminoTraits, Int16Policy>(dsq.data(), L, table, rows);
+
+    // 50-row blocks: the planted diagonal crosses six block boundaries
+    const float actual = msv_scan<AminoTraits, Int16Policy>(dsq.data(), L, table, scan_config(4, 100), blocks);
+    EXPECT_EQ(expected, actual);
+    EXPECT_EQ(100u, blocks.size());
+}
+
+TEST(MSVScanTest, ByteOverflowIsReportedAsInfinity) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    const int M = 200;
+    HMMProfile profile = msv_test::create_constant_score_profile(M, 3.0f, abc);
+    AminoScoreTableT<Uint8Policy> table(profile);
+    std::vector<DigitalResidue> dsq = msv_test::create_digital_sequence(std::vector<DigitalResidue>(400, 0));
+    std::vector<uint8_t> rows;
+    std::vector<MSVBlockSummary<int64_t>> blocks;
+    ASSERT_EQ(eslINFINITY, (msv_kernel<AminoTraits, Uint8Policy>(dsq.data(), 400, table, rows)));
+    EXPECT_EQ(eslINFINITY, (msv_scan<AminoTraits, Uint8Policy>(dsq.data(), 400, table, scan_config(2, 8), blocks)));
+}
+
+TEST(MSVScanTest, ShortSequencesUseOneBlock) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = MockDataGenerator::create_pattern_profile(20, abc);
+    AminoScoreTable table(profile);
+    std::mt19937 rng(101);
+    std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, 500, 0.0, rng);
+    std::vector<float> rows;
+    std::vector<MSVBlockSummary<float>> blocks;
+    MSVScanConfig config;
+    config.num_threads = 8;
+    EXPECT_EQ(msv_kernel<AminoTraits>(dsq.data(), 500, table, rows),
+              msv_scan<AminoTraits>(dsq.data(), 500, table, config, blocks));
+    EXPECT_EQ(1u, blocks.size());
+    EXPECT_EQ(0.0f, msv_scan<AminoTraits>(dsq.data(), 0, table, config, blocks));
+}
+
+TEST(MSVScanTest, BlocksRunOnASharedPool) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(103);
+    ThreadPool pool(3);
+    std::vector<int16_t> rows;
+    std::vector<MSVBlockSummary<int64_t>> blocks;
+    for (int n = 0; n < 40; n++) {
+        const int M = 5 + (n * 3);
+        const int L = 20 + (n * 29);
+        HMMProfile profile = msv_test::random_profile(abc, M, msv_test::ScoreMode::TYPICAL, rng);
+        std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.02, rng);
+        AminoScoreTableT<Int16Policy> table(profile);
+        MSVScanConfig config = scan_config(0, 1 + (n % 9));
+        config.pool = &pool;
+        EXPECT_EQ((msv_kernel<AminoTraits, Int16Policy>(dsq.data(), L, table, rows)),
+                  (msv_scan<AminoTraits, Int16Policy>(dsq.data(), L, table, config, blocks)))
+            << "M=" << M << " L=" << L;
+    }
+}
@@ -0,0 +1,167 @@
+/*******************************************************************************
+ * File: tests/test_msv_segments.cpp
+ * Description: Tests for top-N segment reporting: scores agree with
+ * msv_kernel, and segments match a per-diagonal brute force.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include "kernel_diff.hpp"
+#include "mock_data.hpp"
+#include "msv_kernel.hpp"
+#include "msv_segments.hpp"
+#include "test_vectors.hpp"
+
+namespace {
+
+// Walk each diagonal with max(0, v + s); every maximal positive run gives
+// one segment from its start to its (first) peak
+std::vector<MSVSegment> brute_force_segments(const DigitalResidue* dsq, int L, const HMMProfile& profile, int K) {
+    const int M = profile.model_length;
+    std::vector<MSVSegment> out;
+    for (int d = -(M - 1); d <= L - 1; d++) {
+        float v = 0.0f;
+        MSVSegment run = {0, 0, 0, 0, 0.0f};
+        auto close = [&]() {
+            if (run.score > 0.0f) {
+                out.push_back(run);
+            }
+            run.score = 0.0f;
+        };
+        for (int k = 1; k <= M; k++) {
+            const int i = k + d;
+            if (i < 1 || i > L) {
+                continue;
+            }
+            const DigitalResidue x = dsq[i];
+            const float nv = x < K ? std::max(0.0f, v + profile.match_score(k, x)) : 0.0f;
+            if (nv == 0.0f) {
+                close();
+            } else if (v == 0.0f) {
+                run = {i, i, k, k, nv};
+            } else if (nv > run.score) {
+                run.i_end = i;
+                run.k_end = k;
+                run.score = nv;
+            }
+            v = nv;
+        }
+        close();
+    }
+    std::sort(out.begin(), out.end(), segment_better);
+    return out;
+}
+
+float segment_sum(const DigitalResidue* dsq, const HMMProfile& profile, const MSVSegment& seg) {
+    float sum = 0.0f;
+    for (int i = seg.i_start, k = seg.k_start; i <= seg.i_end; i++, k++) {
+        sum += profile.match_score(k, dsq[i]);
+    }
+    return sum;
+}
+
+}  // namespace
+
+TEST(MSVSegmentsTest, ScoreMatchesKernelForEveryPolicy) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(53);
+    std::vector<float> float_rows;
+    std::vector<int16_t> word_rows;
+    std::vector<uint8_t> byte_rows;
+    std::vector<SegmentRun<float>> float_runs;
+    std::vector<SegmentRun<int16_t>> word_runs;
+    std::vector<SegmentRun<uint8_t>> byte_runs;
+    std::vector<MSVSegment> segments;
+    for (int n = 0; n < 40; n++) {
+        const int M = 3 + (n * 4);
+        const int L = 5 + (n * 11);
+        HMMProfile profile = MockDataGenerator::create_simple_profile(M, abc);
+        std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.05, rng);
+
+        AminoScoreTable ft(profile);
+        AminoScoreTableT<Int16Policy> wt(profile);
+        AminoScoreTableT<Uint8Policy> bt(profile);
+        EXPECT_EQ(msv_kernel<AminoTraits>(dsq.data(), L, ft, float_rows),
+                  msv_kernel_segments<AminoTraits>(dsq.data(), L, ft, float_runs, 5, segments));
+        EXPECT_EQ((msv_kernel<AminoTraits, Int16Policy>(dsq.data(), L, wt, word_rows)),
+                  (msv_kernel_segments<AminoTraits, Int16Policy>(dsq.data(), L, wt, word_runs, 5, segments)));
+        EXPECT_EQ((msv_kernel<AminoTraits, Uint8Policy>(dsq.data(), L, bt, byte_rows)),
+                  (msv_kernel_segments<AminoTraits, Uint8Policy>(dsq.data(), L, bt, byte_runs, 5, segments)));
+    }
+}
+
+TEST(MSVSegmentsTest, TopSegmentsMatchBruteForce) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(59);
+    std::vector<SegmentRun<float>> runs;
+    std::vector<MSVSegment> segments;
+    for (int n = 0; n < 30; n++) {
+        const int M = 5 + (n * 3);
+        const int L = 20 + (n * 9);
+        HMMProfile profile = MockDataGenerator::create_pattern_profile(M, abc);
+        AminoScoreTable table(profile);
+        std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.03, rng);
+
+        const float score = msv_kernel_segments<AminoTraits>(dsq.data(), L, table, runs, 8, segments);
+        const std::vector<MSVSegment> expected = brute_force_segments(dsq.data(), L, profile, abc.K);
+        ASSERT_EQ(std::min<size_t>(8, expected.size()), segments.size()) << "M=" << M << " L=" << L;
+        for (size_t j = 0; j < segments.size(); j++) {
+            EXPECT_EQ(expected[j].score, segments[j].score);
+            EXPECT_EQ(expected[j].i_start, segments[j].i_start);
+            EXPECT_EQ(expected[j].i_end, segments[j].i_end);
+            EXPECT_EQ(expected[j].k_start, segments[j].k_start);
+            EXPECT_EQ(expected[j].k_end, segments[j].k_end);
+            EXPECT_NEAR(segments[j].score, segment_sum(dsq.data(), profile, segments[j]), 1e-4f);
+        }
+        if (!segments.empty()) {
+            EXPECT_EQ(score, segments[0].score);
+        }
+    }
+}
+
+TEST(MSVSegmentsTest, FindsTwoPlantedHits) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(61);
+    const int M = 30;
+    const int L = 500;
+    HMMProfile profile = MockDataGenerator::create_pattern_profile(M, abc);
+    std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.0, rng);
+    for (int k = 1; k <= M; k++) {
+        dsq[100 + k - 1] = static_cast<DigitalResidue>((k - 1) % abc.K);  // Whole model at 100..129
+    }
+    for (int k = 11; k <= 25; k++) {
+        dsq[380 + k - 11] = static_cast<DigitalResidue>((k - 1) % abc.K);  // Nodes 11..25 at 380..394
+    }
+
+    AminoScoreTable table(profile);
+    std::vector<SegmentRun<float>> runs;
+    std::vector<MSVSegment> segments;
+    msv_kernel_segments<AminoTraits>(dsq.data(), L, table, runs, 2, segments);
+    ASSERT_EQ(2u, segments.size());
+    EXPECT_GE(segments[0].score, 60.0f);
+    EXPECT_LE(segments[0].i_start, 100);
+    EXPECT_GE(segments[0].i_end, 129);
+    EXPECT_EQ(99, segments[0].diagonal());
+    EXPECT_GE(segments[1].score, 30.0f);
+    EXPECT_EQ(369, segments[1].diagonal());
+    EXPECT_LE(segments[1].i_start, 380);
+    EXPECT_GE(segments[1].i_end, 394);
+}
+
+TEST(MSVSegmentsTest, HeapKeepsTheBestInOrder) {
+    SegmentHeap heap(3);
+    for (int n = 0; n < 20; n++) {
+        const float score = static_cast<float>((n * 7) % 20);
+        heap.offer({n, n, 1, 1, score});
+    }
+    const std::vector<MSVSegment> top = heap.sorted();
+    ASSERT_EQ(3u, top.size());
+    EXPECT_EQ(19.0f, top[0].score);
+    EXPECT_EQ(18.0f, top[1].score);
+    EXPECT_EQ(17.0f, top[2].score);
+
+    SegmentHeap none(0);
+    none.offer({1, 1, 1, 1, 5.0f});
+    EXPECT_TRUE(none.sorted().empty());
+}
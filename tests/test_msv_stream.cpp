@@ -0,0 +1,114 @@
+/*******************************************************************************
+ * File: tests/test_msv_stream.cpp
+ * Description: Tests for resumable streaming MSV. Feeding a sequence in
+ * arbitrary chunks must give exactly the msv_kernel score of every prefix.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <random>
+#include "kernel_diff.hpp"
+#include "msv_stream.hpp"
+#include "nt_alphabet.hpp"
+#include "test_vectors.hpp"
+
+namespace {
+
+// Feed `dsq` in random chunks and compare each prefix score with the kernel
+template<class Traits, class Policy>
+void expect_stream_matches_kernel(const msv_test::DiffCase& c, std::mt19937& rng) {
+    const MatchScoreTable<Traits::K, Policy> table(c.profile);
+    std::vector<typename Policy::cell_type> buffer;
+    MSVStream<Traits, Policy> stream(table);
+
+    std::uniform_int_distribution<int> chunk(1, 17);
+    int fed = 0;
+    while (fed < c.sequence_length) {
+        const int n = std::min(chunk(rng), c.sequence_length - fed);
+        stream.feed(c.digital_sequence.data() + 1 + fed, n);
+        fed += n;
+
+        // Prefix of length `fed`: the kernel only reads residues 1..fed
+        const float expected = msv_kernel<Traits, Policy>(c.digital_sequence.data(), fed, table, buffer);
+        ASSERT_EQ(expected, stream.score()) << Policy::name << " " << c.describe() << " prefix " << fed;
+        ASSERT_EQ(fed, stream.position());
+    }
+}
+
+}  // namespace
+
+// ============================================================================
+// Equivalence with the Kernel
+// ============================================================================
+
+TEST(MSVStreamTest, ChunkedFeedMatchesKernelForAllPolicies) {
+    const AminoAcidAlphabet& amino = msv_test::get_test_alphabet();
+    NucleotideAlphabet dna;
+    std::mt19937 rng(2024);
+    std::uniform_int_distribution<int> model(1, 60);
+    std::uniform_int_distribution<int> length(1, 120);
+
+    for (int n = 0; n < 20; n++) {
+        msv_test::DiffCase a = msv_test::random_case(amino, model(rng), length(rng), msv_test::ScoreMode::TYPICAL,
+                                                     0.05, rng);
+        expect_stream_matches_kernel<AminoTraits, FloatPolicy>(a, rng);
+        expect_stream_matches_kernel<AminoTraits, Int16Policy>(a, rng);
+        expect_stream_matches_kernel<AminoTraits, Uint8Policy>(a, rng);
+
+        msv_test::DiffCase d = msv_test::random_case(dna, model(rng), length(rng), msv_test::ScoreMode::TYPICAL,
+                                                     0.05, rng);
+        expect_stream_matches_kernel<NucleotideTraits, FloatPolicy>(d, rng);
+        expect_stream_matches_kernel<NucleotideTraits, Uint8Policy>(d, rng);
+    }
+}
+
+TEST(MSVStreamTest, SegmentSpanningChunkBoundaryIsKept) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = msv_test::create_constant_score_profile(5, 1.0f, abc);
+    AminoScoreTable table(profile);
+    AminoMSVStream<> stream(table);
+
+    const DigitalResidue first[] = {0, 1, 2};
+    const DigitalResidue second[] = {3, 4};
+    stream.feed(first, 3);
+    EXPECT_FLOAT_EQ(3.0f, stream.score());
+    stream.feed(second, 2);
+    EXPECT_FLOAT_EQ(5.0f, stream.score());  // One diagonal through both chunks
+}
+
+// ============================================================================
+// State Management
+// ============================================================================
+
+TEST(MSVStreamTest, ResetStartsANewSequence) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = msv_test::create_constant_score_profile(4, 2.0f, abc);
+    AminoScoreTable table(profile);
+    AminoMSVStream<> stream(table);
+
+    const DigitalResidue residues[] = {0, 0, 0, 0};
+    stream.feed(residues, 4);
+    EXPECT_FLOAT_EQ(8.0f, stream.score());
+
+    stream.reset();
+    EXPECT_EQ(0, stream.position());
+    EXPECT_FLOAT_EQ(0.0f, stream.score());
+    stream.feed(residues, 1);
+    EXPECT_FLOAT_EQ(2.0f, stream.score());  // No carry-over from the old row
+}
+
+TEST(MSVStreamTest, SaturationIsSticky) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = msv_test::create_constant_score_profile(50, 5.0f, abc);
+    AminoScoreTableT<Uint8Policy> table(profile);
+    AminoMSVStream<Uint8Policy> stream(table);
+
+    std::vector<DigitalResidue> residues(50, 0);
+    stream.feed(residues.data(), 50);
+    EXPECT_TRUE(stream.overflowed());
+    EXPECT_TRUE(std::isinf(stream.score()));
+
+    const DigitalResidue reset_residue[] = {digitalResidueSentinel};
+    stream.feed(reset_residue, 1);
+    EXPECT_TRUE(std::isinf(stream.score()));
+    EXPECT_EQ(51, stream.position());
+}
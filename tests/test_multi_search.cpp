@@ -0,0 +1,116 @@
+/*******************************************************************************
+ * File: tests/test_multi_search.cpp
+ * Description: Tests for the profile x block tiled multi-profile search:
+ * tile sizing, and one tiled pass matching per-profile Pipeline runs.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include "mock_data.hpp"
+#include "multi_search.hpp"
+
+namespace {
+
+std::vector<HMMProfile> make_library(const AminoAcidAlphabet& abc) {
+    std::vector<HMMProfile> library;
+    const int lengths[] = {40, 20, 64, 30, 40};
+    for (int p = 0; p < 5; p++) {
+        library.push_back(MockDataGenerator::create_gapped_pattern_profile(lengths[p], abc));
+        library.back().name = "model" + std::to_string(p);
+    }
+    return library;
+}
+
+}  // namespace
+
+TEST(MultiSearchTest, TileBytesCountEveryScoreTable) {
+    AminoAcidAlphabet abc;
+    const HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(100, abc);
+    const PipelineProfile tables(profile, PipelineConfig());
+    const size_t ssv_bytes = tables.ssv_table.scores.size();
+
+    // Survivors read far more than the SSV table
+    EXPECT_GT(profile_tile_bytes(tables), 10 * ssv_bytes);
+    EXPECT_GT(profile_tile_bytes(tables), profile.tsc.size() * sizeof(float) + ssv_bytes);
+}
+
+TEST(MultiSearchTest, TilesStayWithinTheBudget) {
+    AminoAcidAlphabet abc;
+    std::vector<HMMProfile> library = make_library(abc);
+    std::vector<size_t> profile_bytes;
+    for (const HMMProfile& profile : library) {
+        profile_bytes.push_back(profile_tile_bytes(PipelineProfile(profile, PipelineConfig())));
+    }
+    const std::vector<int> profiles = {0, 1, 2, 3, 4, 1};
+    const size_t budget = profile_bytes[0] + profile_bytes[1];
+
+    std::vector<std::vector<int>> tiles = make_profile_tiles(profile_bytes, profiles, budget);
+    std::vector<int> positions;
+    for (const std::vector<int>& tile : tiles) {
+        size_t bytes = 0;
+        for (int q : tile) {
+            bytes += profile_bytes[profiles[q]];
+            positions.push_back(q);
+        }
+        EXPECT_TRUE(tile.size() == 1 || bytes <= budget);
+    }
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4, 5}), positions);  // Every slot once, in order
+    EXPECT_EQ((std::vector<int>{0, 1}), tiles[0]);
+    EXPECT_EQ((std::vector<int>{2}), tiles[1]);  // Alone: larger than what is left
+
+    EXPECT_EQ(1u, make_profile_tiles(profile_bytes, profiles, size_t(1) << 30).size());
+    EXPECT_GT(l2_cache_bytes(), 0u);
+}
+
+TEST(MultiSearchTest, TiledPassMatchesOnePipelinePerProfile) {
+    AminoAcidAlphabet abc;
+    std::vector<HMMProfile> library = make_library(abc);
+    SequenceDatabase db(abc);
+    for (const std::vector<DigitalResidue>& sequence :
+         MockDataGenerator::create_mock_database(250, 40, 300, abc, 0.15, 40)) {
+        db.add("s", sequence.data(), static_cast<int>(sequence.size()) - 2);
+    }
+
+    MultiSearchConfig config;
+    config.num_threads = 2;
+    config.chunk_residues = 3000;
+    config.tile_bytes = profile_tile_bytes(PipelineProfile(library[2], config.pipeline));  // Several tiles
+    MultiProfileSearch search(db, library, config);
+    ASSERT_EQ(library.size(), search.profile_bytes().size());
+    EXPECT_EQ(config.tile_bytes, search.profile_bytes()[2]);
+    std::vector<SearchResult> results = search.search_all();
+    ASSERT_EQ(library.size(), results.size());
+
+    size_t total_hits = 0;
+    for (size_t p = 0; p < library.size(); p++) {
+        RunStats stats;
+        Pipeline reference(library[p], config.pipeline, stats);
+        std::vector<int> expected;
+        for (int s = 0; s < db.size(); s++) {
+            if (reference.run(db.sequence(s), db.length(s)).passed) {
+                expected.push_back(s);
+            }
+        }
+        std::vector<int> found;
+        for (const SearchHit& hit : results[p].hits) {
+            found.push_back(hit.sequence);
+        }
+        std::sort(found.begin(), found.end());
+        EXPECT_EQ(expected, found) << library[p].name;
+        EXPECT_EQ(static_cast<int>(library.size()), results[p].batch_profiles);
+        total_hits += found.size();
+    }
+    EXPECT_GT(total_hits, 0u);
+
+    // Every profile saw every sequence once
+    RunStats run;
+    search.collect_stats(run);
+    EXPECT_EQ(library.size() * static_cast<uint64_t>(db.size()), run.stage("msv").sequences_in);
+    RunStats reference_stats;
+    Pipeline reference(library[0], config.pipeline, reference_stats);
+    for (const char* name : {"msv", "forward"}) {
+        EXPECT_EQ(reference_stats.stage(name).threshold, run.stage(name).threshold) << name;
+        EXPECT_EQ(reference_stats.stage(name).threshold_kind, run.stage(name).threshold_kind) << name;
+    }
+    EXPECT_EQ("pvalue", run.stage("forward").threshold_kind);
+}
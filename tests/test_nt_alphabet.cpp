@@ -0,0 +1,134 @@
+/*******************************************************************************
+ * File: tests/test_nt_alphabet.cpp
+ * Description: Tests for the nucleotide alphabet, 2-bit packing and the
+ * packed nucleotide MSV kernel.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <string>
+#include "nt_alphabet.hpp"
+#include "nt_msv.hpp"
+#include "test_vectors.hpp"
+
+float compute_msv(const DigitalResidue* digital_sequence, int sequence_length,
+                  const HMMProfile& profile, DPMatrix& dp_matrix, float expected_hit_count);
+
+namespace {
+
+std::vector<DigitalResidue> digitize(const std::string& text, const DigitalAlphabet& abc) {
+    std::vector<DigitalResidue> residues;
+    for (char c : text) {
+        residues.push_back(static_cast<DigitalResidue>(abc.inmap[static_cast<unsigned char>(c)]));
+    }
+    return msv_test::create_digital_sequence(residues);
+}
+
+}  // namespace
+
+// ============================================================================
+// Alphabet
+// ============================================================================
+
+TEST(NucleotideAlphabetTest, DimensionsAndSymbols) {
+    NucleotideAlphabet dna;
+    EXPECT_EQ(4, dna.K);
+    EXPECT_EQ(18, dna.Kp);
+    EXPECT_EQ(eslDNA, dna.type);
+    EXPECT_EQ("ACGT-RYMKSWHBVDN*~", dna.sym);
+    EXPECT_EQ('N', dna.sym[dna.any_index()]);
+
+    NucleotideAlphabet rna(true);
+    EXPECT_EQ(eslRNA, rna.type);
+    EXPECT_EQ('U', rna.sym[3]);
+}
+
+TEST(NucleotideAlphabetTest, InputIsCaseInsensitiveAndTEqualsU) {
+    NucleotideAlphabet dna;
+    EXPECT_EQ(0, dna.inmap['a']);
+    EXPECT_EQ(2, dna.inmap['G']);
+    EXPECT_EQ(3, dna.inmap['t']);
+    EXPECT_EQ(3, dna.inmap['U']);
+    EXPECT_EQ(digitalResidueIllegal, dna.inmap['E']);
+}
+
+TEST(NucleotideAlphabetTest, IupacDegeneracies) {
+    NucleotideAlphabet dna;
+    const int R = dna.inmap['R'];
+    EXPECT_EQ(2, dna.ndegen[R]);
+    EXPECT_EQ(1, dna.get_degen(R, 0));  // A
+    EXPECT_EQ(0, dna.get_degen(R, 1));  // C
+    EXPECT_EQ(1, dna.get_degen(R, 2));  // G
+    EXPECT_EQ(0, dna.get_degen(R, 3));  // T
+
+    const int N = dna.inmap['n'];
+    EXPECT_EQ(4, dna.ndegen[N]);
+    EXPECT_EQ(3, dna.ndegen[dna.inmap['B']]);
+    EXPECT_EQ(0, dna.ndegen[dna.inmap['-']]);
+}
+
+TEST(NucleotideAlphabetTest, ProfileAllocatesOnlyNucleotideRows) {
+    NucleotideAlphabet dna;
+    HMMProfile profile(10, &dna);
+    EXPECT_EQ(18u, profile.rsc.size());
+}
+
+// ============================================================================
+// 2-bit Packing
+// ============================================================================
+
+TEST(PackedNucleotideTest, RoundTrip) {
+    NucleotideAlphabet dna;
+    std::string text;
+    for (int i = 0; i < 101; i++) {
+        text += "ACGT"[(i * 7 + i / 3) % 4];
+    }
+    std::vector<DigitalResidue> dsq = digitize(text, dna);
+
+    PackedNucleotideSequence packed;
+    ASSERT_TRUE(packed.pack(dsq.data(), static_cast<int>(text.size())));
+    EXPECT_EQ(101, packed.length());
+    EXPECT_EQ(4u * sizeof(uint64_t), packed.bytes());
+    EXPECT_EQ(dsq, packed.unpack());
+}
+
+TEST(PackedNucleotideTest, DegenerateSequenceIsNotPackable) {
+    NucleotideAlphabet dna;
+    std::vector<DigitalResidue> dsq = digitize("ACGNT", dna);
+    PackedNucleotideSequence packed;
+    EXPECT_FALSE(PackedNucleotideSequence::packable(dsq.data(), 5));
+    EXPECT_FALSE(packed.pack(dsq.data(), 5));
+    EXPECT_EQ(0, packed.length());
+}
+
+// ============================================================================
+// Packed MSV Kernel
+// ============================================================================
+
+TEST(PackedNucleotideTest, PackedKernelMatchesReference) {
+    NucleotideAlphabet dna;
+    const int M = 12;
+    HMMProfile profile(M, &dna);
+    profile.model_length = M;
+    for (int k = 1; k <= M; k++) {
+        for (int x = 0; x < dna.K; x++) {
+            profile.match_score(k, x) = (x == (k * 3) % 4) ? 1.5f : -0.75f - 0.1f * x;
+        }
+    }
+    NucleotideScoreRows rows(profile);
+
+    std::string text;
+    for (int i = 0; i < 70; i++) {
+        text += "ACGT"[(i * 5 + i / 4) % 4];
+    }
+    std::vector<DigitalResidue> dsq = digitize(text, dna);
+    const int L = static_cast<int>(text.size());
+
+    PackedNucleotideSequence packed;
+    ASSERT_TRUE(packed.pack(dsq.data(), L));
+
+    DPMatrix dp_matrix(M, L);
+    std::vector<float> buffer;
+    float expected = compute_msv(dsq.data(), L, profile, dp_matrix, 2.0f);
+    EXPECT_NEAR(expected, compute_msv_packed(packed, rows, buffer), 1e-4f);
+    EXPECT_GT(expected, 0.0f);
+}
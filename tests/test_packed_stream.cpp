@@ -0,0 +1,100 @@
+/*******************************************************************************
+ * File: tests/test_packed_stream.cpp
+ * Description: Tests for packed sequence streams: layout, and one packed
+ * kernel run scoring every member like msv_kernel.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <random>
+#include "kernel_diff.hpp"
+#include "mock_data.hpp"
+#include "msv_kernel.hpp"
+#include "packed_stream.hpp"
+#include "test_vectors.hpp"
+
+TEST(PackedStreamTest, MembersStayFramedDigitalSequences) {
+    PackedSequenceStream stream;
+    std::vector<DigitalResidue> a = msv_test::create_digital_sequence({1, 2, 3});
+    std::vector<DigitalResidue> empty = msv_test::create_digital_sequence({});
+    std::vector<DigitalResidue> b = msv_test::create_digital_sequence({4, 5});
+    EXPECT_EQ(0, stream.add(a.data(), 3));
+    EXPECT_EQ(1, stream.add(empty.data(), 0));
+    EXPECT_EQ(2, stream.add(b.data(), 2));
+
+    ASSERT_EQ(3, stream.size());
+    EXPECT_EQ(3, stream.length(0));
+    EXPECT_EQ(0, stream.length(1));
+    EXPECT_EQ(2, stream.length(2));
+    EXPECT_EQ(7, stream.stream_length());  // 5 residues, 2 inner sentinels
+    const DigitalResidue* s2 = stream.sequence(2);
+    EXPECT_EQ(digitalResidueSentinel, s2[0]);
+    EXPECT_EQ(4, s2[1]);
+    EXPECT_EQ(5, s2[2]);
+    EXPECT_EQ(digitalResidueSentinel, s2[3]);
+    EXPECT_EQ(digitalResidueSentinel, stream.data()[stream.stream_length() + 1]);
+
+    stream.clear();
+    EXPECT_EQ(0, stream.size());
+    EXPECT_EQ(-1, stream.stream_length());
+}
+
+TEST(PackedStreamTest, EveryMemberScoresLikeTheKernel) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(103);
+    std::uniform_int_distribution<int> len(0, 90);
+    HMMProfile profile = msv_test::random_profile(abc, 60, msv_test::ScoreMode::TYPICAL, rng);
+    AminoScoreTable ft(profile);
+    AminoScoreTableT<Int16Policy> wt(profile);
+    AminoScoreTableT<Uint8Policy> bt(profile);
+
+    PackedSequenceStream stream;
+    std::vector<std::vector<DigitalResidue>> members;
+    for (int n = 0; n < 300; n++) {
+        const int L = len(rng);
+        members.push_back(msv_test::random_sequence(abc, L, 0.05, rng));
+        stream.add(members.back().data(), L);
+    }
+
+    std::vector<float> float_rows;
+    std::vector<int16_t> word_rows;
+    std::vector<uint8_t> byte_rows;
+    std::vector<float> float_scores;
+    std::vector<float> word_scores;
+    std::vector<float> byte_scores;
+    msv_kernel_packed<AminoTraits>(stream, ft, float_rows, float_scores);
+    msv_kernel_packed<AminoTraits, Int16Policy>(stream, wt, word_rows, word_scores);
+    msv_kernel_packed<AminoTraits, Uint8Policy>(stream, bt, byte_rows, byte_scores);
+    ASSERT_EQ(members.size(), float_scores.size());
+    for (size_t s = 0; s < members.size(); s++) {
+        const int L = static_cast<int>(members[s].size()) - 2;
+        EXPECT_EQ(msv_kernel<AminoTraits>(members[s].data(), L, ft, float_rows), float_scores[s]) << "s=" << s;
+        EXPECT_EQ((msv_kernel<AminoTraits, Int16Policy>(members[s].data(), L, wt, word_rows)), word_scores[s]);
+        EXPECT_EQ((msv_kernel<AminoTraits, Uint8Policy>(members[s].data(), L, bt, byte_rows)), byte_scores[s]);
+    }
+}
+
+TEST(PackedStreamTest, OverflowingMemberDoesNotLeakIntoTheNext) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = msv_test::create_constant_score_profile(100, 3.0f, abc);
+    for (int k = 1; k <= 100; k++) {
+        profile.match_score(k, 1) = -50.0f;
+    }
+    AminoScoreTableT<Uint8Policy> table(profile);
+
+    PackedSequenceStream stream;
+    std::vector<DigitalResidue> hot = msv_test::create_digital_sequence(std::vector<DigitalResidue>(80, 0));
+    std::vector<DigitalResidue> cold = msv_test::create_digital_sequence(std::vector<DigitalResidue>(80, 1));
+    stream.add(cold.data(), 80);
+    stream.add(hot.data(), 80);
+    stream.add(cold.data(), 80);
+    stream.add(hot.data(), 80);
+
+    std::vector<uint8_t> rows;
+    std::vector<float> scores;
+    msv_kernel_packed<AminoTraits, Uint8Policy>(stream, table, rows, scores);
+    ASSERT_EQ(4u, scores.size());
+    EXPECT_EQ(0.0f, scores[0]);
+    EXPECT_EQ(eslINFINITY, scores[1]);
+    EXPECT_EQ(0.0f, scores[2]);
+    EXPECT_EQ(eslINFINITY, scores[3]);
+}
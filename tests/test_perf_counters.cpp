@@ -0,0 +1,110 @@
+/*******************************************************************************
+ * File: tests/test_perf_counters.cpp
+ * Description: Tests for the per-kernel performance registry, scoped
+ * regions and the pipeline's kernel instrumentation. Hardware counters may
+ * be unavailable here, so only calls, buckets and wall time are checked.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <random>
+#include <sstream>
+#include "kernel_diff.hpp"
+#include "mock_data.hpp"
+#include "perf_counters.hpp"
+#include "pipeline.hpp"
+#include "test_vectors.hpp"
+
+TEST(KernelPerfRegistryTest, BucketsArePowersOfTwo) {
+    EXPECT_EQ(1, KernelPerfRegistry::bucket_of(-5));
+    EXPECT_EQ(1, KernelPerfRegistry::bucket_of(1));
+    EXPECT_EQ(2, KernelPerfRegistry::bucket_of(2));
+    EXPECT_EQ(4, KernelPerfRegistry::bucket_of(3));
+    EXPECT_EQ(128, KernelPerfRegistry::bucket_of(100));
+    EXPECT_EQ(128, KernelPerfRegistry::bucket_of(128));
+    EXPECT_EQ(256, KernelPerfRegistry::bucket_of(129));
+}
+
+TEST(KernelPerfRegistryTest, RecordsAggregatePerKernelAcrossBuckets) {
+    KernelPerfRegistry registry;
+    EXPECT_TRUE(registry.empty());
+
+    PerfSample sample;
+    sample.seconds = 1e-3;
+    registry.record("msv/float", 100, 400, sample);
+    registry.record("msv/float", 100, 400, sample);
+    registry.record("msv/float", 500, 50, sample);
+    registry.record("ssv/uint8", 100, 400, sample);
+
+    EXPECT_FALSE(registry.empty());
+    EXPECT_EQ(3u, registry.calls("msv/float"));
+    EXPECT_EQ(1u, registry.calls("ssv/uint8"));
+    EXPECT_EQ(0u, registry.calls("forward/band"));
+
+    // One line per (kernel, M bucket, L bucket)
+    std::ostringstream out;
+    registry.report(out);
+    const std::string text = out.str();
+    EXPECT_NE(std::string::npos, text.find("msv/float"));
+    EXPECT_NE(std::string::npos, text.find("ssv/uint8"));
+}
+
+TEST(KernelPerfRegistryTest, ReportRestoresStreamFormatting) {
+    KernelPerfRegistry registry;
+    PerfSample sample;
+    sample.seconds = 2.5e-4;
+    registry.record("msv/float", 64, 256, sample);
+
+    std::ostringstream out;
+    out.precision(9);
+    out.setf(std::ios::scientific, std::ios::floatfield);
+    const std::ios_base::fmtflags flags = out.flags();
+    registry.report(out);
+
+    EXPECT_EQ(flags, out.flags());
+    EXPECT_EQ(9, out.precision());
+}
+
+TEST(ScopedPerfRegionTest, RecordsOnceAndIsANoOpWithoutARegistry) {
+    KernelPerfRegistry registry;
+    PerfCounterGroup counters;
+    {
+        ScopedPerfRegion region(&registry, counters, "msv/float", 10, 20);
+    }
+    EXPECT_EQ(1u, registry.calls("msv/float"));
+
+    {
+        ScopedPerfRegion region(nullptr, counters, "msv/float", 10, 20);
+        ScopedPerfRegion detached(&registry, nullptr, "msv/float", 10, 20);
+    }
+    EXPECT_EQ(1u, registry.calls("msv/float"));
+}
+
+TEST(PipelinePerfTest, MeasuresEveryKernelTheSequenceReaches) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(7);
+    const int M = 40;
+    const int L = 300;
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(M, abc);
+    PipelineConfig config;
+    config.do_ssv = true;
+    RunStats stats;
+    Pipeline pipeline(profile, config, stats);
+    KernelPerfRegistry registry;
+    pipeline.set_perf_registry(&registry);
+
+    // A planted hit reaches every stage
+    std::vector<DigitalResidue> hit = msv_test::random_sequence(abc, L, 0.0, rng);
+    for (int k = 1; k <= M; k++) {
+        hit[100 + k - 1] = static_cast<DigitalResidue>((k - 1) % abc.K);
+    }
+    ASSERT_TRUE(pipeline.run(hit.data(), L).passed);
+    for (const char* kernel : {"ssv/uint8", "msv/float", "bias", "viterbi/int16", "msv/seeds", "viterbi/trace",
+                               "forward/band"}) {
+        EXPECT_EQ(1u, registry.calls(kernel)) << kernel;
+    }
+
+    // Detached, nothing more is recorded
+    pipeline.set_perf_registry(nullptr);
+    ASSERT_TRUE(pipeline.run(hit.data(), L).passed);
+    EXPECT_EQ(1u, registry.calls("ssv/uint8"));
+}
@@ -0,0 +1,488 @@
+/*******************************************************************************
+ * File: tests/test_pipeline.cpp
+ * Description: Tests for the P-value helpers, multi-hit MSV with specials
+ * and the SSV -> MSV -> bias -> Viterbi -> Forward pipeline.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <random>
+#include "kernel_diff.hpp"
+#include "mock_data.hpp"
+#include "msv_generic.hpp"
+#include "msv_kernel.hpp"
+#include "pipeline.hpp"
+#include "pvalue.hpp"
+#include "test_vectors.hpp"
+
+namespace {
+
+std::vector<DigitalResidue> planted_sequence(const AminoAcidAlphabet& abc, int model_length, int L, int offset,
+                                             std::mt19937& rng) {
+    std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.0, rng);
+    for (int k = 1; k <= model_length; k++) {
+        dsq[offset + k - 1] = static_cast<DigitalResidue>((k - 1) % abc.K);
+    }
+    return dsq;
+}
+
+// A full copy of the pattern at `first` and its first `partial` nodes at
+// `second`: two domains on different diagonals, the second much weaker
+std::vector<DigitalResidue> two_domain_sequence(const AminoAcidAlphabet& abc, int model_length, int partial, int L,
+                                                int first, int second, std::mt19937& rng) {
+    std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.0, rng);
+    for (int k = 1; k <= model_length; k++) {
+        dsq[first + k - 1] = static_cast<DigitalResidue>((k - 1) % abc.K);
+    }
+    for (int k = 1; k <= partial; k++) {
+        dsq[second + k - 1] = static_cast<DigitalResidue>((k - 1) % abc.K);
+    }
+    return dsq;
+}
+
+}  // namespace
+
+// ============================================================================
+// P-values
+// ============================================================================
+
+TEST(PValueTest, TailsAtTheirLocation) {
+    EXPECT_NEAR(1.0 - std::exp(-1.0), gumbel_survival(-9.5, -9.5, 0.693), 1e-12);
+    EXPECT_DOUBLE_EQ(1.0, exponential_survival(-5.0, -4.5, 0.693));
+    EXPECT_DOUBLE_EQ(1.0, exponential_survival(-4.5, -4.5, 0.693));
+    EXPECT_NEAR(std::exp(-0.693 * 10.0), exponential_survival(5.5, -4.5, 0.693), 1e-12);
+}
+
+TEST(PValueTest, GumbelTailIsMonotoneAndUsesTheSmallXForm) {
+    double last = 1.0;
+    for (double x = -20.0; x <= 60.0; x += 0.5) {
+        const double p = gumbel_survival(x, -9.5, 0.693);
+        EXPECT_LE(p, last);
+        EXPECT_GT(p, 0.0);
+        last = p;
+    }
+    // Far in the tail 1 - exp(-e^-y) ~ e^-y, with no cancellation to zero
+    const double y = 0.693 * (60.0 + 9.5);
+    EXPECT_NEAR(std::exp(-y), gumbel_survival(60.0, -9.5, 0.693), std::exp(-y) * 1e-6);
+    EXPECT_EQ(0.0, gumbel_survival(eslINFINITY, -9.5, 0.693));
+}
+
+TEST(PValueTest, NullOneScore) {
+    for (int L : {1, 10, 350, 10000}) {
+        const double p1 = static_cast<double>(L) / (L + 1);
+        EXPECT_NEAR(L * std::log(p1) + std::log(1.0 - p1), null_one_score(L), 1e-4) << "L=" << L;
+    }
+    EXPECT_NEAR(2.0f, bit_score(3.0f * eslCONST_LOG2, eslCONST_LOG2), 1e-6f);
+}
+
+// ============================================================================
+// Multi-hit MSV
+// ============================================================================
+
+TEST(MSVGenericTest, SingleResidueThroughEverySpecialState) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = MockDataGenerator::create_pattern_profile(1, abc);
+    LengthConfigCache config(profile, 2.0f, 16);
+    std::vector<DigitalResidue> dsq = msv_test::create_digital_sequence({0});  // A
+    std::vector<float> row;
+
+    // N->B, B->M1 emitting A, E->C, C->T; no loops for L=1
+    const MSVLengthParams p = config.msv_params(1);
+    const float expected = p.tmove + p.tbmk + 2.0f + p.tec + p.tmove;
+    EXPECT_NEAR(expected, compute_msv_generic(dsq.data(), 1, profile, config, row), 1e-5f);
+}
+
+TEST(MSVGenericTest, AtLeastTheSSVScoreOfTheBestSegment) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(11);
+    for (int n = 0; n < 30; n++) {
+        const int M = 4 + (5 * n);
+        const int L = 10 + (13 * n);
+        HMMProfile profile = MockDataGenerator::create_pattern_profile(M, abc);
+        LengthConfigCache config(profile, 2.0f, 1024);
+        AminoScoreTable table(profile);
+        std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.03, rng);
+        std::vector<float> row;
+
+        const float segment = msv_kernel<AminoTraits>(dsq.data(), L, table, row);
+        const float ssv = ssv_sequence_score(segment, L, config.msv_params(L));
+        EXPECT_GE(compute_msv_generic(dsq.data(), L, profile, config, row), ssv - 1e-4f) << "M=" << M << " L=" << L;
+    }
+}
+
+TEST(MSVGenericTest, SecondHitAddsThroughJ) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(3);
+    const int M = 30;
+    const int L = 400;
+    HMMProfile profile = MockDataGenerator::create_pattern_profile(M, abc);
+    LengthConfigCache config(profile, 2.0f, 1024);
+    std::vector<DigitalResidue> one = planted_sequence(abc, M, L, 50, rng);
+    std::vector<DigitalResidue> two = one;
+    for (int k = 1; k <= M; k++) {
+        two[250 + k - 1] = static_cast<DigitalResidue>((k - 1) % abc.K);
+    }
+    std::vector<float> row;
+
+    // The second copy scores 2M more, less one E->J->B->Mk re-entry
+    const MSVLengthParams p = config.msv_params(L);
+    const float single = compute_msv_generic(one.data(), L, profile, p, row);
+    const float doubled = compute_msv_generic(two.data(), L, profile, p, row);
+    EXPECT_GT(doubled, single + (2.0f * M) + p.tej + p.tmove + p.tbmk - p.tec - 1.0f);
+}
+
+TEST(MSVGenericTest, NonEmittingResidueBreaksTheSegment) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = MockDataGenerator::create_pattern_profile(4, abc);
+    LengthConfigCache config(profile, 2.0f, 16);
+    std::vector<DigitalResidue> whole = msv_test::create_digital_sequence({0, 1, 2, 3});
+    std::vector<DigitalResidue> broken = msv_test::create_digital_sequence({0, 1, digitalResidueIllegal, 3});
+    std::vector<float> row;
+
+    const float a = compute_msv_generic(whole.data(), 4, profile, config, row);
+    const float b = compute_msv_generic(broken.data(), 4, profile, config, row);
+    EXPECT_GT(a, b + 4.0f);
+}
+
+// ============================================================================
+// Pipeline
+// ============================================================================
+
+TEST(PipelineTest, PlantedHitsPassAndRandomSequencesDoNot) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(19);
+    const int M = 40;
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(M, abc);
+    RunStats stats;
+    Pipeline pipeline(profile, PipelineConfig(), stats);
+
+    for (int n = 0; n < 20; n++) {
+        const int L = 100 + (30 * n);
+        std::vector<DigitalResidue> hit = planted_sequence(abc, M, L, 1 + (L / 3), rng);
+        const PipelineResult r = pipeline.run(hit.data(), L);
+        EXPECT_TRUE(r.passed) << "L=" << L;
+        EXPECT_EQ(-1, r.rejected_at);
+        EXPECT_GT(r.forward_bits, 50.0f);
+        EXPECT_LE(r.pvalue, 1e-5);
+    }
+
+    int passed = 0;
+    for (int n = 0; n < 200; n++) {
+        const int L = 50 + (n * 3);
+        std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.0, rng);
+        const PipelineResult r = pipeline.run(dsq.data(), L);
+        passed += r.passed ? 1 : 0;
+        EXPECT_EQ(r.passed, r.rejected_at < 0);
+    }
+    EXPECT_EQ(0, passed);
+}
+
+TEST(PipelineTest, StageCountersChain) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    const int M = 40;
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(M, abc);
+    std::vector<std::vector<DigitalResidue>> database =
+        MockDataGenerator::create_mock_database(300, 50, 400, abc, 0.1, M);
+
+    // Loose thresholds so every stage sees traffic
+    PipelineConfig config;
+    config.do_ssv = true;
+    config.F1 = 0.2;
+    config.F2 = 0.05;
+    config.F3 = 0.01;
+    RunStats stats;
+    Pipeline pipeline(profile, config, stats);
+    int passed = 0;
+    for (const std::vector<DigitalResidue>& dsq : database) {
+        passed += pipeline.run(dsq.data(), static_cast<int>(dsq.size()) - 2).passed ? 1 : 0;
+    }
+
+    const std::deque<StageStats>& stages = stats.stages();
+    ASSERT_EQ(5u, stages.size());
+    for (int s = 0; s < NUM_PIPELINE_STAGES; s++) {
+        EXPECT_EQ(Pipeline::STAGE_NAMES[s], stages[s].name);
+        EXPECT_EQ("pvalue", stages[s].threshold_kind);
+    }
+    EXPECT_EQ(300u, stages[0].sequences_in);
+    for (size_t s = 1; s < stages.size(); s++) {
+        EXPECT_EQ(stages[s - 1].sequences_passed, stages[s].sequences_in) << stages[s].name;
+        EXPECT_LE(stages[s].sequences_passed, stages[s].sequences_in) << stages[s].name;
+    }
+    EXPECT_EQ(static_cast<uint64_t>(passed), stages.back().sequences_passed);
+    EXPECT_GE(passed, 20);
+    EXPECT_DOUBLE_EQ(0.01, stages.back().threshold);
+}
+
+TEST(PipelineTest, BandedForwardCountsOnlyTheBandsCells) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    const int M = 40;
+    const int L = 400;
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(M, abc);
+    std::mt19937 rng(4);
+    std::vector<DigitalResidue> dsq = planted_sequence(abc, M, L, 150, rng);
+    const uint64_t full = static_cast<uint64_t>(M) * L;
+
+    RunStats banded_stats;
+    Pipeline banded(profile, PipelineConfig(), banded_stats);
+    ASSERT_TRUE(banded.run(dsq.data(), L).passed);
+    const StageStats& forward = banded_stats.stage("forward");
+    EXPECT_GT(forward.cells, 0u);
+    EXPECT_LT(forward.cells, full / 2);
+    EXPECT_EQ(full, banded_stats.stage("viterbi").cells);
+    EXPECT_EQ(static_cast<uint64_t>(L), banded_stats.stage("bias").cells);  // Per residue, not per cell
+
+    PipelineConfig config;
+    config.band_margin = -1;
+    RunStats full_stats;
+    Pipeline unbanded(profile, config, full_stats);
+    ASSERT_TRUE(unbanded.run(dsq.data(), L).passed);
+    EXPECT_EQ(full, full_stats.stage("forward").cells);
+}
+
+TEST(PipelineTest, FullForwardMatrixIsReallocatedAfterBeingReleased) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    const int M = 40;
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(M, abc);
+    std::mt19937 rng(6);
+    std::vector<std::vector<DigitalResidue>> hits;
+    for (int L : {900, 120, 600}) {
+        hits.push_back(planted_sequence(abc, M, L, L / 3, rng));
+    }
+
+    PipelineConfig keep;
+    keep.band_margin = -1;
+    PipelineConfig release = keep;
+    release.max_retained_dp_bytes = 0;  // Free the matrix after every sequence
+    RunStats keep_stats;
+    RunStats release_stats;
+    Pipeline kept(profile, keep, keep_stats);
+    Pipeline released(profile, release, release_stats);
+    for (const std::vector<DigitalResidue>& dsq : hits) {
+        const int L = static_cast<int>(dsq.size()) - 2;
+        const PipelineResult a = kept.run(dsq.data(), L);
+        const PipelineResult b = released.run(dsq.data(), L);
+        EXPECT_TRUE(b.passed) << "L=" << L;
+        EXPECT_EQ(a.forward_bits, b.forward_bits) << "L=" << L;
+    }
+}
+
+TEST(PipelineTest, WeakerSecondDomainStaysInTheBand) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    const int M = 40;
+    const int L = 400;
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(M, abc);
+    std::mt19937 rng(5);
+    // The second domain's seed scores under a third of the first's
+    std::vector<DigitalResidue> dsq = two_domain_sequence(abc, M, 13, L, 50, 300, rng);
+
+    PipelineConfig config;
+    config.seed_width = 4;
+    PipelineConfig full = config;
+    full.band_margin = -1;
+    PipelineConfig one_seed = config;
+    one_seed.seed_segments = 1;
+    RunStats stats;
+    const PipelineResult banded = Pipeline(profile, config, stats).run(dsq.data(), L);
+    const PipelineResult reference = Pipeline(profile, full, stats).run(dsq.data(), L);
+    const PipelineResult single = Pipeline(profile, one_seed, stats).run(dsq.data(), L);
+
+    ASSERT_TRUE(banded.passed);
+    EXPECT_NEAR(reference.forward_bits, banded.forward_bits, 2.0f);
+    EXPECT_GT(banded.forward_bits, single.forward_bits + 10.0f);
+}
+
+TEST(PipelineTest, SeedsThatMissThePathFallBackToAFullViterbi) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    const int M = 16;
+    const int L = 400;
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(M, abc);
+    std::mt19937 rng(5);
+    // Small enough that the striped filter does not saturate
+    std::vector<DigitalResidue> dsq = two_domain_sequence(abc, M, 8, L, 50, 300, rng);
+
+    PipelineConfig config;
+    config.F1 = config.F2 = config.F3 = 1.0;
+    config.seed_width = 4;
+    config.seed_segments = 1;
+    PipelineConfig full = config;
+    full.band_margin = -1;
+    RunStats stats;
+    const PipelineResult one_seed = Pipeline(profile, config, stats).run(dsq.data(), L);
+    const PipelineResult reference = Pipeline(profile, full, stats).run(dsq.data(), L);
+    ASSERT_TRUE(std::isfinite(one_seed.viterbi_bits));
+    EXPECT_TRUE(one_seed.full_viterbi);
+    EXPECT_NEAR(reference.forward_bits, one_seed.forward_bits, 1.0f);
+
+    // With both domains seeded the band already holds the path
+    config.seed_segments = 4;
+    const PipelineResult seeded = Pipeline(profile, config, stats).run(dsq.data(), L);
+    EXPECT_FALSE(seeded.full_viterbi);
+    EXPECT_NEAR(reference.forward_bits, seeded.forward_bits, 1.0f);
+}
+
+TEST(PipelineTest, SeedBandNearTheFullMatrixRunsAFullViterbi) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    const int M = 40;
+    const int L = 400;
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(M, abc);
+    std::mt19937 rng(5);
+    std::vector<DigitalResidue> dsq = two_domain_sequence(abc, M, 13, L, 50, 300, rng);
+
+    PipelineConfig config;
+    config.seed_width = 4;
+    PipelineConfig full = config;
+    full.band_margin = -1;
+    PipelineConfig no_band = config;
+    no_band.max_seed_band_fraction = 0.0;  // Any seed band is too wide
+    RunStats stats;
+    const PipelineResult banded = Pipeline(profile, config, stats).run(dsq.data(), L);
+    const PipelineResult reference = Pipeline(profile, full, stats).run(dsq.data(), L);
+    const PipelineResult unbanded = Pipeline(profile, no_band, stats).run(dsq.data(), L);
+
+    ASSERT_TRUE(banded.passed);
+    EXPECT_FALSE(banded.full_viterbi);
+    EXPECT_TRUE(unbanded.passed);
+    EXPECT_TRUE(unbanded.full_viterbi);
+    EXPECT_NEAR(reference.forward_bits, unbanded.forward_bits, 2.0f);
+}
+
+TEST(PipelineTest, SharedTablesAndScratchMatchSelfContainedPipelines) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(12);
+    std::vector<HMMProfile> profiles;
+    for (int M : {40, 15, 90}) {
+        profiles.push_back(MockDataGenerator::create_gapped_pattern_profile(M, abc));
+    }
+    PipelineConfig config;
+    config.F1 = 0.2;
+    config.F2 = 0.05;
+    config.F3 = 0.01;
+
+    // One scratch serves every model length, one pipeline at a time
+    PipelineScratch scratch;
+    RunStats shared_stats;
+    RunStats own_stats;
+    std::vector<std::unique_ptr<PipelineProfile>> tables;
+    std::vector<std::unique_ptr<Pipeline>> shared;
+    std::vector<std::unique_ptr<Pipeline>> own;
+    for (const HMMProfile& profile : profiles) {
+        tables.push_back(std::make_unique<PipelineProfile>(profile, config));
+        shared.push_back(std::make_unique<Pipeline>(*tables.back(), scratch, shared_stats));
+        own.push_back(std::make_unique<Pipeline>(profile, config, own_stats));
+    }
+
+    for (int n = 0; n < 30; n++) {
+        const int L = 60 + (n * 23);
+        const int M = profiles[n % 3].model_length;
+        std::vector<DigitalResidue> dsq = n % 2 == 0 ? planted_sequence(abc, M, L, L / 4, rng)
+                                                     : msv_test::random_sequence(abc, L, 0.0, rng);
+        for (size_t p = 0; p < profiles.size(); p++) {
+            const PipelineResult a = own[p]->run(dsq.data(), L);
+            const PipelineResult b = shared[p]->run(dsq.data(), L);
+            EXPECT_EQ(a.passed, b.passed) << "n=" << n << " profile " << p;
+            EXPECT_EQ(a.rejected_at, b.rejected_at);
+            EXPECT_EQ(a.forward_bits, b.forward_bits);
+            EXPECT_EQ(a.pvalue, b.pvalue);
+        }
+    }
+    for (size_t s = 0; s < own_stats.stages().size(); s++) {
+        EXPECT_EQ(own_stats.stages()[s].sequences_passed, shared_stats.stages()[s].sequences_passed);
+        EXPECT_EQ(own_stats.stages()[s].cells, shared_stats.stages()[s].cells);
+    }
+}
+
+TEST(PipelineTest, DisabledStagesAreSkipped) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(20, abc);
+    PipelineConfig config;
+    config.do_ssv = false;
+    config.do_biasfilter = false;
+    RunStats stats;
+    Pipeline pipeline(profile, config, stats);
+
+    std::mt19937 rng(2);
+    std::vector<DigitalResidue> dsq = planted_sequence(abc, 20, 120, 40, rng);
+    const PipelineResult r = pipeline.run(dsq.data(), 120);
+    EXPECT_TRUE(r.passed);
+    EXPECT_EQ(r.null_score, r.filter_score);
+
+    ASSERT_EQ(3u, stats.stages().size());
+    EXPECT_EQ("msv", stats.stages()[0].name);
+    EXPECT_EQ("viterbi", stats.stages()[1].name);
+    EXPECT_EQ("forward", stats.stages()[2].name);
+}
+
+TEST(PipelineTest, SSVIsOnByDefaultOnlyWhileCheaperThanMSV) {
+    // A prefilter earns its place only by costing less than the stage it
+    // guards; time both kernels on null sequences (best of three rounds)
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    const int M = 200;
+    const int L = 350;
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(M, abc);
+    const PipelineProfile tables(profile, PipelineConfig());
+    const MSVLengthParams params = tables.length_config.msv_params(L);
+    std::mt19937 rng(12);
+    std::vector<std::vector<DigitalResidue>> database;
+    for (int n = 0; n < 100; n++) {
+        database.push_back(msv_test::random_sequence(abc, L, 0.0, rng));
+    }
+
+    std::vector<uint8_t> ssv_buffer;
+    std::vector<float> msv_buffer;
+    double ssv_seconds = 1e30;
+    double msv_seconds = 1e30;
+    float sink = 0.0f;
+    for (int round = 0; round < 3; round++) {
+        auto start = std::chrono::steady_clock::now();
+        for (const std::vector<DigitalResidue>& dsq : database) {
+            sink += msv_kernel<AminoTraits, Uint8Policy>(dsq.data(), L, tables.ssv_table, ssv_buffer);
+        }
+        auto middle = std::chrono::steady_clock::now();
+        for (const std::vector<DigitalResidue>& dsq : database) {
+            sink += compute_msv_generic(dsq.data(), L, profile, params, msv_buffer);
+        }
+        auto end = std::chrono::steady_clock::now();
+        ssv_seconds = std::min(ssv_seconds, std::chrono::duration<double>(middle - start).count());
+        msv_seconds = std::min(msv_seconds, std::chrono::duration<double>(end - middle).count());
+    }
+    EXPECT_TRUE(std::isfinite(sink));
+    if (PipelineConfig().do_ssv) {
+        EXPECT_LT(ssv_seconds, msv_seconds) << "SSV prefilter is on by default but slower than the MSV it guards";
+    }
+}
+
+TEST(PipelineTest, BiasFilterRejectsALowComplexityRun) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    const int M = 40;
+    // Every node prefers A: a poly-A run scores like a real hit under the
+    // iid null, but the model composition explains it just as well
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(M, abc);
+    for (int k = 1; k <= M; k++) {
+        for (int x = 0; x < abc.K; x++) {
+            profile.match_score(k, x) = x == 0 ? 2.0f : -1.0f;
+        }
+    }
+    std::mt19937 rng(8);
+    const int L = 300;
+    std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.0, rng);
+    for (int i = 100; i < 100 + M; i++) {
+        dsq[i] = 0;
+    }
+
+    RunStats without_stats;
+    PipelineConfig without;
+    without.do_biasfilter = false;
+    Pipeline plain(profile, without, without_stats);
+    const PipelineResult r0 = plain.run(dsq.data(), L);
+    EXPECT_NE(STAGE_SSV, r0.rejected_at);
+    EXPECT_NE(STAGE_MSV, r0.rejected_at);
+
+    RunStats with_stats;
+    Pipeline biased(profile, PipelineConfig(), with_stats);
+    const PipelineResult r1 = biased.run(dsq.data(), L);
+    EXPECT_FALSE(r1.passed);
+    EXPECT_EQ(STAGE_BIAS, r1.rejected_at);
+    EXPECT_GT(r1.filter_score, r1.null_score + 20.0f);
+}
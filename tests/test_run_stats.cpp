@@ -0,0 +1,91 @@
+/*******************************************************************************
+ * File: tests/test_run_stats.cpp
+ * Description: Tests for stage accounting, labels and the JSON run summary.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <regex>
+#include <sstream>
+#include "run_stats.hpp"
+
+namespace {
+
+// Keys of the lines `"key": value` at one indentation level of the output
+std::vector<std::string> json_keys(const std::string& json, const std::string& indent) {
+    std::vector<std::string> keys;
+    const std::regex line("^" + indent + "\"([^\"]+)\": ");
+    std::istringstream in(json);
+    std::string text;
+    std::smatch match;
+    while (std::getline(in, text)) {
+        if (std::regex_search(text, match, line)) {
+            keys.push_back(match[1]);
+        }
+    }
+    return keys;
+}
+
+}  // namespace
+
+TEST(StageStatsTest, AddCountsFullMatrixAndAddCellsTheBand) {
+    StageStats stage;
+    stage.add(40, 100, true, 0.5);
+    stage.add_cells(600, 100, false, 0.25);
+    EXPECT_EQ(2u, stage.sequences_in);
+    EXPECT_EQ(1u, stage.sequences_passed);
+    EXPECT_EQ(200u, stage.residues);
+    EXPECT_EQ(4000u + 600u, stage.cells);
+    EXPECT_DOUBLE_EQ(4600.0 / 0.75 / 1e9, stage.gcups());
+}
+
+TEST(RunStatsTest, SetLabelReplacesAnExistingKey) {
+    RunStats stats;
+    stats.set_label("program", "msv_filter");
+    stats.set_label("mode", "search");
+    stats.set_label("program", "msv_daemon");
+
+    std::ostringstream out;
+    stats.write_json(out);
+    const std::vector<std::string> keys = json_keys(out.str(), "  ");
+    EXPECT_EQ(1, std::count(keys.begin(), keys.end(), "program"));
+    EXPECT_NE(std::string::npos, out.str().find("\"program\": \"msv_daemon\""));
+    EXPECT_EQ(std::string::npos, out.str().find("\"msv_filter\""));
+}
+
+TEST(RunStatsTest, WriteJsonEmitsTheDocumentedKeys) {
+    RunStats stats;
+    stats.set_label("program", "msv_filter");
+    stats.add_input(3, 300);
+    StageStats& ssv = stats.stage("ssv");
+    ssv.threshold = 0.02;
+    ssv.threshold_kind = "pvalue";
+    ssv.add(10, 100, true, 0.001);
+    stats.stage("forward").add_cells(50, 100, true, 0.001);
+    stats.finish();
+
+    std::ostringstream out;
+    out.precision(2);
+    stats.write_json(out);
+    const std::string json = out.str();
+    EXPECT_EQ(2, out.precision());
+
+    const std::vector<std::string> top = {"program",     "sequences", "residues", "total_cells", "wall_seconds",
+                                          "cpu_seconds", "gcups",     "peak_rss_bytes", "stages"};
+    EXPECT_EQ(top, json_keys(json, "  "));
+
+    // Threshold keys appear only for the stage that has one
+    const std::vector<std::string> stage_keys = json_keys(json, "      ");
+    const std::vector<std::string> with_threshold = {"name", "threshold", "threshold_kind", "sequences_in",
+                                                     "sequences_passed", "pass_rate", "residues", "cells",
+                                                     "seconds", "gcups"};
+    std::vector<std::string> without_threshold = with_threshold;
+    without_threshold.erase(without_threshold.begin() + 1, without_threshold.begin() + 3);
+    std::vector<std::string> expected = with_threshold;
+    expected.insert(expected.end(), without_threshold.begin(), without_threshold.end());
+    EXPECT_EQ(expected, stage_keys);
+
+    EXPECT_NE(std::string::npos, json.find("\"total_cells\": 1050,"));
+    EXPECT_NE(std::string::npos, json.find("\"threshold_kind\": \"pvalue\""));
+    EXPECT_EQ('}', json[json.size() - 2]);
+}
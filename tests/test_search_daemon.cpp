@@ -0,0 +1,275 @@
+/*******************************************************************************
+ * File: tests/test_search_daemon.cpp
+ * Description: Tests for the thread pool and the search daemon: direct,
+ * multi-profile and coalesced searches, the Unix socket protocol and
+ * connection clean-up.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "mock_data.hpp"
+#include "search_daemon.hpp"
+
+namespace {
+
+// A planted mock database plus a two-profile library
+struct DaemonFixture {
+    AminoAcidAlphabet abc;
+    SequenceDatabase db{abc};
+    std::vector<HMMProfile> profiles;
+
+    DaemonFixture() {
+        const int M = 40;
+        int s = 0;
+        for (const std::vector<DigitalResidue>& sequence :
+             MockDataGenerator::create_mock_database(300, 50, 400, abc, 0.1, M)) {
+            db.add("seq" + std::to_string(s++), sequence.data(), static_cast<int>(sequence.size()) - 2);
+        }
+        profiles.push_back(MockDataGenerator::create_gapped_pattern_profile(M, abc));
+        profiles.push_back(MockDataGenerator::create_gapped_pattern_profile(20, abc));
+        profiles.back().name = "short_model";
+    }
+};
+
+}  // namespace
+
+TEST(ThreadPoolTest, RunsEveryTaskOnceFromConcurrentCallers) {
+    ThreadPool pool(3);
+    ASSERT_EQ(3, pool.size());
+    std::vector<std::atomic<int>> counts(200);
+    auto job = [&]() {
+        pool.parallel_for(100, [&](int task, int worker) {
+            EXPECT_GE(worker, 0);
+            EXPECT_LT(worker, 3);
+            counts[task]++;
+        });
+    };
+    std::thread other(job);
+    job();
+    other.join();
+    for (int t = 0; t < 100; t++) {
+        EXPECT_EQ(2, counts[t].load()) << "task " << t;
+    }
+    pool.parallel_for(0, [](int, int) { FAIL(); });
+}
+
+TEST(SearchDaemonTest, SearchMatchesOnePipelineOverTheDatabase) {
+    DaemonFixture f;
+    SearchDaemonConfig config;
+    config.search.num_threads = 3;
+    config.search.chunk_residues = 2000;  // Many chunks, so workers interleave
+    SearchDaemon daemon(f.db, f.profiles, config);
+
+    RunStats stats;
+    Pipeline reference(f.profiles[0], config.search.pipeline, stats);
+    std::vector<int> expected;
+    for (int s = 0; s < f.db.size(); s++) {
+        if (reference.run(f.db.sequence(s), f.db.length(s)).passed) {
+            expected.push_back(s);
+        }
+    }
+    ASSERT_FALSE(expected.empty());
+
+    for (int repeat = 0; repeat < 2; repeat++) {  // Warm pipelines give the same answer
+        SearchResult result = daemon.search(0);
+        EXPECT_EQ(f.db.size(), result.sequences);
+        std::vector<int> found;
+        for (size_t h = 0; h < result.hits.size(); h++) {
+            found.push_back(result.hits[h].sequence);
+            EXPECT_DOUBLE_EQ(result.hits[h].pvalue * f.db.size(), result.hits[h].evalue);
+            if (h > 0) {
+                EXPECT_LE(result.hits[h - 1].pvalue, result.hits[h].pvalue);
+            }
+        }
+        std::sort(found.begin(), found.end());
+        EXPECT_EQ(expected, found);
+    }
+}
+
+TEST(SearchDaemonTest, OnePassOverSeveralProfilesMatchesSeparateSearches) {
+    DaemonFixture f;
+    SearchDaemonConfig config;
+    config.search.num_threads = 2;
+    config.search.chunk_residues = 5000;
+    SearchDaemon daemon(f.db, f.profiles, config);
+
+    std::vector<SearchResult> batch = daemon.search(std::vector<int>{1, 0, 1});
+    ASSERT_EQ(3u, batch.size());
+    const int order[] = {1, 0, 1};
+    for (int q = 0; q < 3; q++) {
+        SearchResult single = daemon.search(order[q]);
+        EXPECT_EQ(3, batch[q].batch_profiles);
+        ASSERT_EQ(single.hits.size(), batch[q].hits.size()) << "query " << q;
+        for (size_t h = 0; h < single.hits.size(); h++) {
+            EXPECT_EQ(single.hits[h].sequence, batch[q].hits[h].sequence);
+            EXPECT_FLOAT_EQ(single.hits[h].bits, batch[q].hits[h].bits);
+        }
+    }
+}
+
+TEST(SearchDaemonTest, CoalescesConcurrentQueriesIntoOnePass) {
+    DaemonFixture f;
+    SearchDaemonConfig config;
+    config.search.num_threads = 2;
+    config.coalesce_window_ms = 200;  // Long enough that every thread joins
+    SearchDaemon daemon(f.db, f.profiles, config);
+    const SearchResult expected[2] = {daemon.search(0), daemon.search(1)};
+
+    const int num_queries = 6;
+    std::vector<SearchResult> results(num_queries);
+    std::vector<std::thread> clients;
+    for (int q = 0; q < num_queries; q++) {
+        clients.emplace_back([&, q]() { results[q] = daemon.search_coalesced(q % 2); });
+    }
+    for (std::thread& client : clients) {
+        client.join();
+    }
+
+    int largest_batch = 0;
+    for (int q = 0; q < num_queries; q++) {
+        largest_batch = std::max(largest_batch, results[q].batch_profiles);
+        ASSERT_EQ(expected[q % 2].hits.size(), results[q].hits.size()) << "query " << q;
+        for (size_t h = 0; h < results[q].hits.size(); h++) {
+            EXPECT_EQ(expected[q % 2].hits[h].sequence, results[q].hits[h].sequence);
+        }
+    }
+    // Duplicate profiles share one slot, so a full batch has two profiles
+    EXPECT_EQ(2, largest_batch);
+}
+
+TEST(SearchDaemonTest, AFailedBatchIsAnsweredAndLaterBatchesRun) {
+    DaemonFixture f;
+    SearchDaemonConfig config;
+    config.search.num_threads = 1;
+    config.coalesce_window_ms = 200;  // Long enough that both queries share the batch
+    SearchDaemon daemon(f.db, f.profiles, config);
+
+    // An index outside the library makes the whole batch's pass throw
+    std::atomic<int> failed(0);
+    std::vector<std::thread> clients;
+    for (int profile : {0, 7}) {
+        clients.emplace_back([&, profile]() {
+            try {
+                daemon.search_coalesced(profile);
+            } catch (const std::out_of_range&) {
+                failed++;
+            }
+        });
+    }
+    for (std::thread& client : clients) {
+        client.join();
+    }
+    EXPECT_EQ(2, failed.load());
+
+    // The failure released the pool: the next batch runs
+    const SearchResult after = daemon.search_coalesced(0);
+    EXPECT_EQ(f.db.size(), after.sequences);
+}
+
+TEST(SearchDaemonTest, AnswersRequestsOverAUnixSocket) {
+    DaemonFixture f;
+    SearchDaemonConfig config;
+    config.search.num_threads = 2;
+    SearchDaemon daemon(f.db, f.profiles, config);
+    const std::string path = "/tmp/msv_daemon_test_" + std::to_string(::getpid()) + ".sock";
+    std::string error;
+    ASSERT_TRUE(daemon.listen(path, error)) << error;
+    std::thread server([&daemon]() { daemon.serve(); });
+
+    std::vector<std::string> reply;
+    ASSERT_TRUE(daemon_request(path, "PING", reply, error)) << error;
+    EXPECT_EQ(std::vector<std::string>{"OK"}, reply);
+
+    ASSERT_TRUE(daemon_request(path, "LIST", reply, error)) << error;
+    ASSERT_EQ(3u, reply.size());
+    EXPECT_EQ("PROFILE gapped_pattern_model 40", reply[0]);
+    EXPECT_EQ("PROFILE short_model 20", reply[1]);
+    EXPECT_EQ("OK 2", reply[2]);
+
+    SearchResult direct = daemon.search(0);
+    ASSERT_TRUE(daemon_request(path, "SEARCH gapped_pattern_model", reply, error)) << error;
+    ASSERT_EQ(direct.hits.size() + 1, reply.size());
+    EXPECT_EQ(0u, reply[0].find("HIT 1 " + f.db.name(direct.hits[0].sequence) + " "));
+    EXPECT_EQ(0u, reply.back().find("OK " + std::to_string(direct.hits.size()) + " 300 "));
+
+    ASSERT_TRUE(daemon_request(path, "SEARCH no_such_model", reply, error)) << error;
+    ASSERT_EQ(1u, reply.size());
+    EXPECT_EQ(0u, reply[0].find("ERR "));
+
+    ASSERT_TRUE(daemon_request(path, "SHUTDOWN", reply, error)) << error;
+    server.join();
+    EXPECT_FALSE(daemon_request(path, "PING", reply, error));
+}
+
+TEST(SearchDaemonTest, ClosedConnectionsAreReaped) {
+    DaemonFixture f;
+    SearchDaemonConfig config;
+    config.search.num_threads = 1;
+    SearchDaemon daemon(f.db, f.profiles, config);
+    const std::string path = "/tmp/msv_daemon_reap_" + std::to_string(::getpid()) + ".sock";
+    std::string error;
+    ASSERT_TRUE(daemon.listen(path, error)) << error;
+    std::thread server([&daemon]() { daemon.serve(); });
+
+    std::vector<std::string> reply;
+    for (int n = 0; n < 20; n++) {
+        ASSERT_TRUE(daemon_request(path, "PING", reply, error)) << error;
+    }
+    // Each client hung up after its reply; the handlers go within a few poll ticks
+    for (int tick = 0; tick < 50 && daemon.open_connections() > 0; tick++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    EXPECT_EQ(0u, daemon.open_connections());
+
+    daemon.stop();
+    server.join();
+}
+
+TEST(SearchDaemonTest, OverlongRequestLineIsRejected) {
+    DaemonFixture f;
+    SearchDaemonConfig config;
+    config.search.num_threads = 1;
+    SearchDaemon daemon(f.db, f.profiles, config);
+    const std::string path = "/tmp/msv_daemon_long_" + std::to_string(::getpid()) + ".sock";
+    std::string error;
+    ASSERT_TRUE(daemon.listen(path, error)) << error;
+    std::thread server([&daemon]() { daemon.serve(); });
+
+    // A client that never sends a newline
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    ASSERT_EQ(0, ::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)));
+    const std::string flood(SearchDaemon::MAX_REQUEST_LINE + 100, 'P');
+    ASSERT_EQ(static_cast<ssize_t>(flood.size()), ::send(fd, flood.data(), flood.size(), MSG_NOSIGNAL));
+
+    // ERR, then the daemon hangs up
+    std::string reply;
+    char buffer[256];
+    ssize_t n;
+    while ((n = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        reply.append(buffer, static_cast<size_t>(n));
+    }
+    ::close(fd);
+    EXPECT_EQ(0u, reply.find("ERR "));
+    EXPECT_EQ(reply.size() - 1, reply.find('\n'));
+
+    // Other clients are unaffected
+    std::vector<std::string> lines;
+    ASSERT_TRUE(daemon_request(path, "PING", lines, error)) << error;
+    EXPECT_EQ("OK", lines.back());
+
+    daemon.stop();
+    server.join();
+}
@@ -0,0 +1,121 @@
+/*******************************************************************************
+ * File: tests/test_search_io.cpp
+ * Description: Tests for the search inputs: FASTA loading into a
+ * SequenceDatabase and HMMER3 save files (read_hmm_file / write_hmm).
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <sstream>
+#include "hmm_file.hpp"
+#include "mock_data.hpp"
+#include "sequence_db.hpp"
+
+TEST(SequenceDatabaseTest, LoadsFastaRecordsAsFramedSequences) {
+    AminoAcidAlphabet abc;
+    SequenceDatabase db(abc);
+    std::istringstream fasta(">seq1 first record\nACD\nef\n>seq2\n\n>seq3\nA C\n12B*\n");
+    std::string error;
+    ASSERT_TRUE(db.load_fasta(fasta, error)) << error;
+
+    ASSERT_EQ(3, db.size());
+    EXPECT_EQ("seq1", db.name(0));
+    EXPECT_EQ("seq2", db.name(1));
+    EXPECT_EQ(5, db.length(0));
+    EXPECT_EQ(0, db.length(1));
+    EXPECT_EQ(9, db.residues());
+
+    const DigitalResidue* s1 = db.sequence(0);
+    EXPECT_EQ(digitalResidueSentinel, s1[0]);
+    EXPECT_EQ(abc.inmap['A'], s1[1]);
+    EXPECT_EQ(abc.inmap['E'], s1[4]);  // Lower case is upper-cased
+    EXPECT_EQ(digitalResidueSentinel, s1[6]);
+
+    // Residue codes the alphabet knows are kept, anything else becomes X
+    const DigitalResidue* s3 = db.sequence(2);
+    ASSERT_EQ(4, db.length(2));
+    EXPECT_EQ(abc.inmap['C'], s3[2]);
+    EXPECT_LT(s3[3], abc.Kp);
+    EXPECT_LT(s3[4], abc.Kp);
+}
+
+TEST(SequenceDatabaseTest, RejectsResiduesBeforeTheFirstHeader) {
+    AminoAcidAlphabet abc;
+    SequenceDatabase db(abc);
+    std::istringstream fasta("ACDE\n>seq1\nACDE\n");
+    std::string error;
+    EXPECT_FALSE(db.load_fasta(fasta, error));
+    EXPECT_NE(std::string::npos, error.find("line 1"));
+}
+
+TEST(SequenceDatabaseTest, ChunksCoverTheDatabaseInOrder) {
+    AminoAcidAlphabet abc;
+    SequenceDatabase db(abc);
+    for (const std::vector<DigitalResidue>& s : MockDataGenerator::create_mock_database(57, 10, 90, abc)) {
+        db.add("s", s.data(), static_cast<int>(s.size()) - 2);
+    }
+    std::vector<SequenceRange> chunks = db.chunks(500);
+    ASSERT_FALSE(chunks.empty());
+    EXPECT_EQ(0, chunks.front().first);
+    EXPECT_EQ(db.size(), chunks.back().last);
+    for (size_t c = 1; c < chunks.size(); c++) {
+        EXPECT_EQ(chunks[c - 1].last, chunks[c].first);
+    }
+}
+
+TEST(HMMFileTest, WriteThenReadRoundTripsScores) {
+    AminoAcidAlphabet abc;
+    const int M = 12;
+    HMMProfile original = MockDataGenerator::create_gapped_pattern_profile(M, abc);
+    original.evparam[p7_MMU] = -9.1f;
+    original.evparam[p7_MLAMBDA] = 0.7f;
+    original.evparam[p7_VMU] = -9.8f;
+    original.evparam[p7_VLAMBDA] = 0.7f;
+    original.evparam[p7_FTAU] = -4.2f;
+    original.evparam[p7_FLAMBDA] = 0.7f;
+
+    // Two models back to back, as in a library file
+    std::stringstream file;
+    write_hmm(file, original);
+    original.name = "second";
+    write_hmm(file, original);
+
+    std::vector<HMMProfile> profiles;
+    std::string error;
+    ASSERT_TRUE(read_hmm_file(file, abc, profiles, error)) << error;
+    ASSERT_EQ(2u, profiles.size());
+    EXPECT_EQ("gapped_pattern_model", profiles[0].name);
+    EXPECT_EQ("second", profiles[1].name);
+
+    const HMMProfile& read = profiles[0];
+    ASSERT_EQ(M, read.model_length);
+    for (int i = 0; i < p7_NEVPARAM; i++) {
+        EXPECT_NEAR(original.evparam[i], read.evparam[i], 1e-4f);
+    }
+    for (int k = 1; k <= M; k++) {
+        for (int x = 0; x < abc.K; x++) {
+            EXPECT_NEAR(original.match_score(k, x), read.match_score(k, x), 1e-4f) << "k=" << k << " x=" << x;
+        }
+    }
+    for (int k = 0; k < M; k++) {
+        for (int t = 0; t < p7P_NTRANS; t++) {
+            EXPECT_NEAR(original.trans(k, t), read.trans(k, t), 1e-4f) << "k=" << k << " t=" << t;
+        }
+    }
+    EXPECT_FLOAT_EQ(-eslCONST_LOG2, read.xsc[p7P_E][p7P_LOOP]);
+}
+
+TEST(HMMFileTest, ReportsTheLineOfATruncatedModel) {
+    AminoAcidAlphabet abc;
+    std::stringstream file;
+    write_hmm(file, MockDataGenerator::create_gapped_pattern_profile(5, abc));
+    std::string text = file.str();
+    text.resize(text.find("  3  "));  // Cut inside node 3
+
+    std::istringstream truncated(text);
+    std::vector<HMMProfile> profiles;
+    std::string error;
+    EXPECT_FALSE(read_hmm_file(truncated, abc, profiles, error));
+    EXPECT_TRUE(profiles.empty());
+    EXPECT_NE(std::string::npos, error.find("node 3")) << error;
+}
@@ -0,0 +1,131 @@
+/*******************************************************************************
+ * File: tests/test_seg_mask.cpp
+ * Description: Tests for SEG-style masking: sliding-histogram entropies
+ * against from-scratch windows, region masking and the pipeline option.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <random>
+#include "kernel_diff.hpp"
+#include "mock_data.hpp"
+#include "nt_alphabet.hpp"
+#include "pipeline.hpp"
+#include "seg_mask.hpp"
+#include "test_vectors.hpp"
+
+TEST(SegMaskTest, SlidingEntropyMatchesEveryWindow) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    SegMasker masker(abc);
+    std::mt19937 rng(37);
+    std::vector<float> entropy;
+    for (int L : {12, 13, 40, 523, 524, 600, 2000, 9001}) {
+        std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.05, rng);
+        for (int i = L / 3; i < L / 3 + 30 && i <= L; i++) {
+            dsq[i] = static_cast<DigitalResidue>(i % 3);  // Some low-entropy windows too
+        }
+        masker.window_entropy(dsq.data(), L, entropy);
+        ASSERT_EQ(static_cast<size_t>(L - 11), entropy.size());
+        for (int s = 1; s <= L - 11; s++) {
+            ASSERT_NEAR(masker.window_entropy_at(dsq.data(), s), entropy[s - 1], 1e-4) << "L=" << L << " s=" << s;
+        }
+    }
+}
+
+TEST(SegMaskTest, ShortSequencesHaveNoWindows) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    SegMasker masker(abc);
+    std::vector<DigitalResidue> dsq = msv_test::create_digital_sequence(std::vector<DigitalResidue>(11, 0));
+    std::vector<float> entropy;
+    EXPECT_EQ(0, masker.mask(dsq.data(), 11, entropy));
+    EXPECT_TRUE(entropy.empty());
+    EXPECT_EQ(0, dsq[1]);
+}
+
+TEST(SegMaskTest, MasksALowComplexityRunToX) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    SegMasker masker(abc);
+    std::mt19937 rng(41);
+    const int L = 400;
+    std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.0, rng);
+    for (int i = 150; i < 190; i++) {
+        dsq[i] = static_cast<DigitalResidue>(i % 2 == 0 ? 15 : 16);  // STSTST...
+    }
+    std::vector<DigitalResidue> original = dsq;
+    std::vector<float> entropy;
+
+    const int masked = masker.mask(dsq.data(), L, entropy);
+    EXPECT_EQ(abc.inmap['X'], masker.mask_code());
+    for (int i = 150; i < 190; i++) {
+        EXPECT_EQ(masker.mask_code(), dsq[i]) << "i=" << i;
+    }
+    EXPECT_GE(masked, 40);
+    EXPECT_LE(masked, 40 + (2 * 12));
+    EXPECT_EQ(digitalResidueSentinel, dsq[0]);
+    EXPECT_EQ(digitalResidueSentinel, dsq[L + 1]);
+
+    // Residues away from the run are untouched
+    for (int i = 1; i < 130; i++) {
+        EXPECT_EQ(original[i], dsq[i]);
+    }
+}
+
+TEST(SegMaskTest, UniformRandomSequenceIsLeftAlone) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    SegMasker masker(abc);
+    std::mt19937 rng(43);
+    std::vector<float> entropy;
+    int masked = 0;
+    int total = 0;
+    for (int n = 0; n < 20; n++) {
+        std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, 1000, 0.0, rng);
+        masked += masker.mask(dsq.data(), 1000, entropy);
+        total += 1000;
+    }
+    EXPECT_LT(masked, total / 100);
+}
+
+TEST(SegMaskTest, NucleotideAlphabetMasksToN) {
+    NucleotideAlphabet abc;
+    SegMaskConfig config;
+    config.window = 20;
+    config.trigger_bits = 1.0f;
+    config.extension_bits = 1.3f;
+    SegMasker masker(abc, config);
+    std::vector<DigitalResidue> residues(60, 0);  // poly-A
+    std::vector<DigitalResidue> dsq = msv_test::create_digital_sequence(residues);
+    std::vector<float> entropy;
+    EXPECT_EQ(60, masker.mask(dsq.data(), 60, entropy));
+    EXPECT_EQ(abc.inmap['N'], dsq[30]);
+}
+
+TEST(SegMaskTest, PipelineMasksBeforeSSV) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    const int M = 40;
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(M, abc);
+    for (int k = 1; k <= M; k++) {
+        for (int x = 0; x < abc.K; x++) {
+            profile.match_score(k, x) = x == 0 ? 2.0f : -1.0f;
+        }
+    }
+    std::mt19937 rng(47);
+    const int L = 300;
+    std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.0, rng);
+    for (int i = 100; i < 100 + M; i++) {
+        dsq[i] = 0;
+    }
+    const std::vector<DigitalResidue> original = dsq;
+
+    PipelineConfig config;
+    config.do_seg_mask = true;
+    config.do_biasfilter = false;
+    RunStats stats;
+    Pipeline pipeline(profile, config, stats);
+    const PipelineResult r = pipeline.run(dsq.data(), L);
+    EXPECT_FALSE(r.passed);
+    EXPECT_EQ(STAGE_MSV, r.rejected_at);
+    EXPECT_GE(r.masked_residues, M);
+    EXPECT_EQ(original, dsq);
+    ASSERT_FALSE(stats.stages().empty());
+    EXPECT_EQ("seg", stats.stages()[0].name);
+    EXPECT_EQ(1u, stats.stages()[0].sequences_passed);
+}
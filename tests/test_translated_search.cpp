@@ -0,0 +1,211 @@
+/*******************************************************************************
+ * File: tests/test_translated_search.cpp
+ * Description: Tests for six-frame translation and translated MSV search.
+ * The fused per-window scan is checked against translating each whole frame
+ * up front and scoring it with the reference compute_msv.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include "kernel_diff.hpp"
+#include "nt_alphabet.hpp"
+#include "translated_search.hpp"
+#include "test_vectors.hpp"
+
+namespace {
+
+std::vector<DigitalResidue> digitize_dna(const std::string& text) {
+    static const NucleotideAlphabet dna;
+    std::vector<DigitalResidue> dsq(text.size() + 2, digitalResidueSentinel);
+    for (size_t i = 0; i < text.size(); i++) {
+        dsq[i + 1] = dna.inmap[static_cast<unsigned char>(text[i])];
+    }
+    return dsq;
+}
+
+std::string amino_text(const DigitalResidue* protein, int n) {
+    std::string text;
+    for (int i = 1; i <= n; i++) {
+        text += AminoTraits::sym[protein[i]];
+    }
+    return text;
+}
+
+// Whole frame, translated by explicit reverse complement + standard codons
+std::vector<DigitalResidue> naive_frame(const std::vector<DigitalResidue>& dna, int L, int frame_index) {
+    std::vector<DigitalResidue> strand(dna.begin() + 1, dna.begin() + 1 + L);
+    if (frame_index >= 3) {
+        std::reverse(strand.begin(), strand.end());
+        for (DigitalResidue& b : strand) {
+            b = b < 4 ? static_cast<DigitalResidue>(3 - b) : b;
+        }
+    }
+    const CodonTable codons;
+    std::vector<DigitalResidue> protein(1, digitalResidueSentinel);
+    for (int p = frame_index % 3; p + 3 <= L; p += 3) {
+        protein.push_back(codons.translate(strand[p], strand[p + 1], strand[p + 2]));
+    }
+    protein.push_back(digitalResidueSentinel);
+    return protein;
+}
+
+}  // namespace
+
+// ============================================================================
+// Translation
+// ============================================================================
+
+TEST(TranslationTest, StandardCodeSpotChecks) {
+    const CodonTable codons;
+    auto translate = [&](const std::string& codon) {
+        std::vector<DigitalResidue> d = digitize_dna(codon);
+        return AminoTraits::sym[codons.translate(d[1], d[2], d[3])];
+    };
+    EXPECT_EQ('M', translate("ATG"));
+    EXPECT_EQ('W', translate("TGG"));
+    EXPECT_EQ('F', translate("TTT"));
+    EXPECT_EQ('G', translate("GGA"));
+    EXPECT_EQ('*', translate("TAA"));
+    EXPECT_EQ('*', translate("TGA"));
+    EXPECT_EQ('X', translate("ANG"));
+    EXPECT_EQ('X', translate("A-G"));
+}
+
+TEST(TranslationTest, SixFramesOfAShortSequence) {
+    const std::string text = "ATGGCCTAAGGN";  // 12 nt
+    std::vector<DigitalResidue> dna = digitize_dna(text);
+    const CodonTable codons;
+    std::vector<DigitalResidue> out(8);
+
+    // Reverse complement is NCCTTAGGCCAT
+    const char* expected[NUM_READING_FRAMES] = {
+        "MA*X",  // +1: ATG GCC TAA GGN
+        "WPK",   // +2: TGG CCT AAG
+        "GLR",   // +3: GGC CTA AGG
+        "XLGH",  // -1: NCC TTA GGC CAT
+        "P*A",   // -2: CCT TAG GCC
+        "LRP",   // -3: CTT AGG CCA
+    };
+
+    for (int f = 0; f < NUM_READING_FRAMES; f++) {
+        const int n = translate_frame(dna.data(), 12, f, 1, frame_length(12, f), codons, out.data());
+        EXPECT_EQ(expected[f], amino_text(out.data(), n)) << "frame " << frame_number(f);
+        EXPECT_EQ(digitalResidueSentinel, out[0]);
+        EXPECT_EQ(digitalResidueSentinel, out[n + 1]);
+    }
+}
+
+TEST(TranslationTest, FrameCoordinatesMapBackToNucleotides) {
+    int start = 0;
+    int end = 0;
+    frame_to_nucleotide(20, 1, 2, 3, start, end);  // +2, codons 2..3
+    EXPECT_EQ(5, start);
+    EXPECT_EQ(10, end);
+    frame_to_nucleotide(20, 3, 1, 1, start, end);  // -1, first codon
+    EXPECT_EQ(18, start);
+    EXPECT_EQ(20, end);
+    frame_to_nucleotide(20, 5, 1, 6, start, end);  // -3, all codons
+    EXPECT_EQ(1, start);
+    EXPECT_EQ(18, end);
+}
+
+// ============================================================================
+// Translated Scan
+// ============================================================================
+
+TEST(TranslatedScanTest, FusedWindowsMatchWholeFrameReference) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    NucleotideAlphabet dna_abc;
+    std::mt19937 rng(99);
+
+    TranslatedScanConfig config;
+    config.window_codons = 50;  // Many windows per frame
+    config.overlap_margin = 3;
+    TranslatedScanner scanner(config);
+
+    for (int n = 0; n < 10; n++) {
+        HMMProfile profile = msv_test::random_profile(abc, 12 + n, msv_test::ScoreMode::TYPICAL, rng);
+        AminoScoreTable table(profile);
+        const int L = 400 + (37 * n);
+        std::vector<DigitalResidue> dna = msv_test::random_sequence(dna_abc, L, 0.01, rng);
+
+        TranslatedScanResult result = scanner.scan(dna.data(), L, table);
+        float best = 0.0f;
+        for (int f = 0; f < NUM_READING_FRAMES; f++) {
+            std::vector<DigitalResidue> protein = naive_frame(dna, L, f);
+            const int n_codons = static_cast<int>(protein.size()) - 2;
+            DPMatrix dp_matrix(profile.model_length, n_codons);
+            const float expected = compute_msv(protein.data(), n_codons, profile, dp_matrix, 1.0f);
+            EXPECT_NEAR(expected, result.frame_scores[f], 1e-4f) << "case " << n << " frame " << frame_number(f);
+            best = std::max(best, expected);
+        }
+        EXPECT_NEAR(best, result.best_score, 1e-4f);
+    }
+}
+
+TEST(TranslatedScanTest, PlantedReverseStrandHitIsReportedOnForwardCoordinates) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = msv_test::create_constant_score_profile(8, -1.0f, abc);
+    // Reward M (ATG) at every model position
+    for (int k = 1; k <= 8; k++) {
+        profile.match_score(k, AminoTraits::inmap['M']) = 2.0f;
+    }
+    AminoScoreTable table(profile);
+
+    // Eight ATG codons on the minus strand = CAT x 8 on the forward strand,
+    // placed at nucleotides 301..324 of a poly-C background
+    std::string text(600, 'C');
+    for (int c = 0; c < 8; c++) {
+        text.replace(300 + (3 * c), 3, "CAT");
+    }
+    std::vector<DigitalResidue> dna = digitize_dna(text);
+
+    TranslatedScanConfig config;
+    config.window_codons = 40;
+    config.overlap_margin = 2;
+    config.report_threshold = 15.0f;  // Only the full diagonal (shifted ones score 14 or less)
+    TranslatedScanResult result = TranslatedScanner(config).scan(dna.data(), 600, table);
+
+    EXPECT_FLOAT_EQ(16.0f, result.best_score);
+    EXPECT_EQ(-1, result.best_frame);  // 600 - 324 = 276 is a multiple of 3
+    ASSERT_EQ(1u, result.hits.size());
+    EXPECT_EQ(-1, result.hits[0].frame);
+    EXPECT_EQ(301, result.hits[0].start);
+    EXPECT_EQ(324, result.hits[0].end);
+    EXPECT_EQ(1, result.hits[0].k_start);
+    EXPECT_EQ(8, result.hits[0].k_end);
+    EXPECT_FLOAT_EQ(16.0f, result.hits[0].score);
+}
+
+TEST(TranslatedScanTest, HitsAreSegmentsNotWindows) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = msv_test::create_constant_score_profile(8, -1.0f, abc);
+    for (int k = 1; k <= 8; k++) {
+        profile.match_score(k, AminoTraits::inmap['M']) = 2.0f;
+    }
+    AminoScoreTable table(profile);
+
+    // Two runs of eight ATG codons in frame +1, 3000 nucleotides apart, in
+    // one 2000-codon window
+    std::string text(6000, 'C');
+    for (int c = 0; c < 8; c++) {
+        text.replace(300 + (3 * c), 3, "ATG");
+        text.replace(3300 + (3 * c), 3, "ATG");
+    }
+    std::vector<DigitalResidue> dna = digitize_dna(text);
+
+    TranslatedScanConfig config;
+    config.window_codons = 2000;
+    config.report_threshold = 15.0f;
+    TranslatedScanResult result = TranslatedScanner(config).scan(dna.data(), 6000, table);
+
+    ASSERT_EQ(2u, result.hits.size());
+    for (const TranslatedHit& hit : result.hits) {
+        EXPECT_EQ(1, hit.frame);
+        EXPECT_EQ(24, hit.end - hit.start + 1);  // The segment, not its window
+        EXPECT_FLOAT_EQ(16.0f, hit.score);
+    }
+    EXPECT_EQ(301, result.hits[0].start);
+    EXPECT_EQ(3301, result.hits[1].start);
+}
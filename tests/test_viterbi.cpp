@@ -0,0 +1,308 @@
+/*******************************************************************************
+ * File: tests/test_viterbi.cpp
+ * Description: Tests for the generic Viterbi stage and the striped 16-bit
+ * Viterbi filter. On profiles whose scores lie on the word grid the filter
+ * must reproduce the scalar reference up to float summation error. The
+ * checkpointed matrix must give the full matrix's score and traceback.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include "kernel_diff.hpp"
+#include "mock_data.hpp"
+#include "test_vectors.hpp"
+#include "viterbi.hpp"
+#include "viterbi_filter.hpp"
+
+namespace {
+
+// Round a score to whole word units so the filter sees it exactly
+float snap(float score) {
+    const float scale = ViterbiWordProfile::default_scale();
+    return std::isfinite(score) ? std::round(score * scale) / scale : score;
+}
+
+// Random gapped profile with every score on the word grid
+HMMProfile random_gapped_profile(const AminoAcidAlphabet& abc, int model_length, std::mt19937& rng) {
+    HMMProfile profile = msv_test::random_profile(abc, model_length, msv_test::ScoreMode::TYPICAL, rng);
+    std::uniform_real_distribution<float> u(0.05f, 1.0f);
+    std::uniform_real_distribution<float> isc(-1.0f, 1.0f);
+
+    for (int k = 0; k < model_length; k++) {
+        const float mm = u(rng);
+        const float mi = u(rng) * 0.3f;
+        const float md = u(rng) * 0.3f;
+        const float im = u(rng);
+        const float ii = u(rng);
+        const float dm = u(rng);
+        const float dd = u(rng);
+        profile.trans(k, p7P_MM) = snap(std::log(mm / (mm + mi + md)));
+        profile.trans(k, p7P_MI) = snap(std::log(mi / (mm + mi + md)));
+        profile.trans(k, p7P_MD) = snap(std::log(md / (mm + mi + md)));
+        profile.trans(k, p7P_IM) = snap(std::log(im / (im + ii)));
+        profile.trans(k, p7P_II) = snap(std::log(ii / (im + ii)));
+        profile.trans(k, p7P_DM) = snap(std::log(dm / (dm + dd)));
+        profile.trans(k, p7P_DD) = snap(std::log(dd / (dm + dd)));
+    }
+    for (int k = 1; k <= model_length; k++) {
+        for (int x = 0; x < abc.K; x++) {
+            profile.match_score(k, x) = snap(profile.match_score(k, x));
+            if (k < model_length) {
+                profile.insert_score(k, x) = snap(isc(rng));
+            }
+        }
+    }
+    profile.nj = 1.0f;
+    profile.xsc[p7P_E][p7P_LOOP] = -eslCONST_LOG2;
+    profile.xsc[p7P_E][p7P_MOVE] = -eslCONST_LOG2;
+    return profile;
+}
+
+SpecialTransitions snapped_specials(const LengthConfigCache& config, int L) {
+    SpecialTransitions st = config.for_length(L);
+    for (int s = 0; s < p7P_NXSTATES; s++) {
+        for (int t = 0; t < p7P_NXTRANS; t++) {
+            st.xsc[s][t] = snap(st.xsc[s][t]);
+        }
+    }
+    return st;
+}
+
+void expect_filter_matches_reference(const HMMProfile& profile, const std::vector<DigitalResidue>& dsq, int L,
+                                     const std::string& what) {
+    LengthConfigCache config(profile, 2.0f, 1024);
+    const SpecialTransitions st = snapped_specials(config, L);
+    const float tbmk = snap(config.msv_params(L).tbmk);
+
+    DPMatrix dp_matrix(profile.model_length, L);
+    const float expected = compute_viterbi(dsq.data(), L, profile, st, tbmk, dp_matrix);
+
+    ViterbiWordProfile om(profile, tbmk);
+    std::vector<WordVector> buffer;
+    const float actual = viterbi_filter(dsq.data(), L, om, st, buffer);
+
+    // Word range tops out near (32767 - BASE) / scale = 28.8 nats; E and the
+    // specials sit a few nats above the final C->T score
+    const float range_limit =
+        static_cast<float>(ViterbiWordProfile::POS_MAX - ViterbiWordProfile::BASE) / om.scale;
+    if (std::isinf(expected)) {
+        EXPECT_EQ(expected, actual) << what;
+    } else if (actual == eslINFINITY) {
+        EXPECT_GT(expected, range_limit - 3.0f) << what << ": saturated below the word range";
+    } else {
+        EXPECT_NEAR(expected, actual, 1e-3f) << what;
+    }
+}
+
+}  // namespace
+
+// ============================================================================
+// Generic Viterbi
+// ============================================================================
+
+TEST(ViterbiTest, SingleMatchPath) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(1, abc);
+    LengthConfigCache config(profile, 2.0f, 16);
+    std::vector<DigitalResidue> dsq = msv_test::create_digital_sequence({0});
+
+    DPMatrix dp_matrix(1, 1);
+    const float score = compute_viterbi(dsq.data(), 1, profile, config, dp_matrix);
+
+    // N->B, B->M1 (tbmk = log 1 for M=1), emit A (+2), E->C, C->T
+    const SpecialTransitions st = config.for_length(1);
+    const float expected = st(p7P_N, p7P_MOVE) + 0.0f + 2.0f + st(p7P_E, p7P_MOVE) + st(p7P_C, p7P_MOVE);
+    EXPECT_NEAR(expected, score, 1e-5f);
+}
+
+TEST(ViterbiTest, InsertStateBridgesAMismatch) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = msv_test::create_constant_score_profile(2, -10.0f, abc);
+    profile.match_score(1, 0) = 5.0f;  // A at both nodes
+    profile.match_score(2, 0) = 5.0f;
+    for (int x = 0; x < abc.K; x++) {
+        profile.insert_score(1, x) = 0.0f;
+    }
+    for (int k = 0; k < 2; k++) {
+        profile.trans(k, p7P_MM) = std::log(0.8f);
+        profile.trans(k, p7P_MI) = -1.0f;
+        profile.trans(k, p7P_MD) = std::log(0.1f);
+        profile.trans(k, p7P_IM) = -1.0f;
+        profile.trans(k, p7P_II) = std::log(0.5f);
+        profile.trans(k, p7P_DM) = std::log(0.5f);
+        profile.trans(k, p7P_DD) = std::log(0.5f);
+    }
+    profile.xsc[p7P_E][p7P_LOOP] = -eslINFINITY;  // Unihit
+    profile.xsc[p7P_E][p7P_MOVE] = 0.0f;
+
+    LengthConfigCache config(profile, 1.0f, 16);
+    std::vector<DigitalResidue> dsq = msv_test::create_digital_sequence({0, 1, 0});  // A C A
+    DPMatrix dp_matrix(2, 3);
+    const float score = compute_viterbi(dsq.data(), 3, profile, config, dp_matrix);
+
+    // N->B, B->M1(A), M1->I1(C), I1->M2(A), E->C, C->T
+    const SpecialTransitions st = config.for_length(3);
+    const float tbmk = std::log(2.0f / 6.0f);
+    const float expected = st(p7P_N, p7P_MOVE) + tbmk + 5.0f - 1.0f + 0.0f - 1.0f + 5.0f + 0.0f +
+                           st(p7P_C, p7P_MOVE);
+    EXPECT_NEAR(expected, score, 1e-5f);
+    EXPECT_NEAR(st(p7P_N, p7P_MOVE) + tbmk + 8.0f, dp_matrix.match(3, 2), 1e-5f);
+}
+
+TEST(ViterbiTest, NoEmittablePathIsNegativeInfinity) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(5, abc);
+    LengthConfigCache config(profile, 2.0f, 16);
+    std::vector<DigitalResidue> dsq = msv_test::create_digital_sequence({0, 1});
+
+    DPMatrix dp_matrix(5, 2);
+    EXPECT_EQ(-eslINFINITY, compute_viterbi(dsq.data(), 0, profile, config, dp_matrix));
+}
+
+// ============================================================================
+// Striped Filter vs. Reference
+// ============================================================================
+
+TEST(ViterbiFilterTest, StripedLayoutPlacesNodesInLanes) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(20, abc);
+    ViterbiWordProfile om(profile, 0.0f);
+    EXPECT_EQ(3, om.Q);
+    EXPECT_EQ(0, om.vector_of(1));
+    EXPECT_EQ(0, om.lane_of(1));
+    EXPECT_EQ(0, om.vector_of(4));
+    EXPECT_EQ(1, om.lane_of(4));
+    EXPECT_EQ(1, om.vector_of(20));
+    EXPECT_EQ(6, om.lane_of(20));
+    EXPECT_EQ(om.wordify(2.0f), om.match[(0 * om.Q) + om.vector_of(1)][om.lane_of(1)]);
+    EXPECT_EQ(ViterbiWordProfile::NEG_INF, om.match[(0 * om.Q) + 2][7]);  // Padding node 24
+}
+
+TEST(ViterbiFilterTest, MatchesReferenceOnRandomGriddedProfiles) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    for (uint32_t seed = 1; seed <= 60; seed++) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> model(1, 70);
+        std::uniform_int_distribution<int> length(0, 150);
+        const int M = model(rng);
+        const int L = length(rng);
+        HMMProfile profile = random_gapped_profile(abc, M, rng);
+        std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.03, rng);
+        expect_filter_matches_reference(profile, dsq, L,
+                                        "seed " + std::to_string(seed) + " M=" + std::to_string(M) +
+                                            " L=" + std::to_string(L));
+    }
+}
+
+TEST(ViterbiFilterTest, LongDeletionCrossesLanes) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    const int M = 40;
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(M, abc);
+    for (int k = 0; k < M; k++) {
+        profile.trans(k, p7P_MD) = snap(std::log(0.05f));
+        profile.trans(k, p7P_DD) = snap(std::log(0.9f));
+        profile.trans(k, p7P_DM) = snap(std::log(0.1f));
+    }
+    for (int k = 1; k <= M; k++) {
+        for (int x = 0; x < abc.K; x++) {
+            profile.match_score(k, x) = snap(profile.match_score(k, x));
+        }
+    }
+
+    // Residues preferred by nodes 1..5 and 31..40: the best path deletes
+    // nodes 6..30, a chain that spans several lanes of the striped layout
+    std::vector<DigitalResidue> residues;
+    for (int k = 1; k <= 5; k++) {
+        residues.push_back(static_cast<DigitalResidue>((k - 1) % abc.K));
+    }
+    for (int k = 31; k <= 40; k++) {
+        residues.push_back(static_cast<DigitalResidue>((k - 1) % abc.K));
+    }
+    std::vector<DigitalResidue> dsq = msv_test::create_digital_sequence(residues);
+    expect_filter_matches_reference(profile, dsq, static_cast<int>(residues.size()), "long deletion");
+}
+
+TEST(ViterbiFilterTest, SaturationReportsInfinity) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(30, abc);
+    for (int k = 1; k <= 30; k++) {
+        profile.match_score(k, 0) = 10.0f;  // 30 x 10 nats is far beyond the word range
+    }
+    LengthConfigCache config(profile, 2.0f, 64);
+    std::vector<DigitalResidue> dsq = msv_test::create_digital_sequence(std::vector<DigitalResidue>(30, 0));
+
+    ViterbiWordProfile om(profile, config.msv_params(30).tbmk);
+    std::vector<WordVector> buffer;
+    EXPECT_EQ(eslINFINITY, viterbi_filter(dsq.data(), 30, om, config.for_length(30), buffer));
+}
+
+// ============================================================================
+// Checkpointed Viterbi
+// ============================================================================
+
+TEST(CheckpointedViterbiTest, BlockRowsAreAPowerOfTwoNearSqrtL) {
+    CheckpointedDPMatrix a(10, 35000);
+    EXPECT_EQ(128, a.block_rows());
+    CheckpointedDPMatrix b(10, 99);
+    EXPECT_EQ(8, b.block_rows());
+    CheckpointedDPMatrix c(10, 1000, 5);
+    EXPECT_EQ(8, c.block_rows());
+    EXPECT_TRUE(c.is_checkpoint(16));
+    EXPECT_FALSE(c.is_checkpoint(17));
+    EXPECT_EQ(2, c.block_of(23));
+}
+
+TEST(CheckpointedViterbiTest, ScoreAndTraceMatchTheFullMatrix) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(73);
+    for (int n = 0; n < 24; n++) {
+        const int M = 4 + (3 * n);
+        const int L = 1 + (17 * n);
+        HMMProfile profile = random_gapped_profile(abc, M, rng);
+        LengthConfigCache config(profile, 2.0f, 1024);
+        std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.02, rng);
+        const SpecialTransitions st = config.for_length(L);
+        const float tbmk = config.msv_params(L).tbmk;
+
+        DPMatrix full(M, L);
+        const float expected = compute_viterbi(dsq.data(), L, profile, st, tbmk, full);
+        const std::vector<TraceCell> want = viterbi_traceback(L, profile, st, tbmk, full);
+        for (int block_rows : {0, 1, 2, 7, 64}) {
+            CheckpointedDPMatrix chk(block_rows);
+            EXPECT_EQ(expected, compute_viterbi_checkpointed(dsq.data(), L, profile, st, tbmk, chk));
+            const std::vector<TraceCell> got = viterbi_traceback(dsq.data(), L, profile, st, tbmk, chk);
+            ASSERT_EQ(want.size(), got.size()) << "M=" << M << " L=" << L << " B=" << chk.block_rows();
+            for (size_t c = 0; c < want.size(); c++) {
+                EXPECT_EQ(want[c].i, got[c].i);
+                EXPECT_EQ(want[c].k, got[c].k);
+                EXPECT_EQ(want[c].state, got[c].state);
+            }
+        }
+    }
+}
+
+TEST(CheckpointedViterbiTest, LongSequenceUsesSqrtMemory) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    std::mt19937 rng(79);
+    const int M = 60;
+    const int L = 20000;
+    HMMProfile profile = MockDataGenerator::create_gapped_pattern_profile(M, abc);
+    LengthConfigCache config(profile, 2.0f, 32768);
+    std::vector<DigitalResidue> dsq = msv_test::random_sequence(abc, L, 0.0, rng);
+    for (int k = 1; k <= M; k++) {
+        dsq[15000 + k - 1] = static_cast<DigitalResidue>((k - 1) % abc.K);
+    }
+    const SpecialTransitions st = config.for_length(L);
+    const float tbmk = config.msv_params(L).tbmk;
+
+    CheckpointedDPMatrix chk;
+    compute_viterbi_checkpointed(dsq.data(), L, profile, st, tbmk, chk);
+    EXPECT_LT(chk.cells(), static_cast<uint64_t>(M + 1) * (L + 1) / 50);
+
+    const std::vector<TraceCell> trace = viterbi_traceback(dsq.data(), L, profile, st, tbmk, chk);
+    ASSERT_EQ(static_cast<size_t>(M), trace.size());
+    EXPECT_EQ(15000, trace.front().i);
+    EXPECT_EQ(1, trace.front().k);
+    EXPECT_EQ(15000 + M - 1, trace.back().i);
+}
@@ -0,0 +1,138 @@
+/*******************************************************************************
+ * File: tests/test_windowed_scan.cpp
+ * Description: Tests for windowed scanning of long sequences.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include "windowed_scan.hpp"
+#include "test_vectors.hpp"
+
+namespace {
+
+// Background of residue 0 (scored -1 everywhere) with copies of the model's
+// preferred residues planted at the given 1-indexed offsets
+std::vector<DigitalResidue> make_planted_sequence(int length, int model_length, const std::vector<int>& offsets) {
+    std::vector<DigitalResidue> residues(length, 0);
+    for (int offset : offsets) {
+        for (int k = 1; k <= model_length && offset + k - 2 < length; k++) {
+            residues[offset + k - 2] = static_cast<DigitalResidue>(k % 20);
+        }
+    }
+    return msv_test::create_digital_sequence(residues);
+}
+
+HMMProfile make_motif_profile(int model_length, const AminoAcidAlphabet& abc) {
+    HMMProfile profile = msv_test::create_constant_score_profile(model_length, -1.0f, abc);
+    for (int k = 1; k <= model_length; k++) {
+        profile.match_score(k, k % 20) = 2.0f;
+    }
+    return profile;
+}
+
+}  // namespace
+
+TEST(WindowedScanTest, LayoutCoversSequenceWithRequestedOverlap) {
+    std::vector<ScanWindow> windows = WindowedScanner::layout(1000, 300, 50);
+    ASSERT_FALSE(windows.empty());
+    EXPECT_EQ(1, windows.front().start);
+    EXPECT_EQ(1000, windows.back().end);
+    for (size_t w = 1; w < windows.size(); w++) {
+        EXPECT_EQ(50, windows[w - 1].end - windows[w].start + 1);
+        EXPECT_LE(windows[w].length(), 300);
+    }
+}
+
+TEST(WindowedScanTest, ShortSequenceIsOneWindow) {
+    std::vector<ScanWindow> windows = WindowedScanner::layout(40, 300, 50);
+    ASSERT_EQ(1u, windows.size());
+    EXPECT_EQ(40, windows[0].length());
+    EXPECT_TRUE(WindowedScanner::layout(0, 300, 50).empty());
+}
+
+TEST(WindowedScanTest, SegmentOnWindowBoundaryIsNotLost) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    const int M = 30;
+    HMMProfile profile = make_motif_profile(M, abc);
+
+    WindowedScanConfig config;
+    config.window_length = 200;
+    config.overlap_margin = 8;
+    config.num_threads = 4;
+    config.report_threshold = 30.0f;
+    WindowedScanner scanner(config);
+
+    // Plant the motif straddling the end of the first window
+    const int L = 2000;
+    std::vector<ScanWindow> windows = WindowedScanner::layout(L, config.window_length, scanner.overlap_for(M));
+    const int offset = windows[0].end - M / 2;
+    std::vector<DigitalResidue> dsq = make_planted_sequence(L, M, {offset});
+
+    AminoScoreTable table(profile);
+    std::vector<float> row_buffer;
+    float expected = msv_kernel<AminoTraits>(dsq.data(), L, table, row_buffer);
+    WindowedScanResult result = scanner.scan<AminoTraits>(dsq.data(), L, table);
+
+    EXPECT_FLOAT_EQ(expected, result.best_score);
+    EXPECT_FLOAT_EQ(2.0f * M, result.best_score);
+
+    // The clipped copy the first window sees shares the diagonal and is dropped
+    ASSERT_EQ(1u, result.hits.size());
+    EXPECT_EQ(offset, result.hits[0].start);
+    EXPECT_EQ(offset + M - 1, result.hits[0].end);
+    EXPECT_EQ(1, result.hits[0].k_start);
+    EXPECT_EQ(M, result.hits[0].k_end);
+    EXPECT_FLOAT_EQ(2.0f * M, result.hits[0].score);
+}
+
+TEST(WindowedScanTest, SeparateHitsStaySeparate) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    const int M = 20;
+    HMMProfile profile = make_motif_profile(M, abc);
+
+    WindowedScanConfig config;
+    config.window_length = 100;
+    config.overlap_margin = 4;
+    config.num_threads = 3;
+    config.report_threshold = 20.0f;
+    WindowedScanner scanner(config);
+
+    const int L = 3000;
+    std::vector<DigitalResidue> dsq = make_planted_sequence(L, M, {150, 2500});
+    AminoScoreTable table(profile);
+    WindowedScanResult result = scanner.scan<AminoTraits>(dsq.data(), L, table);
+
+    // Hits are the planted segments themselves, not the windows holding them
+    ASSERT_EQ(2u, result.hits.size());
+    EXPECT_EQ(150, result.hits[0].start);
+    EXPECT_EQ(150 + M - 1, result.hits[0].end);
+    EXPECT_EQ(2500, result.hits[1].start);
+    EXPECT_EQ(2500 + M - 1, result.hits[1].end);
+    EXPECT_LT(result.windows[0].length(), L);
+}
+
+TEST(WindowedScanTest, IntegerPolicyFindsTheSameSegments) {
+    const AminoAcidAlphabet& abc = msv_test::get_test_alphabet();
+    const int M = 15;  // 2M nats stays below int16 saturation
+    HMMProfile profile = make_motif_profile(M, abc);
+
+    WindowedScanConfig config;
+    config.window_length = 150;
+    config.overlap_margin = 4;
+    config.num_threads = 2;
+    config.report_threshold = 15.0f;
+    WindowedScanner scanner(config);
+
+    const int L = 1200;
+    std::vector<DigitalResidue> dsq = make_planted_sequence(L, M, {300, 900});
+    WindowedScanResult float_result = scanner.scan<AminoTraits>(dsq.data(), L, AminoScoreTable(profile));
+    WindowedScanResult int_result =
+        scanner.scan<AminoTraits, Int16Policy>(dsq.data(), L, AminoScoreTableT<Int16Policy>(profile));
+
+    ASSERT_EQ(2u, float_result.hits.size());
+    ASSERT_EQ(float_result.hits.size(), int_result.hits.size());
+    for (size_t h = 0; h < float_result.hits.size(); h++) {
+        EXPECT_EQ(float_result.hits[h].start, int_result.hits[h].start);
+        EXPECT_EQ(float_result.hits[h].end, int_result.hits[h].end);
+        EXPECT_NEAR(float_result.hits[h].score, int_result.hits[h].score, 0.5f);
+    }
+}